@@ -0,0 +1,49 @@
+#ifndef BENCH_BENCH_HPP
+#define BENCH_BENCH_HPP
+
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <system_error>
+
+/// Shared by the standalone benchmarks, see VERDIGRIS_BUILD_BENCHMARKS
+namespace bench
+{
+    using Clock = std::chrono::steady_clock;
+
+    // The positive integer argument at index, fallback if there aren't that
+    // many arguments, or nullopt if it isn't a positive integer
+    inline std::optional<std::size_t> parseCount(
+        std::span<char*> args, std::size_t index, std::size_t fallback)
+    {
+        if (index >= args.size())
+        {
+            return fallback;
+        }
+
+        const std::string_view arg {args[index]}; // NOLINT
+        std::size_t            count = 0;
+
+        const auto [end, error] =
+            std::from_chars(arg.data(), arg.data() + arg.size(), count);
+
+        if (error != std::errc {} || end != arg.data() + arg.size()
+            || count == 0)
+        {
+            return std::nullopt;
+        }
+
+        return count;
+    }
+
+    inline double getMillisecondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli> {Clock::now() - start}
+            .count();
+    }
+} // namespace bench
+
+#endif // BENCH_BENCH_HPP
@@ -0,0 +1,266 @@
+// Churns util::BlockAllocator, and the boost::container::flat_set free list
+// allocator that it replaced, with the same random sequence of allocations
+// and frees while they're kept about half full.
+//
+// Single blocks are compared with allocate() and free(), batches with
+// allocate(n) against n calls to the old allocate(). The old allocator had no
+// contiguous ranges, so allocateContiguous() is only timed on its own.
+//
+// verdigris_bench_block_allocator [blocks] [operations]
+
+#include "bench.hpp"
+#include <algorithm>
+#include <boost/container/flat_set.hpp>
+#include <cstddef>
+#include <expected>
+#include <fmt/core.h>
+#include <optional>
+#include <random>
+#include <span>
+#include <util/block_allocator.hpp>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using util::BlockAllocator;
+
+    // The allocator from before the hierarchical bitmap, without its moves
+    class FlatSetBlockAllocator
+    {
+    public:
+        explicit FlatSetBlockAllocator(std::size_t blocks)
+            : next_available_block {0}
+            , max_number_of_blocks {blocks}
+        {}
+
+        std::expected<std::size_t, BlockAllocator::OutOfBlocks> allocate()
+        {
+            if (this->free_block_list.empty())
+            {
+                if (this->next_available_block >= this->max_number_of_blocks)
+                {
+                    return std::unexpected(BlockAllocator::OutOfBlocks {});
+                }
+
+                return this->next_available_block++;
+            }
+
+            const std::size_t freeListBlock = *this->free_block_list.rbegin();
+
+            this->free_block_list.erase(freeListBlock);
+
+            return freeListBlock;
+        }
+
+        void free(std::size_t blockToFree)
+        {
+            if (blockToFree >= this->max_number_of_blocks)
+            {
+                throw BlockAllocator::FreeOfUntrackedValue {};
+            }
+
+            if (!this->free_block_list.insert_unique(blockToFree).second)
+            {
+                throw BlockAllocator::DoubleFree {};
+            }
+        }
+
+        // What callers had to do before allocate(n), none of these benchmarks
+        // run out of blocks so there's nothing to roll back
+        std::expected<std::vector<std::size_t>, BlockAllocator::OutOfBlocks>
+        allocate(std::size_t number)
+        {
+            std::vector<std::size_t> result {};
+            result.reserve(number);
+
+            for (std::size_t i = 0; i < number; ++i)
+            {
+                std::expected<std::size_t, BlockAllocator::OutOfBlocks>
+                    maybeBlock = this->allocate();
+
+                if (!maybeBlock.has_value())
+                {
+                    return std::unexpected(maybeBlock.error());
+                }
+
+                result.push_back(*maybeBlock);
+            }
+
+            return result;
+        }
+
+    private:
+        boost::container::flat_set<std::size_t> free_block_list;
+        std::size_t                             next_available_block;
+        std::size_t                             max_number_of_blocks;
+    };
+
+    // Nanoseconds per allocate() and free() pair, in rounds that free a
+    // quarter of the held blocks at random then allocate them all again
+    template<class Allocator>
+    double churnSingle(std::size_t blocks, std::size_t operations)
+    {
+        Allocator                allocator {blocks};
+        std::vector<std::size_t> held {};
+        std::mt19937_64          generator {7}; // NOLINT
+
+        for (std::size_t i = 0; i < blocks / 2; ++i)
+        {
+            held.push_back(allocator.allocate().value());
+        }
+
+        const bench::Clock::time_point start = bench::Clock::now();
+
+        for (std::size_t done = 0; done < operations;)
+        {
+            const std::size_t round =
+                std::min(held.size() / 4, operations - done);
+
+            // Moves a random selection of blocks to the back, then frees them
+            for (std::size_t i = 0; i < round; ++i)
+            {
+                std::uniform_int_distribution<std::size_t> getHeld {
+                    0, held.size() - 1 - i};
+
+                std::swap(held[getHeld(generator)], held[held.size() - 1 - i]);
+
+                allocator.free(held[held.size() - 1 - i]);
+            }
+
+            for (std::size_t i = 0; i < round; ++i)
+            {
+                held[held.size() - 1 - i] = allocator.allocate().value();
+            }
+
+            done += round;
+        }
+
+        return 1e6 * bench::getMillisecondsSince(start)
+             / static_cast<double>(operations);
+    }
+
+    // Nanoseconds per block, batches of up to 64 blocks are allocated until
+    // half of the blocks are in use then random batches are freed
+    template<class Allocator>
+    double churnBatches(std::size_t blocks, std::size_t operations)
+    {
+        Allocator                                  allocator {blocks};
+        std::vector<std::vector<std::size_t>>      held {};
+        std::size_t                                heldBlocks    = 0;
+        std::size_t                                churnedBlocks = 0;
+        std::mt19937_64                            generator {7}; // NOLINT
+        std::uniform_int_distribution<std::size_t> getSize {1, 64};
+
+        const bench::Clock::time_point start = bench::Clock::now();
+
+        for (std::size_t i = 0; i < operations; ++i)
+        {
+            if (heldBlocks + 64 > blocks / 2)
+            {
+                std::uniform_int_distribution<std::size_t> getHeld {
+                    0, held.size() - 1};
+
+                std::vector<std::size_t>& batch = held[getHeld(generator)];
+
+                for (std::size_t block : batch)
+                {
+                    allocator.free(block);
+                }
+
+                heldBlocks -= batch.size();
+                batch = std::move(held.back());
+                held.pop_back();
+            }
+
+            held.push_back(allocator.allocate(getSize(generator)).value());
+
+            heldBlocks += held.back().size();
+            churnedBlocks += held.back().size();
+        }
+
+        return 1e6 * bench::getMillisecondsSince(start)
+             / static_cast<double>(churnedBlocks);
+    }
+
+    // Nanoseconds per range, the same pattern as churnBatches()
+    double churnContiguous(std::size_t blocks, std::size_t operations)
+    {
+        BlockAllocator                                   allocator {blocks};
+        std::vector<std::pair<std::size_t, std::size_t>> held {};
+        std::size_t                                      heldBlocks = 0;
+        std::uniform_int_distribution<std::size_t>       getSize {1, 64};
+        std::mt19937_64 generator {7}; // NOLINT
+
+        const bench::Clock::time_point start = bench::Clock::now();
+
+        for (std::size_t i = 0; i < operations; ++i)
+        {
+            if (heldBlocks + 64 > blocks / 2)
+            {
+                std::uniform_int_distribution<std::size_t> getHeld {
+                    0, held.size() - 1};
+
+                std::pair<std::size_t, std::size_t>& range =
+                    held[getHeld(generator)];
+
+                allocator.freeContiguous(range.first, range.second);
+
+                heldBlocks -= range.second;
+                range = held.back();
+                held.pop_back();
+            }
+
+            const std::size_t size = getSize(generator);
+
+            held.emplace_back(allocator.allocateContiguous(size).value(), size);
+
+            heldBlocks += size;
+        }
+
+        return 1e6 * bench::getMillisecondsSince(start)
+             / static_cast<double>(operations);
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const std::span<char*> args {argv, static_cast<std::size_t>(argc)};
+
+    const std::optional<std::size_t> maybeBlocks =
+        bench::parseCount(args, 1, std::size_t {1} << 20);
+    const std::optional<std::size_t> maybeOperations =
+        bench::parseCount(args, 2, 200000);
+
+    // churnBatches() needs room for a batch past half full
+    if (!maybeBlocks.has_value() || !maybeOperations.has_value()
+        || *maybeBlocks < 256)
+    {
+        fmt::print(
+            stderr,
+            "usage: {} [blocks >= 256] [operations]\n",
+            args[0]); // NOLINT
+
+        return 1;
+    }
+
+    const std::size_t blocks     = *maybeBlocks;
+    const std::size_t operations = *maybeOperations;
+
+    fmt::print("{} blocks, {} operations\n", blocks, operations);
+
+    fmt::print(
+        "allocate() + free() | bitmap: {:.1f} ns | flat_set: {:.1f} ns\n",
+        churnSingle<BlockAllocator>(blocks, operations),
+        churnSingle<FlatSetBlockAllocator>(blocks, operations));
+
+    fmt::print(
+        "allocate(n) + free() | bitmap: {:.1f} ns/block | flat_set: {:.1f} "
+        "ns/block\n",
+        churnBatches<BlockAllocator>(blocks, operations),
+        churnBatches<FlatSetBlockAllocator>(blocks, operations));
+
+    fmt::print(
+        "allocateContiguous() + freeContiguous() | bitmap: {:.1f} ns/range\n",
+        churnContiguous(blocks, operations));
+}
@@ -0,0 +1,160 @@
+// Builds what each ChunkDrawMode uploads for the same chunk, a mesh from
+// SparseVoxelVolume::draw() and cube instances from drawInstances(), on a
+// dense heightmap four voxels deep and on voxels scattered at random.
+//
+// verdigris_bench_chunk_draw_mode [runs] [scattered voxels]
+
+#include "bench.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fmt/core.h>
+#include <game/world/light_volume.hpp>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <random>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+    using game::world::LightVolume;
+    using game::world::Position;
+    using game::world::SparseVoxelVolume;
+    using game::world::Voxel;
+
+    constexpr Voxel Stone {
+        .alpha_or_emissive {Voxel::OpaqueAlpha},
+        .srgb_r {128},
+        .srgb_g {128},
+        .srgb_b {128},
+        .special {0},
+        .specular {0},
+        .roughness {0},
+        .metallic {0}};
+
+    std::unique_ptr<SparseVoxelVolume> generateDense()
+    {
+        std::unique_ptr<SparseVoxelVolume> volume =
+            std::make_unique<SparseVoxelVolume>();
+
+        for (std::int32_t x = SparseVoxelVolume::VoxelMinimum;
+             x <= SparseVoxelVolume::VoxelMaximum;
+             ++x)
+        {
+            for (std::int32_t z = SparseVoxelVolume::VoxelMinimum;
+                 z <= SparseVoxelVolume::VoxelMaximum;
+                 ++z)
+            {
+                const auto height = static_cast<std::int32_t>(
+                    30.0 * std::sin(static_cast<double>(x) / 40.0)
+                    + 30.0 * std::cos(static_cast<double>(z) / 33.0));
+
+                for (std::int32_t y = height - 3; y <= height; ++y)
+                {
+                    volume->writeToLocalPosition(Position {x, y, z}, Stone);
+                }
+            }
+        }
+
+        return volume;
+    }
+
+    std::unique_ptr<SparseVoxelVolume> generateScattered(std::size_t voxels)
+    {
+        std::unique_ptr<SparseVoxelVolume> volume =
+            std::make_unique<SparseVoxelVolume>();
+
+        std::mt19937                                generator {5}; // NOLINT
+        std::uniform_int_distribution<std::int32_t> getAxis {
+            SparseVoxelVolume::VoxelMinimum, SparseVoxelVolume::VoxelMaximum};
+
+        for (std::size_t i = 0; i < voxels; ++i)
+        {
+            volume->writeToLocalPosition(
+                Position {
+                    getAxis(generator),
+                    getAxis(generator),
+                    getAxis(generator)},
+                Stone);
+        }
+
+        return volume;
+    }
+
+    void compare(
+        std::string_view         name,
+        const SparseVoxelVolume& volume,
+        std::size_t              runs)
+    {
+        const std::unique_ptr<LightVolume> light =
+            std::make_unique<LightVolume>(volume);
+
+        light->relight();
+
+        double      meshMs        = std::numeric_limits<double>::infinity();
+        double      instanceMs    = std::numeric_limits<double>::infinity();
+        std::size_t meshBytes     = 0;
+        std::size_t triangles     = 0;
+        std::size_t instanceBytes = 0;
+        std::size_t instances     = 0;
+
+        for (std::size_t i = 0; i < runs; ++i)
+        {
+            bench::Clock::time_point start = bench::Clock::now();
+
+            const auto [vertices, indices] = volume.draw(*light);
+
+            meshMs = std::min(meshMs, bench::getMillisecondsSince(start));
+            start  = bench::Clock::now();
+
+            const std::vector<gfx::recordables::VoxelRecordable::Instance>
+                cubes = volume.drawInstances(*light);
+
+            instanceMs =
+                std::min(instanceMs, bench::getMillisecondsSince(start));
+
+            meshBytes = (vertices.size() * sizeof(vertices.front()))
+                      + (indices.size() * sizeof(indices.front()));
+
+            triangles     = indices.size() / 3;
+            instanceBytes = cubes.size() * sizeof(cubes.front());
+            instances     = cubes.size();
+        }
+
+        fmt::print(
+            "{} | Meshed: {:.0f} ms, {} triangles, {:.1f} MiB | Instanced: "
+            "{:.0f} ms, {} cubes, {:.1f} MiB\n",
+            name,
+            meshMs,
+            triangles,
+            static_cast<double>(meshBytes) / (1024.0 * 1024.0),
+            instanceMs,
+            instances,
+            static_cast<double>(instanceBytes) / (1024.0 * 1024.0));
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const std::span<char*> args {argv, static_cast<std::size_t>(argc)};
+
+    const std::optional<std::size_t> maybeRuns = bench::parseCount(args, 1, 3);
+    const std::optional<std::size_t> maybeScattered =
+        bench::parseCount(args, 2, 100000);
+
+    if (!maybeRuns.has_value() || !maybeScattered.has_value())
+    {
+        fmt::print(
+            stderr, "usage: {} [runs] [scattered voxels]\n", args[0]); // NOLINT
+
+        return 1;
+    }
+
+    fmt::print("{}^3 chunk\n", SparseVoxelVolume::VoxelExtent);
+
+    compare("dense    ", *generateDense(), *maybeRuns);
+    compare("scattered", *generateScattered(*maybeScattered), *maybeRuns);
+}
@@ -0,0 +1,155 @@
+// Relights a generated chunk from scratch, then times incremental
+// LightVolume::updateVoxel() calls for random edits near its surface.
+//
+// The chunk is a heightmap one voxel thick like the ones Chunk generates,
+// with a row of emissive voxels hanging under it.
+//
+// verdigris_bench_light_volume [relights] [updates]
+
+#include "bench.hpp"
+#include <cmath>
+#include <cstdint>
+#include <fmt/core.h>
+#include <game/world/light_volume.hpp>
+#include <memory>
+#include <optional>
+#include <random>
+#include <span>
+
+namespace
+{
+    using game::world::LightVolume;
+    using game::world::Position;
+    using game::world::SparseVoxelVolume;
+    using game::world::Voxel;
+
+    std::int32_t getTerrainHeight(std::int32_t x, std::int32_t z)
+    {
+        return static_cast<std::int32_t>(
+            30.0 * std::sin(static_cast<double>(x) / 40.0)
+            + 30.0 * std::cos(static_cast<double>(z) / 33.0));
+    }
+
+    Voxel makeVoxel(std::uint8_t alphaOrEmissive)
+    {
+        return Voxel {
+            .alpha_or_emissive {alphaOrEmissive},
+            .srgb_r {128},
+            .srgb_g {128},
+            .srgb_b {128},
+            .special {0},
+            .specular {0},
+            .roughness {0},
+            .metallic {0}};
+    }
+
+    std::unique_ptr<SparseVoxelVolume> generateTerrain()
+    {
+        std::unique_ptr<SparseVoxelVolume> volume =
+            std::make_unique<SparseVoxelVolume>();
+
+        for (std::int32_t x = SparseVoxelVolume::VoxelMinimum;
+             x <= SparseVoxelVolume::VoxelMaximum;
+             ++x)
+        {
+            for (std::int32_t z = SparseVoxelVolume::VoxelMinimum;
+                 z <= SparseVoxelVolume::VoxelMaximum;
+                 ++z)
+            {
+                volume->writeToLocalPosition(
+                    Position {x, getTerrainHeight(x, z), z},
+                    makeVoxel(Voxel::OpaqueAlpha));
+            }
+        }
+
+        for (std::int32_t i = 0; i < 20; ++i)
+        {
+            volume->writeToLocalPosition(
+                Position {(i * 10) - 100, -150, 0}, makeVoxel(255));
+        }
+
+        return volume;
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const std::span<char*> args {argv, static_cast<std::size_t>(argc)};
+
+    const std::optional<std::size_t> maybeRelights =
+        bench::parseCount(args, 1, 3);
+    const std::optional<std::size_t> maybeUpdates =
+        bench::parseCount(args, 2, 1000);
+
+    if (!maybeRelights.has_value() || !maybeUpdates.has_value())
+    {
+        fmt::print(
+            stderr, "usage: {} [relights] [updates]\n", args[0]); // NOLINT
+
+        return 1;
+    }
+
+    const std::unique_ptr<SparseVoxelVolume> volume = generateTerrain();
+    const std::unique_ptr<LightVolume>       light =
+        std::make_unique<LightVolume>(*volume);
+
+    for (std::size_t i = 0; i < *maybeRelights; ++i)
+    {
+        const bench::Clock::time_point start = bench::Clock::now();
+
+        light->relight();
+
+        fmt::print(
+            "Relit a {}^3 chunk in {:.0f} ms\n",
+            SparseVoxelVolume::VoxelExtent,
+            bench::getMillisecondsSince(start));
+    }
+
+    std::mt19937                                generator {42}; // NOLINT
+    std::uniform_int_distribution<std::int32_t> getHorizontal {-30, 30};
+    std::uniform_int_distribution<std::int32_t> getHeightOffset {-8, 8};
+    std::uniform_int_distribution<std::int32_t> getKind {0, 3};
+
+    double updateMs = 0.0;
+
+    for (std::size_t i = 0; i < *maybeUpdates; ++i)
+    {
+        const std::int32_t x = getHorizontal(generator);
+        const std::int32_t z = getHorizontal(generator);
+        const Position     position {
+            x, getTerrainHeight(x, z) + getHeightOffset(generator), z};
+
+        // Digging, building, placing a light, and placing glass
+        Voxel next {};
+
+        switch (getKind(generator))
+        {
+        case 0:
+            next = makeVoxel(0);
+            break;
+        case 1:
+            next = makeVoxel(Voxel::OpaqueAlpha);
+            break;
+        case 2:
+            next = makeVoxel(255);
+            break;
+        default:
+            next = makeVoxel(60);
+            break;
+        }
+
+        const Voxel previous = volume->writeToLocalPosition(position, next);
+
+        const bench::Clock::time_point start = bench::Clock::now();
+
+        light->updateVoxel(position, previous);
+
+        updateMs += bench::getMillisecondsSince(start);
+    }
+
+    fmt::print(
+        "{} voxel updates averaged {:.1f} us, {} bricks to remesh\n",
+        *maybeUpdates,
+        1000.0 * updateMs / static_cast<double>(*maybeUpdates),
+        light->takeDirtyBricks().size());
+}
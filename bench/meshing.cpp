@@ -0,0 +1,133 @@
+// Meshes a generated chunk with SparseVoxelVolume::draw(), with and without
+// ambient occlusion, on a heightmap one voxel thick where nearly every side
+// face is exposed and on one four voxels deep where most faces are hidden.
+//
+// verdigris_bench_meshing [runs]
+
+#include "bench.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <fmt/core.h>
+#include <game/world/light_volume.hpp>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <utility>
+
+namespace
+{
+    using game::world::AmbientOcclusion;
+    using game::world::LightVolume;
+    using game::world::Position;
+    using game::world::SparseVoxelVolume;
+    using game::world::Voxel;
+
+    std::int32_t getTerrainHeight(std::int32_t x, std::int32_t z)
+    {
+        return static_cast<std::int32_t>(
+            30.0 * std::sin(static_cast<double>(x) / 40.0)
+            + 30.0 * std::cos(static_cast<double>(z) / 33.0));
+    }
+
+    std::unique_ptr<SparseVoxelVolume> generateTerrain(std::int32_t depth)
+    {
+        std::unique_ptr<SparseVoxelVolume> volume =
+            std::make_unique<SparseVoxelVolume>();
+
+        const Voxel stone {
+            .alpha_or_emissive {Voxel::OpaqueAlpha},
+            .srgb_r {128},
+            .srgb_g {128},
+            .srgb_b {128},
+            .special {0},
+            .specular {0},
+            .roughness {0},
+            .metallic {0}};
+
+        for (std::int32_t x = SparseVoxelVolume::VoxelMinimum;
+             x <= SparseVoxelVolume::VoxelMaximum;
+             ++x)
+        {
+            for (std::int32_t z = SparseVoxelVolume::VoxelMinimum;
+                 z <= SparseVoxelVolume::VoxelMaximum;
+                 ++z)
+            {
+                const std::int32_t height = getTerrainHeight(x, z);
+
+                for (std::int32_t y = height - depth + 1; y <= height; ++y)
+                {
+                    volume->writeToLocalPosition(Position {x, y, z}, stone);
+                }
+            }
+        }
+
+        return volume;
+    }
+
+    // The fastest of `runs` draw() calls in milliseconds, and the number of
+    // triangles it made
+    std::pair<double, std::size_t> timeDraw(
+        const SparseVoxelVolume& volume,
+        const LightVolume&       light,
+        AmbientOcclusion         ambientOcclusion,
+        std::size_t              runs)
+    {
+        double      fastestMs = std::numeric_limits<double>::infinity();
+        std::size_t triangles = 0;
+
+        for (std::size_t i = 0; i < runs; ++i)
+        {
+            const bench::Clock::time_point start = bench::Clock::now();
+
+            const auto [vertices, indices] =
+                volume.draw(light, ambientOcclusion);
+
+            fastestMs = std::min(fastestMs, bench::getMillisecondsSince(start));
+            triangles = indices.size() / 3;
+        }
+
+        return {fastestMs, triangles};
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const std::span<char*> args {argv, static_cast<std::size_t>(argc)};
+
+    const std::optional<std::size_t> maybeRuns = bench::parseCount(args, 1, 3);
+
+    if (!maybeRuns.has_value())
+    {
+        fmt::print(stderr, "usage: {} [runs]\n", args[0]); // NOLINT
+
+        return 1;
+    }
+
+    for (std::int32_t depth : std::array {1, 4})
+    {
+        const std::unique_ptr<SparseVoxelVolume> volume =
+            generateTerrain(depth);
+        const std::unique_ptr<LightVolume> light =
+            std::make_unique<LightVolume>(*volume);
+
+        light->relight();
+
+        const auto [occludedMs, triangles] =
+            timeDraw(*volume, *light, AmbientOcclusion::Enabled, *maybeRuns);
+        const double unoccludedMs =
+            timeDraw(*volume, *light, AmbientOcclusion::Disabled, *maybeRuns)
+                .first;
+
+        fmt::print(
+            "{}^3 chunk, terrain {} voxels deep, {} triangles | ambient "
+            "occlusion: {:.0f} ms | none: {:.0f} ms\n",
+            SparseVoxelVolume::VoxelExtent,
+            depth,
+            triangles,
+            occludedMs,
+            unoccludedMs);
+    }
+}
@@ -0,0 +1,321 @@
+// Keeps the same number of values three ways, in a util::SlotMap behind
+// SlotHandles, and behind util::UUIDs in a std::unordered_map and in the
+// boost::unordered::concurrent_flat_map that shared registries use.
+//
+// Times creating every value, looking them up in a random order and
+// iterating them. Then half of them are erased and as many are created again,
+// reusing the SlotMap's freed slots, and every original handle or UUID is
+// looked up to check that the erased ones are rejected.
+//
+// verdigris_bench_slot_map [values] [passes]
+
+#include "bench.hpp"
+#include <boost/unordered/concurrent_flat_map.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <fmt/core.h>
+#include <optional>
+#include <random>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <util/slot_map.hpp>
+#include <util/uuid.hpp>
+#include <vector>
+
+namespace
+{
+    using Value = std::uint64_t;
+
+    struct Timings
+    {
+        double create_ns;
+        double lookup_ns;
+        double iterate_ns;
+        double stale_check_ns;
+        // How many of the original keys still resolved after half were erased
+        std::size_t still_valid;
+        // The sum of every value looked up or iterated, the same for each
+        Value checksum;
+    };
+
+    double getNanosecondsPer(bench::Clock::time_point start, std::size_t n)
+    {
+        return 1e6 * bench::getMillisecondsSince(start)
+             / static_cast<double>(n);
+    }
+
+    // Indices into the created values, in a random order
+    std::vector<std::size_t> getLookupOrder(std::size_t values)
+    {
+        std::mt19937_64                            generator {3}; // NOLINT
+        std::uniform_int_distribution<std::size_t> getIndex {0, values - 1};
+        std::vector<std::size_t>                   order {};
+
+        order.reserve(values);
+
+        for (std::size_t i = 0; i < values; ++i)
+        {
+            order.push_back(getIndex(generator));
+        }
+
+        return order;
+    }
+
+    Timings timeSlotMap(std::size_t values, std::size_t passes)
+    {
+        using Handle = util::SlotMap<Value>::Handle;
+
+        Timings                  timings {};
+        util::SlotMap<Value>     map {};
+        std::vector<Handle>      handles {};
+        std::vector<std::size_t> order = getLookupOrder(values);
+        Value                    sum   = 0;
+
+        handles.reserve(values);
+
+        bench::Clock::time_point start = bench::Clock::now();
+
+        for (std::size_t i = 0; i < values; ++i)
+        {
+            handles.push_back(map.insert(i));
+        }
+
+        timings.create_ns = getNanosecondsPer(start, values);
+        start             = bench::Clock::now();
+
+        for (std::size_t p = 0; p < passes; ++p)
+        {
+            for (std::size_t i : order)
+            {
+                sum += *map.lookup(handles[i]);
+            }
+        }
+
+        timings.lookup_ns = getNanosecondsPer(start, values * passes);
+        start             = bench::Clock::now();
+
+        for (std::size_t p = 0; p < passes; ++p)
+        {
+            map.visit(
+                [&](Handle, Value value)
+                {
+                    sum += value;
+                });
+        }
+
+        timings.iterate_ns = getNanosecondsPer(start, values * passes);
+
+        for (std::size_t i = 0; i < values; i += 2)
+        {
+            std::ignore = map.erase(handles[i]);
+        }
+
+        for (std::size_t i = 0; i < values; i += 2)
+        {
+            std::ignore = map.insert(i);
+        }
+
+        start = bench::Clock::now();
+
+        for (const Handle& handle : handles)
+        {
+            timings.still_valid += map.contains(handle) ? 1 : 0;
+        }
+
+        timings.stale_check_ns = getNanosecondsPer(start, values);
+
+        timings.checksum = sum;
+
+        return timings;
+    }
+
+    Timings timeUnorderedMap(std::size_t values, std::size_t passes)
+    {
+        Timings                               timings {};
+        std::unordered_map<util::UUID, Value> map {};
+        std::vector<util::UUID>               ids {};
+        std::vector<std::size_t>              order = getLookupOrder(values);
+        Value                                 sum   = 0;
+
+        ids.reserve(values);
+
+        bench::Clock::time_point start = bench::Clock::now();
+
+        for (std::size_t i = 0; i < values; ++i)
+        {
+            map.emplace(ids.emplace_back(), i);
+        }
+
+        timings.create_ns = getNanosecondsPer(start, values);
+        start             = bench::Clock::now();
+
+        for (std::size_t p = 0; p < passes; ++p)
+        {
+            for (std::size_t i : order)
+            {
+                sum += map.find(ids[i])->second;
+            }
+        }
+
+        timings.lookup_ns = getNanosecondsPer(start, values * passes);
+        start             = bench::Clock::now();
+
+        for (std::size_t p = 0; p < passes; ++p)
+        {
+            for (const auto& [id, value] : map)
+            {
+                sum += value;
+            }
+        }
+
+        timings.iterate_ns = getNanosecondsPer(start, values * passes);
+
+        for (std::size_t i = 0; i < values; i += 2)
+        {
+            map.erase(ids[i]);
+        }
+
+        for (std::size_t i = 0; i < values; i += 2)
+        {
+            map.emplace(util::UUID {}, i);
+        }
+
+        start = bench::Clock::now();
+
+        for (const util::UUID& id : ids)
+        {
+            timings.still_valid += map.contains(id) ? 1 : 0;
+        }
+
+        timings.stale_check_ns = getNanosecondsPer(start, values);
+
+        timings.checksum = sum;
+
+        return timings;
+    }
+
+    Timings timeConcurrentFlatMap(std::size_t values, std::size_t passes)
+    {
+        Timings timings {};
+        boost::unordered::concurrent_flat_map<util::UUID, Value> map {};
+        std::vector<util::UUID>                                  ids {};
+        std::vector<std::size_t> order = getLookupOrder(values);
+        Value                    sum   = 0;
+
+        ids.reserve(values);
+
+        bench::Clock::time_point start = bench::Clock::now();
+
+        for (std::size_t i = 0; i < values; ++i)
+        {
+            map.emplace(ids.emplace_back(), i);
+        }
+
+        timings.create_ns = getNanosecondsPer(start, values);
+        start             = bench::Clock::now();
+
+        for (std::size_t p = 0; p < passes; ++p)
+        {
+            for (std::size_t i : order)
+            {
+                map.cvisit(
+                    ids[i],
+                    [&](const auto& idAndValue)
+                    {
+                        sum += idAndValue.second;
+                    });
+            }
+        }
+
+        timings.lookup_ns = getNanosecondsPer(start, values * passes);
+        start             = bench::Clock::now();
+
+        for (std::size_t p = 0; p < passes; ++p)
+        {
+            map.cvisit_all(
+                [&](const auto& idAndValue)
+                {
+                    sum += idAndValue.second;
+                });
+        }
+
+        timings.iterate_ns = getNanosecondsPer(start, values * passes);
+
+        for (std::size_t i = 0; i < values; i += 2)
+        {
+            map.erase(ids[i]);
+        }
+
+        for (std::size_t i = 0; i < values; i += 2)
+        {
+            map.emplace(util::UUID {}, i);
+        }
+
+        start = bench::Clock::now();
+
+        for (const util::UUID& id : ids)
+        {
+            timings.still_valid += map.contains(id) ? 1 : 0;
+        }
+
+        timings.stale_check_ns = getNanosecondsPer(start, values);
+
+        timings.checksum = sum;
+
+        return timings;
+    }
+
+    void printTimings(std::string_view name, const Timings& timings)
+    {
+        fmt::print(
+            "{:<28} {:>8.1f} {:>8.1f} {:>8.2f} {:>8.1f} {:>8} {:>14}\n",
+            name,
+            timings.create_ns,
+            timings.lookup_ns,
+            timings.iterate_ns,
+            timings.stale_check_ns,
+            timings.still_valid,
+            timings.checksum);
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const std::span<char*> args {argv, static_cast<std::size_t>(argc)};
+
+    const std::optional<std::size_t> maybeValues =
+        bench::parseCount(args, 1, 100000);
+    const std::optional<std::size_t> maybePasses =
+        bench::parseCount(args, 2, 10);
+
+    if (!maybeValues.has_value() || !maybePasses.has_value())
+    {
+        fmt::print(
+            stderr, "usage: {} [values] [passes]\n", args[0]); // NOLINT
+
+        return 1;
+    }
+
+    const std::size_t values = *maybeValues;
+    const std::size_t passes = *maybePasses;
+
+    fmt::print(
+        "{} values, ns per value, {} should stay valid\n"
+        "{:<28} {:>8} {:>8} {:>8} {:>8} {:>8} {:>14}\n",
+        values,
+        values / 2,
+        "",
+        "create",
+        "lookup",
+        "iterate",
+        "stale",
+        "valid",
+        "checksum");
+
+    printTimings("SlotMap + SlotHandle", timeSlotMap(values, passes));
+    printTimings("unordered_map + UUID", timeUnorderedMap(values, passes));
+    printTimings(
+        "concurrent_flat_map + UUID", timeConcurrentFlatMap(values, passes));
+}
@@ -0,0 +1,237 @@
+// Ticks the same spinning cubes two ways, as a game::entity::Archetype
+// walked in batches like SpinningCubes, and as one virtual entity per cube,
+// each ticked in its own std::async like Game::tick() used to.
+//
+// Every cube publishes to an Extrapolated<Transform>, which stands in for
+// the FlatRecordable that it would own in the game.
+//
+// verdigris_bench_spinning_cubes [cubes] [ticks]
+
+#include "bench.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fmt/core.h>
+#include <future>
+#include <game/entity/archetype.hpp>
+#include <gfx/extrapolated.hpp>
+#include <gfx/transform.hpp>
+#include <memory>
+#include <optional>
+#include <span>
+#include <system_error>
+#include <thread>
+#include <util/registrar.hpp>
+#include <vector>
+
+namespace
+{
+    using bench::Clock;
+
+    constexpr float DeltaTimeSeconds {1.0f / 60.0f};
+
+    struct Motion
+    {
+        glm::vec3 root;
+        float     time_alive;
+    };
+
+    // Stands in for the FlatRecordable that each cube owns in the game
+    using Object = std::unique_ptr<gfx::Extrapolated<gfx::Transform>>;
+
+    // The same step as SpinningCubes::tick() and Cube::tick()
+    void advance(Motion& motion, gfx::Transform& transform)
+    {
+        motion.time_alive += DeltaTimeSeconds;
+
+        transform.yawBy(1.0f * DeltaTimeSeconds);
+
+        transform.translation =
+            motion.root
+            + (glm::vec3 {0.0f, 4.5f, 0.0f} * std::sin(motion.time_alive));
+    }
+
+    class Entity
+    {
+    public:
+        Entity()          = default;
+        virtual ~Entity() = default;
+
+        Entity(const Entity&)             = delete;
+        Entity(Entity&&)                  = delete;
+        Entity& operator= (const Entity&) = delete;
+        Entity& operator= (Entity&&)      = delete;
+
+        virtual void tick(Clock::time_point) const = 0;
+    };
+
+    class Cube final : public Entity
+    {
+    public:
+        explicit Cube(glm::vec3 position)
+            : motion {Motion {.root {position}, .time_alive {0.0f}}}
+            , transform {.translation {position}}
+            , object {this->transform}
+        {}
+        ~Cube() override = default;
+
+        Cube(const Cube&)             = delete;
+        Cube(Cube&&)                  = delete;
+        Cube& operator= (const Cube&) = delete;
+        Cube& operator= (Cube&&)      = delete;
+
+        void tick(Clock::time_point tickTime) const override
+        {
+            advance(this->motion, this->transform);
+
+            this->object.publish(this->transform, tickTime);
+        }
+
+    private:
+        mutable Motion                    motion;
+        mutable gfx::Transform            transform;
+        gfx::Extrapolated<gfx::Transform> object;
+    };
+
+    glm::vec3 getSpawnPosition(std::size_t i)
+    {
+        return glm::vec3 {
+            static_cast<float>(i % 512),
+            12.5f,
+            static_cast<float>(i / 512)};
+    }
+
+    // Milliseconds per tick
+    double tickArchetype(std::size_t cubes, std::size_t ticks)
+    {
+        game::entity::Archetype<Motion, gfx::Transform, Object> archetype {};
+
+        for (std::size_t i = 0; i < cubes; ++i)
+        {
+            const gfx::Transform transform {
+                .translation {getSpawnPosition(i)}};
+
+            archetype.insert(
+                Motion {.root {transform.translation}, .time_alive {0.0f}},
+                transform,
+                std::make_unique<gfx::Extrapolated<gfx::Transform>>(
+                    transform));
+        }
+
+        const Clock::time_point start = Clock::now();
+
+        for (std::size_t tick = 0; tick < ticks; ++tick)
+        {
+            const Clock::time_point tickTime = Clock::now();
+
+            archetype.forEachBatch<Motion, gfx::Transform, Object>(
+                [tickTime](
+                    std::span<Motion>         motions,
+                    std::span<gfx::Transform> transforms,
+                    std::span<Object>         objects)
+                {
+                    for (std::size_t i = 0; i < motions.size(); ++i)
+                    {
+                        advance(motions[i], transforms[i]);
+
+                        objects[i]->publish(transforms[i], tickTime);
+                    }
+                });
+        }
+
+        return bench::getMillisecondsSince(start) / static_cast<double>(ticks);
+    }
+
+    // Milliseconds per tick, throws std::system_error when there can't be a
+    // thread per cube
+    double tickEntities(std::size_t cubes, std::size_t ticks)
+    {
+        std::vector<std::shared_ptr<const Entity>> owned {};
+        util::Registrar<std::weak_ptr<const Entity>> entities {};
+
+        owned.reserve(cubes);
+
+        for (std::size_t i = 0; i < cubes; ++i)
+        {
+            owned.push_back(std::make_shared<Cube>(getSpawnPosition(i)));
+
+            entities.insert(owned.back());
+        }
+
+        const Clock::time_point start = Clock::now();
+
+        for (std::size_t tick = 0; tick < ticks; ++tick)
+        {
+            const Clock::time_point tickTime = Clock::now();
+
+            std::vector<std::shared_ptr<const Entity>> strongEntities {};
+            std::vector<std::future<void>> strongEntityTickFutures {};
+
+            entities.flush();
+
+            strongEntities.reserve(entities.size());
+            strongEntityTickFutures.reserve(entities.size());
+
+            entities.visit(
+                [&](util::Registrar<std::weak_ptr<const Entity>>::Handle,
+                    const std::weak_ptr<const Entity>& weakEntity)
+                {
+                    if (std::shared_ptr<const Entity> obj = weakEntity.lock())
+                    {
+                        strongEntityTickFutures.push_back(std::async(
+                            std::launch::async,
+                            [entity = obj.get(), tickTime]
+                            {
+                                entity->tick(tickTime);
+                            }));
+
+                        strongEntities.push_back(std::move(obj));
+                    }
+                });
+
+            strongEntityTickFutures.clear(); // await all futures
+        }
+
+        return bench::getMillisecondsSince(start) / static_cast<double>(ticks);
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const std::span<char*> args {argv, static_cast<std::size_t>(argc)};
+
+    const std::optional<std::size_t> maybeCubes =
+        bench::parseCount(args, 1, 100000);
+    const std::optional<std::size_t> maybeTicks =
+        bench::parseCount(args, 2, 20);
+
+    if (!maybeCubes.has_value() || !maybeTicks.has_value())
+    {
+        fmt::print(
+            stderr, "usage: {} [cubes] [ticks]\n", args[0]); // NOLINT
+
+        return 1;
+    }
+
+    const std::size_t cubes = *maybeCubes;
+    const std::size_t ticks = *maybeTicks;
+
+    fmt::print(
+        "{} cubes, {} threads\n", cubes, std::thread::hardware_concurrency());
+
+    fmt::print(
+        "archetype batches:  {:.2f} ms/tick\n", tickArchetype(cubes, ticks));
+
+    try
+    {
+        fmt::print(
+            "per-entity futures: {:.2f} ms/tick\n",
+            tickEntities(cubes, ticks));
+    }
+    catch (const std::system_error& e)
+    {
+        fmt::print(
+            "per-entity futures: couldn't start a thread per cube ({})\n",
+            e.what());
+    }
+}
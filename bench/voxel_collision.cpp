@@ -0,0 +1,242 @@
+// Sweeps player sized boxes across a generated heightmap chunk with
+// sweepBoxes(), and with a naive baseline that moves each box a quarter of a
+// voxel at a time and tests every voxel it overlaps.
+//
+// verdigris_bench_voxel_collision [boxes]
+
+#include "bench.hpp"
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <fmt/core.h>
+#include <game/world/voxel_collision.hpp>
+#include <memory>
+#include <optional>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace
+{
+    using game::world::Aabb;
+    using game::world::Position;
+    using game::world::SparseVoxelVolume;
+    using game::world::Sweep;
+    using game::world::SweepResult;
+
+    std::int32_t getTerrainHeight(std::int32_t x, std::int32_t z)
+    {
+        return static_cast<std::int32_t>(
+            30.0 * std::sin(static_cast<double>(x) / 40.0)
+            + 30.0 * std::cos(static_cast<double>(z) / 33.0));
+    }
+
+    // Solid from the bottom of the volume up to the terrain height
+    std::unique_ptr<SparseVoxelVolume> generateTerrain()
+    {
+        std::unique_ptr<SparseVoxelVolume> volume =
+            std::make_unique<SparseVoxelVolume>();
+
+        const game::world::Voxel stone {
+            .alpha_or_emissive {game::world::Voxel::OpaqueAlpha},
+            .srgb_r {128},
+            .srgb_g {128},
+            .srgb_b {128},
+            .special {0},
+            .specular {0},
+            .roughness {0},
+            .metallic {0}};
+
+        for (std::int32_t x = SparseVoxelVolume::VoxelMinimum;
+             x <= SparseVoxelVolume::VoxelMaximum;
+             ++x)
+        {
+            for (std::int32_t z = SparseVoxelVolume::VoxelMinimum;
+                 z <= SparseVoxelVolume::VoxelMaximum;
+                 ++z)
+            {
+                for (std::int32_t y = SparseVoxelVolume::VoxelMinimum;
+                     y <= getTerrainHeight(x, z);
+                     ++y)
+                {
+                    volume->writeToLocalPosition(Position {x, y, z}, stone);
+                }
+            }
+        }
+
+        return volume;
+    }
+
+    bool isVoxelInBox(const SparseVoxelVolume& volume, const Aabb& box)
+    {
+        // Voxels fill [p - 0.5, p + 0.5], so these are the voxels the box
+        // overlaps rather than just touches
+        auto getFirst = [](float minimum)
+        {
+            return static_cast<std::int32_t>(std::floor(minimum - 0.5f)) + 1;
+        };
+        auto getLast = [](float maximum)
+        {
+            return static_cast<std::int32_t>(std::ceil(maximum + 0.5f)) - 1;
+        };
+
+        for (std::int32_t x = getFirst(box.minimum.x);
+             x <= getLast(box.maximum.x);
+             ++x)
+        {
+            for (std::int32_t y = getFirst(box.minimum.y);
+                 y <= getLast(box.maximum.y);
+                 ++y)
+            {
+                for (std::int32_t z = getFirst(box.minimum.z);
+                     z <= getLast(box.maximum.z);
+                     ++z)
+                {
+                    const bool isInside =
+                        std::min({x, y, z}) >= SparseVoxelVolume::VoxelMinimum
+                        && std::max({x, y, z})
+                               <= SparseVoxelVolume::VoxelMaximum;
+
+                    if (isInside
+                        && volume.readFromLocalPosition(Position {x, y, z})
+                               .shouldDraw())
+                    {
+                        return true;
+                    }
+                }
+            }
+        }
+
+        return false;
+    }
+
+    // What per voxel collision would do without sweeping, y then x then z
+    // like sweepBox(), a quarter of a voxel at a time
+    void sweepBoxesNaively(
+        const SparseVoxelVolume& volume,
+        std::span<const Sweep>   sweeps,
+        std::span<SweepResult>   results)
+    {
+        constexpr float MaxStep {0.25f};
+
+        for (std::size_t i = 0; i < sweeps.size(); ++i)
+        {
+            Aabb        box = sweeps[i].box;
+            SweepResult result {
+                .displacement {0.0f, 0.0f, 0.0f},
+                .collided {false, false, false}};
+
+            for (glm::length_t axis : std::array<glm::length_t, 3> {1, 0, 2})
+            {
+                const float       distance = sweeps[i].displacement[axis];
+                const std::size_t steps    = static_cast<std::size_t>(
+                    std::ceil(std::abs(distance) / MaxStep));
+
+                for (std::size_t s = 0; s < steps; ++s)
+                {
+                    Aabb next = box;
+                    next.minimum[axis] += distance / static_cast<float>(steps);
+                    next.maximum[axis] += distance / static_cast<float>(steps);
+
+                    if (isVoxelInBox(volume, next))
+                    {
+                        result.collided[axis] = true;
+
+                        break;
+                    }
+
+                    result.displacement[axis] += next.minimum[axis]
+                                               - box.minimum[axis];
+                    box = next;
+                }
+            }
+
+            results[i] = result;
+        }
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const std::span<char*> args {argv, static_cast<std::size_t>(argc)};
+
+    const std::optional<std::size_t> maybeBoxes =
+        bench::parseCount(args, 1, 100000);
+
+    if (!maybeBoxes.has_value())
+    {
+        fmt::print(stderr, "usage: {} [boxes]\n", args[0]); // NOLINT
+
+        return 1;
+    }
+
+    const std::size_t boxes = *maybeBoxes;
+
+    bench::Clock::time_point start = bench::Clock::now();
+
+    const std::unique_ptr<SparseVoxelVolume> volume = generateTerrain();
+
+    fmt::print(
+        "Generated a {}^3 chunk in {:.0f} ms\n",
+        SparseVoxelVolume::VoxelExtent,
+        bench::getMillisecondsSince(start));
+
+    const std::array volumes {game::world::PositionedVolume {
+        .volume {volume.get()}, .position {0.0f, 0.0f, 0.0f}}};
+
+    std::mt19937                          generator {1}; // NOLINT
+    std::uniform_real_distribution<float> getHorizontal {
+        static_cast<float>(SparseVoxelVolume::VoxelMinimum) + 8.0f,
+        static_cast<float>(SparseVoxelVolume::VoxelMaximum) - 8.0f};
+
+    for (float magnitude : {0.5f, 5.0f})
+    {
+        std::uniform_real_distribution<float> getDisplacement {
+            -magnitude, magnitude};
+
+        std::vector<Sweep> sweeps {};
+        sweeps.reserve(boxes);
+
+        // Standing on the surface and moving down into it, so that most of
+        // them land and slide
+        for (std::size_t i = 0; i < boxes; ++i)
+        {
+            const float x = getHorizontal(generator);
+            const float z = getHorizontal(generator);
+            const float y = static_cast<float>(getTerrainHeight(
+                                static_cast<std::int32_t>(x),
+                                static_cast<std::int32_t>(z)))
+                          + 1.5f;
+
+            sweeps.push_back(Sweep {
+                .box {
+                    .minimum {x, y, z},
+                    .maximum {x + 0.6f, y + 1.8f, z + 0.6f}},
+                .displacement {
+                    getDisplacement(generator),
+                    getDisplacement(generator) - magnitude,
+                    getDisplacement(generator)}});
+        }
+
+        std::vector<SweepResult> results(boxes);
+
+        start = bench::Clock::now();
+
+        game::world::sweepBoxes(volumes, sweeps, results);
+
+        const double sweptMs = bench::getMillisecondsSince(start);
+
+        start = bench::Clock::now();
+
+        sweepBoxesNaively(*volume, sweeps, results);
+
+        const double naiveMs = bench::getMillisecondsSince(start);
+
+        fmt::print(
+            "~{} voxel moves | sweepBoxes: {:.0f} boxes/ms | naive quarter "
+            "voxel steps: {:.0f} boxes/ms\n",
+            magnitude,
+            static_cast<double>(boxes) / sweptMs,
+            static_cast<double>(boxes) / naiveMs);
+    }
+}
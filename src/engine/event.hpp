@@ -6,14 +6,17 @@
 #include <functional>
 #include <future>
 #include <memory>
+#include <unordered_map>
 #include <util/log.hpp>
 #include <util/registrar.hpp>
 #include <util/uuid.hpp>
+#include <utility>
+#include <vector>
 
 namespace engine
 {
     template<class... Ts>
-        requires (std::is_copy_constructible_v<Ts...> || sizeof...(Ts) == 0)
+        requires (std::is_copy_constructible_v<Ts> && ...)
     class Event
     {
     public:
@@ -33,8 +36,8 @@ namespace engine
 
                 while (this->subscriber_queue.try_dequeue(maybeFunction))
                 {
-                    this->registered_callbacks.insert(std::pair {
-                        util::UUID {}, std::forward<Ts...>(maybeFunction)});
+                    this->registered_callbacks.insert(
+                        std::pair {util::UUID {}, std::move(maybeFunction)});
 
                     maybeFunction = {};
                 }
@@ -60,6 +63,8 @@ namespace engine
                             case EventProcessResult::InvalidObject:
                                 return std::unexpected(lambdaUUID);
                             }
+
+                            std::unreachable();
                         }));
                 }
 
@@ -97,8 +102,7 @@ namespace engine
                     }
                 }};
 
-            if (!this->subscriber_queue.try_enqueue(
-                    std::forward<Ts...>(eventCallback)))
+            if (!this->subscriber_queue.try_enqueue(std::move(eventCallback)))
             {
                 throw std::bad_alloc {};
             }
@@ -0,0 +1,100 @@
+#include "fixed_timestep.hpp"
+#include <thread>
+#include <util/log.hpp>
+
+namespace engine
+{
+    FixedTimestep::FixedTimestep(
+        std::uint32_t ticksPerSecond, std::uint32_t maxCatchUpTicks)
+        : step {std::chrono::duration_cast<Clock::duration>(
+              std::chrono::duration<double> {1.0 / ticksPerSecond})}
+        , max_catch_up_ticks {maxCatchUpTicks}
+        , ticks {0}
+        , overruns {0}
+        , dropped_steps {0}
+        , longest_tick {0}
+    {
+        util::assertFatal(ticksPerSecond > 0, "Tick rate must not be 0");
+        util::assertFatal(
+            maxCatchUpTicks > 0, "Must be able to run at least one tick");
+    }
+
+    FixedTimestep::Clock::duration FixedTimestep::getStep() const
+    {
+        return this->step;
+    }
+
+    FixedTimestep::Statistics FixedTimestep::getStatistics() const
+    {
+        return Statistics {
+            .ticks {this->ticks.load(std::memory_order_relaxed)},
+            .overruns {this->overruns.load(std::memory_order_relaxed)},
+            .dropped_steps {
+                this->dropped_steps.load(std::memory_order_relaxed)},
+            .longest_tick {Clock::duration {
+                this->longest_tick.load(std::memory_order_relaxed)}}};
+    }
+
+    void FixedTimestep::run(
+        const std::function<bool()>&                  shouldContinue,
+        const std::function<void(Clock::time_point)>& tick)
+    {
+        Clock::time_point previous = Clock::now();
+        // The first tick runs straight away
+        Clock::duration   accumulator = this->step;
+
+        while (shouldContinue())
+        {
+            const Clock::time_point now = Clock::now();
+            accumulator += now - previous;
+            previous = now;
+
+            for (std::uint32_t caughtUp = 0;
+                 accumulator >= this->step
+                 && caughtUp < this->max_catch_up_ticks && shouldContinue();
+                 ++caughtUp)
+            {
+                const Clock::time_point tickStart = Clock::now();
+
+                // Everything before this has been ticked already
+                tick(previous - accumulator);
+
+                this->recordTick(Clock::now() - tickStart);
+
+                accumulator -= this->step;
+            }
+
+            if (accumulator >= this->step)
+            {
+                this->dropped_steps.fetch_add(
+                    static_cast<std::uint64_t>(accumulator / this->step),
+                    std::memory_order_relaxed);
+
+                accumulator %= this->step;
+            }
+
+            // Everything up to previous is in the accumulator, the ticks
+            // just run are made up for by sleeping less
+            std::this_thread::sleep_until(
+                previous + (this->step - accumulator));
+        }
+    }
+
+    void FixedTimestep::recordTick(Clock::duration duration)
+    {
+        this->ticks.fetch_add(1, std::memory_order_relaxed);
+
+        if (duration > this->step)
+        {
+            this->overruns.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Only ever written from run()'s thread
+        if (duration.count()
+            > this->longest_tick.load(std::memory_order_relaxed))
+        {
+            this->longest_tick.store(
+                duration.count(), std::memory_order_relaxed);
+        }
+    }
+} // namespace engine
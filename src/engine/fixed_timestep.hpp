@@ -0,0 +1,70 @@
+#ifndef SRC_ENGINE_FIXED_TIMESTEP_HPP
+#define SRC_ENGINE_FIXED_TIMESTEP_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+namespace engine
+{
+    /// Drives a tick at a fixed rate. Time that passes is put into an
+    /// accumulator and a tick is run for every whole step in it, so that a
+    /// slow tick is caught up on by the ticks after it. At most
+    /// max_catch_up_ticks are run back to back, anything past that is
+    /// dropped rather than spiralling further behind. The thread sleeps
+    /// until the next step is due.
+    class FixedTimestep
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        // Every counter is since construction
+        struct Statistics
+        {
+            std::uint64_t   ticks;
+            // Ticks that took longer than a step
+            std::uint64_t   overruns;
+            // Steps that were never ticked, because catching up on them
+            // would have taken more than max_catch_up_ticks
+            std::uint64_t   dropped_steps;
+            Clock::duration longest_tick;
+        };
+
+    public:
+
+        FixedTimestep(
+            std::uint32_t ticksPerSecond, std::uint32_t maxCatchUpTicks);
+        ~FixedTimestep() = default;
+
+        FixedTimestep(const FixedTimestep&)             = delete;
+        FixedTimestep(FixedTimestep&&)                  = delete;
+        FixedTimestep& operator= (const FixedTimestep&) = delete;
+        FixedTimestep& operator= (FixedTimestep&&)      = delete;
+
+        [[nodiscard]] Clock::duration getStep() const;
+        // May be called from any thread
+        [[nodiscard]] Statistics      getStatistics() const;
+
+        // Runs tick once per step until shouldContinue returns false, must
+        // not be called concurrently with itself. tick is given the time its
+        // step was due to start, which is a whole number of steps after the
+        // previous tick's even when ticks are caught up on back to back
+        void run(
+            const std::function<bool()>&                  shouldContinue,
+            const std::function<void(Clock::time_point)>& tick);
+
+    private:
+        void recordTick(Clock::duration);
+
+        Clock::duration step;
+        std::uint32_t   max_catch_up_ticks;
+
+        std::atomic<std::uint64_t> ticks;
+        std::atomic<std::uint64_t> overruns;
+        std::atomic<std::uint64_t> dropped_steps;
+        std::atomic<Clock::rep>    longest_tick;
+    };
+} // namespace engine
+
+#endif // SRC_ENGINE_FIXED_TIMESTEP_HPP
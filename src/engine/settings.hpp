@@ -1,6 +1,8 @@
 #ifndef SRC_ENGINE_SETTINGS_HPP
 #define SRC_ENGINE_SETTINGS_HPP
 
+#include <atomic>
+#include <cstdint>
 #include <util/log.hpp>
 
 namespace engine
@@ -9,8 +11,14 @@ namespace engine
     {
         EnableGFXValidation,
         EnableAppValidation,
+        // Game ticks per second, std::uint32_t
+        TickRateHz,
+        // Draw chunks as a cube instance per voxel rather than as meshes, bool
+        InstancedChunks,
     };
 
+    inline constexpr std::uint32_t DefaultTickRateHz {60};
+
     class SettingsManager;
 
     const SettingsManager& getSettings();
@@ -40,6 +48,14 @@ namespace engine
                 return this->enable_app_validation.load(
                     std::memory_order_relaxed);
             }
+            else if constexpr (Setting == Setting::TickRateHz)
+            {
+                return this->tick_rate_hz.load(std::memory_order_relaxed);
+            }
+            else if constexpr (Setting == Setting::InstancedChunks)
+            {
+                return this->instanced_chunks.load(std::memory_order_relaxed);
+            }
             else
             {
                 static_assert(false, "Setting not configured");
@@ -73,6 +89,32 @@ namespace engine
 
                 std::atomic_thread_fence(std::memory_order_seq_cst);
                 return;
+
+            case Setting::TickRateHz:
+                util::assertFatal(
+                    !tick_rate_set, "tick rate set multiple times");
+                this->tick_rate_set = true;
+
+                this->tick_rate_hz.store(
+                    static_cast<std::uint32_t>(
+                        std::forward<decltype(newValue)>(newValue)),
+                    std::memory_order_seq_cst);
+
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                return;
+
+            case Setting::InstancedChunks:
+                util::assertFatal(
+                    !instanced_chunks_set,
+                    "instanced chunks set multiple times");
+                this->instanced_chunks_set = true;
+
+                this->instanced_chunks.store(
+                    std::forward<decltype(newValue)>(newValue),
+                    std::memory_order_seq_cst);
+
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                return;
                 // default:
                 //     util::panic(
                 //         "Tried to set invalid setting {} | {}",
@@ -84,6 +126,8 @@ namespace engine
     private:
         mutable std::atomic<bool> gfx_validation_set {false};
         mutable std::atomic<bool> app_validation_set {false};
+        mutable std::atomic<bool> tick_rate_set {false};
+        mutable std::atomic<bool> instanced_chunks_set {false};
 
 #ifdef __cpp_lib_hardware_interference_size
         static constexpr std::size_t Alignment =
@@ -95,6 +139,8 @@ namespace engine
 
         alignas(Alignment) mutable std::atomic<bool> enable_gfx_validation;
         alignas(Alignment) mutable std::atomic<bool> enable_app_validation;
+        alignas(Alignment) mutable std::atomic<std::uint32_t> tick_rate_hz;
+        alignas(Alignment) mutable std::atomic<bool> instanced_chunks;
     };
 
 } // namespace engine
@@ -0,0 +1,227 @@
+#ifndef SRC_GAME_ENTITY_ARCHETYPE_HPP
+#define SRC_GAME_ENTITY_ARCHETYPE_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <span>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <util/slot_map.hpp>
+#include <vector>
+
+namespace game::entity
+{
+    /// Entities that all have the same components, stored as one column per
+    /// component rather than as one object per entity. Row i of every column
+    /// is the same entity, so a system walks plain arrays and can hand out
+    /// contiguous batches of rows to worker threads.
+    ///
+    /// Entities are referred to by generational handles, as in a
+    /// util::SlotMap. Erasing one moves the last row into its place, so rows
+    /// are not stable.
+    ///
+    /// Not thread safe, other than the batches of forEachBatch().
+    template<class... Components>
+    class Archetype
+    {
+        static_assert(sizeof...(Components) > 0);
+        static_assert(
+            ((std::is_same_v<Components, std::remove_cvref_t<Components>>)
+             && ...),
+            "Components must be plain value types");
+
+    public:
+        using Id = util::SlotHandle<Archetype>;
+
+        // Batches smaller than this aren't worth a thread
+        static constexpr std::size_t MinRowsPerBatch {4096};
+
+    public:
+
+        Archetype()  = default;
+        ~Archetype() = default;
+
+        Archetype(const Archetype&)             = delete;
+        Archetype(Archetype&&)                  = default;
+        Archetype& operator= (const Archetype&) = delete;
+        Archetype& operator= (Archetype&&)      = default;
+
+        Id insert(Components... components)
+        {
+            std::uint32_t slotIndex = this->free_head;
+
+            if (slotIndex == NullIndex)
+            {
+                slotIndex = static_cast<std::uint32_t>(this->slots.size());
+
+                this->slots.push_back(
+                    Slot {.generation {0}, .row_or_next_free {NullIndex}});
+            }
+
+            Slot& slot = this->slots[slotIndex];
+
+            this->free_head = slot.row_or_next_free;
+
+            // Occupied slots always have an odd generation, so a generation
+            // of 0 is never valid
+            slot.generation += 1;
+            slot.row_or_next_free =
+                static_cast<std::uint32_t>(this->row_to_slot.size());
+
+            (this->getColumnVector<Components>().push_back(
+                 std::move(components)),
+             ...);
+            this->row_to_slot.push_back(slotIndex);
+
+            return Id {.index {slotIndex}, .generation {slot.generation}};
+        }
+
+        // Returns false if the id was stale
+        bool erase(Id id)
+        {
+            if (!this->contains(id))
+            {
+                return false;
+            }
+
+            Slot&             slot = this->slots[id.index];
+            const std::size_t row  = slot.row_or_next_free;
+            const std::size_t last = this->row_to_slot.size() - 1;
+
+            // keep the columns dense by moving the last row into the hole
+            if (row != last)
+            {
+                ((this->getColumnVector<Components>()[row] = std::move(
+                      this->getColumnVector<Components>()[last])),
+                 ...);
+                this->row_to_slot[row] = this->row_to_slot[last];
+
+                this->slots[this->row_to_slot[row]].row_or_next_free =
+                    static_cast<std::uint32_t>(row);
+            }
+
+            (this->getColumnVector<Components>().pop_back(), ...);
+            this->row_to_slot.pop_back();
+
+            slot.generation += 1;
+            slot.row_or_next_free = this->free_head;
+            this->free_head       = id.index;
+
+            return true;
+        }
+
+        [[nodiscard]] bool contains(Id id) const
+        {
+            return id.index < this->slots.size()
+                && this->slots[id.index].generation == id.generation
+                && (id.generation & 1) == 1;
+        }
+
+        // Returns nullptr for stale or null ids
+        template<class C>
+        [[nodiscard]] C* lookup(Id id)
+        {
+            if (!this->contains(id))
+            {
+                return nullptr;
+            }
+
+            return &this->getColumnVector<C>()
+                        [this->slots[id.index].row_or_next_free];
+        }
+
+        template<class C>
+        [[nodiscard]] std::span<C> getColumn()
+        {
+            return this->getColumnVector<C>();
+        }
+
+        template<class C>
+        [[nodiscard]] std::span<const C> getColumn() const
+        {
+            return std::get<std::vector<C>>(this->columns);
+        }
+
+        [[nodiscard]] std::size_t size() const
+        {
+            return this->row_to_slot.size();
+        }
+
+        // Calls func(std::span<Cs>...) with the same rows of each column,
+        // every row is in exactly one call. Calls run concurrently on
+        // worker threads when there are enough rows, so func must only
+        // touch the rows that it's given
+        template<class... Cs, class F>
+            requires std::invocable<F&, std::span<Cs>...>
+        void forEachBatch(F func)
+        {
+            const std::size_t rows = this->size();
+
+            const std::size_t workers = std::max<std::size_t>(
+                std::thread::hardware_concurrency(), 1);
+            const std::size_t rowsPerBatch =
+                std::max(MinRowsPerBatch, (rows + workers - 1) / workers);
+
+            if (rows <= rowsPerBatch)
+            {
+                if (rows != 0)
+                {
+                    func(this->getColumn<Cs>()...);
+                }
+
+                return;
+            }
+
+            std::vector<std::future<void>> futures {};
+            futures.reserve((rows + rowsPerBatch - 1) / rowsPerBatch);
+
+            for (std::size_t start = 0; start < rows; start += rowsPerBatch)
+            {
+                const std::size_t count = std::min(rowsPerBatch, rows - start);
+
+                futures.push_back(std::async(
+                    std::launch::async,
+                    [&func, batch = std::tuple {this->getColumn<Cs>().subspan(
+                                start, count)...}]
+                    {
+                        std::apply(func, batch);
+                    }));
+            }
+
+            for (std::future<void>& f : futures)
+            {
+                f.get();
+            }
+        }
+
+    private:
+        static constexpr std::uint32_t NullIndex =
+            std::numeric_limits<std::uint32_t>::max();
+
+        struct Slot
+        {
+            // odd when occupied
+            std::uint32_t generation;
+            // the row when occupied, otherwise the next slot in the free
+            // list
+            std::uint32_t row_or_next_free;
+        };
+
+        template<class C>
+        std::vector<C>& getColumnVector()
+        {
+            return std::get<std::vector<C>>(this->columns);
+        }
+
+        std::tuple<std::vector<Components>...> columns;
+        std::vector<std::uint32_t>             row_to_slot;
+        std::vector<Slot>                      slots;
+        std::uint32_t                          free_head = NullIndex;
+    };
+} // namespace game::entity
+
+#endif // SRC_GAME_ENTITY_ARCHETYPE_HPP
@@ -57,6 +57,19 @@ namespace
 
 namespace game::entity
 {
+    std::shared_ptr<gfx::recordables::FlatRecordable>
+    createCubeRecordable(
+        const gfx::Renderer& renderer, gfx::Transform transform)
+    {
+        return gfx::recordables::FlatRecordable::create(
+            renderer,
+            std::vector<gfx::recordables::FlatRecordable::Vertex> {
+                Vertices.begin(), Vertices.end()},
+            std::vector<gfx::recordables::FlatRecordable::Index> {
+                Indices.begin(), Indices.end()},
+            transform,
+            "Cube");
+    }
 
     std::shared_ptr<Cube> Cube::create(const Game& game_, glm::vec3 position)
     {
@@ -69,37 +82,33 @@ namespace game::entity
 
     Cube::Cube(const Game& game_, glm::vec3 position)
         : Entity {game_}
-        , object {gfx::recordables::FlatRecordable::create(
-              this->getRenderer(),
-              std::vector<gfx::recordables::FlatRecordable::Vertex> {
-                  Vertices.begin(), Vertices.end()},
-              std::vector<gfx::recordables::FlatRecordable::Index> {
-                  Indices.begin(), Indices.end()},
-              gfx::Transform {.translation {position}},
-              "Cube")}
+        , object {createCubeRecordable(
+              this->getRenderer(), gfx::Transform {.translation {position}})}
         , root {position}
         , time_alive {0.0f}
-    {
-        this->object->transform.lock(
-            [&](gfx::Transform& t)
-            {
-                t.translation = this->root;
-            });
-    }
+        , transform {.translation {position}}
+    {}
 
     void Cube::tick() const
     {
-        this->object->transform.lock(
-            [this](gfx::Transform& t)
-            {
-                this->time_alive += this->game.getTickDeltaTimeSeconds();
+        this->time_alive += this->game.getTickDeltaTimeSeconds();
+
+        this->transform.yawBy(1.0f * this->game.getTickDeltaTimeSeconds());
 
-                t.yawBy(1.0f * this->game.getTickDeltaTimeSeconds());
+        this->transform.translation =
+            this->root
+            + (glm::vec3 {0.0f, 4.5f, 0.0f} * std::sin(this->time_alive));
+
+        this->object->transform.publish(
+            this->transform, this->game.getTickTime());
+    }
+
+    void Cube::onRebase(world::Rebase rebase)
+    {
+        this->root -= rebase.getShift();
+        this->transform.translation -= rebase.getShift();
 
-                t.translation = this->root
-                              + (glm::vec3 {0.0f, 4.5f, 0.0f}
-                                 * std::sin(this->time_alive));
-            });
+        this->object->transform.reset(this->transform);
     }
 
 } // namespace game::entity
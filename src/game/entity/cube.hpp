@@ -12,6 +12,10 @@ namespace gfx
 
 namespace game::entity
 {
+    // The colored cube mesh shared by Cube and SpinningCubes
+    std::shared_ptr<gfx::recordables::FlatRecordable>
+    createCubeRecordable(const gfx::Renderer&, gfx::Transform);
+
     class Cube final : public Entity
     {
     public:
@@ -21,11 +25,15 @@ namespace game::entity
 
         void tick() const override;
 
+    protected:
+        void onRebase(world::Rebase) override;
+
     private:
         std::shared_ptr<gfx::recordables::FlatRecordable> object;
 
-        glm::vec3     root;
-        mutable float time_alive;
+        glm::vec3              root;
+        mutable float          time_alive;
+        mutable gfx::Transform transform;
 
         Cube(const Game&, glm::vec3 position);
     };
@@ -1,5 +1,6 @@
 #include "disk_entity.hpp"
 #include "game/entity/disk_entity.hpp"
+#include "game/game.hpp"
 #include "util/log.hpp"
 #include <gfx/recordables/flat_recordable.hpp>
 #include <gfx/renderer.hpp>
@@ -29,6 +30,7 @@ namespace game::entity
     DiskEntity::DiskEntity(const Game& game_, const char* filepath)
         : Entity {game_}
         , object {nullptr}
+        , transform {}
     {
         tinyobj::attrib_t                attribute {};
         std::vector<tinyobj::shape_t>    shapes;
@@ -116,11 +118,18 @@ namespace game::entity
             this->getRenderer(),
             vertices,
             indices,
-            {},
+            this->transform,
             std::format("Disk Entity {}", filepath));
     }
 
     DiskEntity::~DiskEntity() {} // NOLINT pre declarations
 
     void DiskEntity::tick() const {}
+
+    void DiskEntity::onRebase(world::Rebase rebase)
+    {
+        this->transform.translation -= rebase.getShift();
+
+        this->object->transform.reset(this->transform);
+    }
 } // namespace game::entity
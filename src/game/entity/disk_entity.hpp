@@ -2,6 +2,7 @@
 #define SRC_GAME_ENTITY_DISK_ENTITY_HPP
 
 #include "entity.hpp"
+#include <gfx/transform.hpp>
 #include <memory>
 
 namespace gfx
@@ -27,8 +28,12 @@ namespace game::entity
 
         void tick() const override;
 
+    protected:
+        void onRebase(world::Rebase) override;
+
     private:
         std::shared_ptr<gfx::recordables::FlatRecordable> object;
+        gfx::Transform                                    transform;
 
         DiskEntity(const Game&, const char* filepath);
     }; // class DiskEntity
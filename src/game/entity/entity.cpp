@@ -5,22 +5,14 @@
 
 game::entity::Entity::Entity(const Game& game_)
     : game {game_}
-    , uuid {}
 {}
 
-game::entity::Entity::~Entity()
-{
-    this->game.removeEntity(this->uuid);
-}
+// The Game drops expired entities from its Registrar as it ticks
+game::entity::Entity::~Entity() = default;
 
 game::entity::Entity::operator std::string () const
 {
-    return fmt::format("Entity {}", static_cast<std::string>(this->uuid));
-}
-
-util::UUID game::entity::Entity::getUUID() const
-{
-    return this->uuid;
+    return fmt::format("Entity {}", static_cast<const void*>(this));
 }
 
 const gfx::Renderer& game::entity::Entity::getRenderer() const
@@ -31,4 +23,9 @@ const gfx::Renderer& game::entity::Entity::getRenderer() const
 void game::entity::Entity::registerSelf()
 {
     this->game.registerEntity(this->shared_from_this());
+
+    this->game.getRebaseEvent().subscribe(
+        this->weak_from_this(), &Entity::onRebase);
 }
+
+void game::entity::Entity::onRebase(world::Rebase) {} // NOLINT
@@ -2,11 +2,15 @@
 #define SRC_GAME_ENTITY_HPP
 
 #include <gfx/renderer.hpp>
-#include <util/uuid.hpp>
 
 namespace game
 {
     class Game;
+
+    namespace world
+    {
+        struct Rebase;
+    } // namespace world
 }
 
 namespace game::entity
@@ -29,14 +33,16 @@ namespace game::entity
         virtual void     tick() const = 0;
         virtual explicit operator std::string () const;
 
-        util::UUID getUUID() const;
-
     protected:
         const gfx::Renderer& getRenderer() const;
         void                 registerSelf();
 
-        const Game&      game;
-        const util::UUID uuid;
+        // Called between ticks when the world's origin moves, any positions
+        // held relative to it must be shifted. Not called concurrently with
+        // tick()
+        virtual void onRebase(world::Rebase);
+
+        const Game& game;
 
         explicit Entity(const Game&);
     };
@@ -0,0 +1,94 @@
+#include "spinning_cubes.hpp"
+#include "cube.hpp"
+#include <cmath>
+#include <game/world/world.hpp>
+
+namespace game::entity
+{
+    SpinningCubes::SpinningCubes(const gfx::Renderer& renderer_)
+        : renderer {renderer_}
+        , cubes {}
+    {}
+
+    SpinningCubes::Id SpinningCubes::spawn(glm::vec3 position)
+    {
+        const gfx::Transform transform {.translation {position}};
+
+        return this->cubes.insert(
+            Motion {.root {position}, .time_alive {0.0f}},
+            transform,
+            createCubeRecordable(this->renderer, transform));
+    }
+
+    bool SpinningCubes::despawn(Id id)
+    {
+        return this->cubes.erase(id);
+    }
+
+    void SpinningCubes::tick(
+        float deltaTimeSeconds, std::chrono::steady_clock::time_point tickTime)
+    {
+        this->cubes.forEachBatch<
+            Motion,
+            gfx::Transform,
+            std::shared_ptr<gfx::recordables::FlatRecordable>>(
+            [deltaTimeSeconds, tickTime](
+                std::span<Motion>         motions,
+                std::span<gfx::Transform> transforms,
+                std::span<std::shared_ptr<gfx::recordables::FlatRecordable>>
+                    objects)
+            {
+                for (std::size_t i = 0; i < motions.size(); ++i)
+                {
+                    Motion&         motion    = motions[i];
+                    gfx::Transform& transform = transforms[i];
+
+                    motion.time_alive += deltaTimeSeconds;
+
+                    transform.yawBy(1.0f * deltaTimeSeconds);
+
+                    transform.translation =
+                        motion.root
+                        + (glm::vec3 {0.0f, 4.5f, 0.0f}
+                           * std::sin(motion.time_alive));
+
+                    if (objects[i] != nullptr)
+                    {
+                        objects[i]->transform.publish(transform, tickTime);
+                    }
+                }
+            });
+    }
+
+    void SpinningCubes::onRebase(world::Rebase rebase)
+    {
+        const glm::vec3 shift = rebase.getShift();
+
+        this->cubes.forEachBatch<
+            Motion,
+            gfx::Transform,
+            std::shared_ptr<gfx::recordables::FlatRecordable>>(
+            [shift](
+                std::span<Motion>         motions,
+                std::span<gfx::Transform> transforms,
+                std::span<std::shared_ptr<gfx::recordables::FlatRecordable>>
+                    objects)
+            {
+                for (std::size_t i = 0; i < motions.size(); ++i)
+                {
+                    motions[i].root -= shift;
+                    transforms[i].translation -= shift;
+
+                    if (objects[i] != nullptr)
+                    {
+                        objects[i]->transform.reset(transforms[i]);
+                    }
+                }
+            });
+    }
+
+    std::size_t SpinningCubes::size() const
+    {
+        return this->cubes.size();
+    }
+} // namespace game::entity
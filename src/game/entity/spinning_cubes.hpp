@@ -0,0 +1,68 @@
+#ifndef SRC_GAME_ENTITY_SPINNING_CUBES_HPP
+#define SRC_GAME_ENTITY_SPINNING_CUBES_HPP
+
+#include "archetype.hpp"
+#include <chrono>
+#include <gfx/recordables/flat_recordable.hpp>
+#include <gfx/transform.hpp>
+#include <memory>
+
+namespace gfx
+{
+    class Renderer;
+} // namespace gfx
+
+namespace game::world
+{
+    struct Rebase;
+} // namespace game::world
+
+namespace game::entity
+{
+    /// Every cube that bobs and spins like Cube, stored in one Archetype and
+    /// ticked in contiguous batches rather than as an Entity and a future
+    /// each.
+    class SpinningCubes
+    {
+    public:
+        // What a cube needs to work out its next transform
+        struct Motion
+        {
+            glm::vec3 root;
+            float     time_alive;
+        };
+
+        using Cubes = Archetype<
+            Motion,
+            gfx::Transform,
+            std::shared_ptr<gfx::recordables::FlatRecordable>>;
+        using Id    = Cubes::Id;
+
+    public:
+        explicit SpinningCubes(const gfx::Renderer&);
+        ~SpinningCubes() = default;
+
+        SpinningCubes(const SpinningCubes&)             = delete;
+        SpinningCubes(SpinningCubes&&)                  = delete;
+        SpinningCubes& operator= (const SpinningCubes&) = delete;
+        SpinningCubes& operator= (SpinningCubes&&)      = delete;
+
+        Id   spawn(glm::vec3 position);
+        // Returns false if the id was stale
+        bool despawn(Id);
+
+        // Not called concurrently with onRebase(), spawn(), or despawn()
+        void tick(
+            float                                 deltaTimeSeconds,
+            std::chrono::steady_clock::time_point tickTime);
+        void onRebase(world::Rebase);
+
+        [[nodiscard]] std::size_t size() const;
+
+    private:
+        const gfx::Renderer& renderer;
+        Cubes                cubes;
+    };
+} // namespace game::entity
+
+#endif // SRC_GAME_ENTITY_SPINNING_CUBES_HPP
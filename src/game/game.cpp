@@ -1,19 +1,32 @@
 #include "game.hpp"
-#include "entity/cube.hpp"
 #include "entity/disk_entity.hpp"
+#include <engine/settings.hpp>
 #include <gfx/imgui_menu.hpp>
 #include <gfx/renderer.hpp>
+#include <util/flight_recorder.hpp>
 #include <util/log.hpp>
 
 namespace game
 {
+    namespace
+    {
+        // Past this many ticks back to back, the game falls behind rather
+        // than never sleeping again
+        constexpr std::uint32_t MaxCatchUpTicks {5};
+    } // namespace
+
     Game::Game(gfx::Renderer& renderer_)
         : renderer {renderer_}
         , player {*this, {30.0f, 30.0f, -30.0f}}
         , world {*this}
+        , spinning_cubes {renderer_}
+        , timestep {
+              engine::getSettings()
+                  .lookupSetting<engine::Setting::TickRateHz>(),
+              MaxCatchUpTicks}
+        , tick_time {}
     {
-        this->temp_entities.push_back(
-            entity::Cube::create(*this, glm::vec3 {0.0f, 12.5f, 0.0f}));
+        this->spinning_cubes.spawn(glm::vec3 {0.0f, 12.5f, 0.0f});
 
         this->temp_entities.push_back(
             entity::DiskEntity::create(*this, "../models/gizmo.obj"));
@@ -32,7 +45,17 @@ namespace game
 
     float Game::getTickDeltaTimeSeconds() const
     {
-        return this->last_tick_duration.load(std::memory_order_acquire).count();
+        return std::chrono::duration<float> {this->timestep.getStep()}.count();
+    }
+
+    engine::FixedTimestep::Clock::time_point Game::getTickTime() const
+    {
+        return this->tick_time;
+    }
+
+    const engine::Event<world::Rebase>& Game::getRebaseEvent() const
+    {
+        return this->rebase_event;
     }
 
     bool Game::continueTicking() // NOLINT: will change
@@ -40,31 +63,78 @@ namespace game
         return true;
     }
 
-    void Game::tick()
+    void Game::run(const std::function<bool()>& shouldContinue)
+    {
+        this->timestep.run(
+            [&]
+            {
+                return this->continueTicking() && shouldContinue();
+            },
+            [this](engine::FixedTimestep::Clock::time_point tickTime)
+            {
+                this->tick(tickTime);
+            });
+    }
+
+    void Game::tick(engine::FixedTimestep::Clock::time_point tickTime)
     {
+        this->tick_time = tickTime;
+
+        util::recordEvent(
+            "Game tick started", this->getTickDeltaTimeSeconds());
+
+        // Before any entity starts ticking, so that nothing observes a half
+        // rebased world
+        this->recenterWorld();
+
         std::vector<std::shared_ptr<const entity::Entity>> strongEntities;
         std::vector<std::future<void>> strongEntityTickFutures;
+        std::vector<
+            util::Registrar<std::weak_ptr<const entity::Entity>>::Handle>
+            weakEntitiesToRemove {};
 
-        for (const auto& [id, weakEntity] : this->entities.access())
-        {
-            if (std::shared_ptr<const entity::Entity> obj = weakEntity.lock())
+        this->entities.flush();
+
+        strongEntities.reserve(this->entities.size());
+        strongEntityTickFutures.reserve(this->entities.size());
+
+        this->entities.visit(
+            [&](util::Registrar<std::weak_ptr<const entity::Entity>>::Handle
+                    weakHandle,
+                const std::weak_ptr<const entity::Entity>& weakEntity)
             {
-                strongEntityTickFutures.push_back(std::async(
-                    std::launch::async,
-                    [entity = obj.get()]
-                    {
-                        entity->tick();
-                    }));
-
-                strongEntities.push_back(std::move(obj));
-            }
+                if (std::shared_ptr<const entity::Entity> obj =
+                        weakEntity.lock())
+                {
+                    strongEntityTickFutures.push_back(std::async(
+                        std::launch::async,
+                        [entity = obj.get()]
+                        {
+                            entity->tick();
+                        }));
+
+                    strongEntities.push_back(std::move(obj));
+                }
+                else
+                {
+                    weakEntitiesToRemove.push_back(weakHandle);
+                }
+            });
+
+        for (auto weakHandle : weakEntitiesToRemove)
+        {
+            this->entities.remove(weakHandle);
         }
 
+        // Batched on its own workers while the entities' futures run
+        this->spinning_cubes.tick(
+            this->getTickDeltaTimeSeconds(), this->tick_time);
+
         this->player.tick();
 
-        this->renderer.setCamera(this->player.getCamera());
+        this->renderer.setCamera(this->player.getCamera(), this->tick_time);
 
-        this->world.updateChunkState();
+        this->world.updateChunkState(this->player.getCamera().getPosition());
 
         strongEntityTickFutures.clear(); // await all futures
 
@@ -80,20 +150,67 @@ namespace game
         this->renderer.getMenuState().lock(
             [&](gfx::recordables::DebugMenu::State& state)
             {
-                state.tps             = 1 / this->getTickDeltaTimeSeconds();
-                state.player_position = this->player.getCamera().getPosition();
+                state.tps = 1 / this->last_tick_duration
+                                    .load(std::memory_order_acquire)
+                                    .count();
+                state.player_position =
+                    static_cast<glm::vec3>(this->world.getOrigin())
+                    + this->player.getCamera().getPosition();
+
+                const world::World::CullingStatistics culling =
+                    this->world.getCullingStatistics();
+
+                state.chunks        = culling.chunks;
+                state.culled_chunks = culling.culled;
+
+                const engine::FixedTimestep::Statistics ticks =
+                    this->timestep.getStatistics();
+
+                state.tick_overruns = ticks.overruns;
+                state.dropped_ticks = ticks.dropped_steps;
+                state.longest_tick_ms =
+                    std::chrono::duration<float, std::milli> {
+                        ticks.longest_tick}
+                        .count();
             });
     }
 
-    void Game::registerEntity(
-        const std::shared_ptr<const entity::Entity>& entity) const
+    void Game::recenterWorld()
     {
-        this->entities.insert(std::make_pair(entity->getUUID(), entity));
+        std::optional<world::Rebase> maybeRebase =
+            this->world.getRecentering(this->player.getCamera().getPosition());
+
+        if (!maybeRebase.has_value())
+        {
+            return;
+        }
+
+        util::recordEvent(
+            "World rebased",
+            maybeRebase->origin.x,
+            maybeRebase->origin.y,
+            maybeRebase->origin.z);
+
+        this->player.getCamera().addPosition(-maybeRebase->getShift());
+
+        // The chunks, the entities, and the camera all move at once, a frame
+        // that saw only some of them moved would jump by a whole rebase
+        this->renderer.rebase(
+            this->player.getCamera(),
+            [&]
+            {
+                this->world.rebase(*maybeRebase);
+
+                this->spinning_cubes.onRebase(*maybeRebase);
+
+                this->rebase_event.invoke(*std::move(maybeRebase));
+            });
     }
 
-    void Game::removeEntity(util::UUID id) const
+    void Game::registerEntity(
+        const std::shared_ptr<const entity::Entity>& entity) const
     {
-        this->entities.remove(id);
+        this->entities.insert(entity);
     }
 
 } // namespace game
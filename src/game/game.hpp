@@ -1,12 +1,15 @@
 #ifndef SRC_GAME_GAME_HPP
 #define SRC_GAME_GAME_HPP
 
+#include "entity/spinning_cubes.hpp"
 #include "player.hpp"
 #include "world/world.hpp"
 #include <chrono>
+#include <engine/event.hpp>
+#include <engine/fixed_timestep.hpp>
+#include <functional>
 #include <memory>
 #include <util/registrar.hpp>
-#include <util/uuid.hpp>
 
 namespace gfx
 {
@@ -33,10 +36,23 @@ namespace game
         Game& operator= (const Game&) = delete;
         Game& operator= (Game&&)      = delete;
 
+        // Always the fixed step, however long the last tick really took
         [[nodiscard]] float getTickDeltaTimeSeconds() const;
+        // When the current tick was scheduled to start, which is what the
+        // states it publishes should be stamped with
+        [[nodiscard]] engine::FixedTimestep::Clock::time_point
+        getTickTime() const;
+
+        // Invoked on the game thread, between ticks, whenever the world's
+        // origin moves
+        [[nodiscard]] const engine::Event<world::Rebase>&
+        getRebaseEvent() const;
 
         [[nodiscard]] bool continueTicking();
-        void               tick();
+        void               tick(engine::FixedTimestep::Clock::time_point);
+        // Ticks at the configured tick rate until continueTicking() or
+        // shouldContinue returns false
+        void               run(const std::function<bool()>& shouldContinue);
 
     private:
 
@@ -45,16 +61,22 @@ namespace game
         friend class Player;
         friend class world::World;
         void registerEntity(const std::shared_ptr<const entity::Entity>&) const;
-        void removeEntity(util::UUID) const;
+
+        void recenterWorld();
 
         gfx::Renderer& renderer;
-        util::Registrar<util::UUID, std::weak_ptr<const entity::Entity>>
-            entities;
+        util::Registrar<std::weak_ptr<const entity::Entity>> entities;
+        engine::Event<world::Rebase>                         rebase_event;
 
         Player                                       player;
         world::World                                 world;
         std::vector<std::shared_ptr<entity::Entity>> temp_entities;
+        entity::SpinningCubes                        spinning_cubes;
+
+        engine::FixedTimestep                   timestep;
+        engine::FixedTimestep::Clock::time_point tick_time;
 
+        // Measured, for the debug menu
         std::chrono::time_point<std::chrono::steady_clock> last_tick_end_time;
         std::atomic<std::chrono::duration<float>>          last_tick_duration;
     };
@@ -1,5 +1,6 @@
 #include "player.hpp"
 #include <game/game.hpp>
+#include <game/world/voxel_collision.hpp>
 #include <gfx/renderer.hpp>
 #include <gfx/window.hpp>
 
@@ -19,53 +20,65 @@ namespace game
                                          : 10.0f;
         const float rotateSpeedScale = 1.0f;
 
-        this->camera.addPosition(
+        glm::vec3 movement {0.0f, 0.0f, 0.0f};
+
+        movement +=
             this->camera.getForwardVector()
             * this->game.getTickDeltaTimeSeconds() * moveScale
             * (this->game.renderer.isActionActive(
                    gfx::Window::Action::PlayerMoveForward)
                    ? 1.0f
-                   : 0.0f));
+                   : 0.0f);
 
-        this->camera.addPosition(
+        movement +=
             -this->camera.getForwardVector()
             * this->game.getTickDeltaTimeSeconds() * moveScale
             * (this->game.renderer.isActionActive(
                    gfx::Window::Action::PlayerMoveBackward)
                    ? 1.0f
-                   : 0.0f));
+                   : 0.0f);
 
-        this->camera.addPosition(
+        movement +=
             -this->camera.getRightVector()
             * this->game.getTickDeltaTimeSeconds() * moveScale
             * (this->game.renderer.isActionActive(
                    gfx::Window::Action::PlayerMoveLeft)
                    ? 1.0f
-                   : 0.0f));
+                   : 0.0f);
 
-        this->camera.addPosition(
-            this->camera.getRightVector() * this->game.getTickDeltaTimeSeconds()
-            * moveScale
+        movement +=
+            this->camera.getRightVector()
+            * this->game.getTickDeltaTimeSeconds() * moveScale
             * (this->game.renderer.isActionActive(
                    gfx::Window::Action::PlayerMoveRight)
                    ? 1.0f
-                   : 0.0f));
+                   : 0.0f);
 
-        this->camera.addPosition(
+        movement +=
             gfx::Transform::UpVector * this->game.getTickDeltaTimeSeconds()
             * moveScale
             * (this->game.renderer.isActionActive(
                    gfx::Window::Action::PlayerMoveUp)
                    ? 1.0f
-                   : 0.0f));
+                   : 0.0f);
 
-        this->camera.addPosition(
+        movement +=
             -gfx::Transform::UpVector * this->game.getTickDeltaTimeSeconds()
             * moveScale
             * (this->game.renderer.isActionActive(
                    gfx::Window::Action::PlayerMoveDown)
                    ? 1.0f
-                   : 0.0f));
+                   : 0.0f);
+
+        // The eyes are near the top of the box
+        const glm::vec3 eye = this->camera.getPosition();
+        const world::Aabb box {
+            .minimum {eye - glm::vec3 {HalfWidth, EyeHeight, HalfWidth}},
+            .maximum {
+                eye + glm::vec3 {HalfWidth, Height - EyeHeight, HalfWidth}}};
+
+        this->camera.addPosition(
+            this->game.world.sweepBox(box, movement).displacement);
 
         auto [xDelta, yDelta] = this->game.renderer.getMouseDeltaRadians();
 
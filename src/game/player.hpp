@@ -28,6 +28,11 @@ namespace game
         gfx::Camera& getCamera();
 
     private:
+        // The box that collides with the world, around the camera
+        static constexpr float HalfWidth {0.3f};
+        static constexpr float Height {1.8f};
+        static constexpr float EyeHeight {1.6f};
+
         const Game& game;
         gfx::Camera camera;
     };
@@ -2,15 +2,20 @@
 #include "game/world/chunk.hpp"
 #include "game/world/sparse_volume.hpp"
 #include "gfx/renderer.hpp"
+#include "util/flight_recorder.hpp"
 #include "util/log.hpp"
 #include "util/misc.hpp"
 #include "util/threads.hpp"
 #include <chrono>
-#include <gfx/recordables/flat_recordable.hpp>
+#include <gfx/recordables/chunk_recordable.hpp>
+#include <gfx/recordables/voxel_recordable.hpp>
 #include <memory>
 #include <ranges>
+#include <span>
 #include <thread>
+#include <tuple>
 #include <util/noise.hpp>
+#include <variant>
 
 namespace game::world
 {
@@ -24,18 +29,23 @@ namespace game::world
 
     Chunk::Chunk()
         : lod {3}
+        , draw_mode {ChunkDrawMode::Meshed}
         , state {ChunkStates::Invalid}
     {}
 
     Chunk::Chunk(
         Position position_,
         util::Fn<std::int32_t(std::int32_t, std::int32_t) noexcept>
-            generationFunc)
+                      generationFunc,
+        ChunkDrawMode drawMode)
         : location {position_}
         , lod {5}
+        , draw_mode {drawMode}
         , state {ChunkStates::WaitingForVolume}
         , volume {nullptr}
-        , object {nullptr}
+        , light {nullptr}
+        , visibility {}
+        , object {}
         , future_volume {std::nullopt}
         , future_object {std::nullopt}
     {
@@ -69,6 +79,11 @@ namespace game::world
                 util::logTrace(
                     "SparseVolume creation started @ {}",
                     static_cast<std::string>(position));
+                util::recordEvent(
+                    "Chunk volume generation started",
+                    position.x,
+                    position.y,
+                    position.z);
 
                 auto start = std::chrono::high_resolution_clock::now();
 
@@ -134,12 +149,17 @@ namespace game::world
                         //     static_cast<std::string>(polled),
                         //     static_cast<std::string>(position));
 
-                        workingVolume->accessFromLocalPosition(accessPosition) =
+                        workingVolume->writeToLocalPosition(
+                            accessPosition,
                             world::Voxel {
-                                .r {util::convertLinearToSRGB(color.r)},
-                                .g {util::convertLinearToSRGB(color.g)},
-                                .b {util::convertLinearToSRGB(color.b)},
-                                .a {static_cast<std::uint8_t>(color.a * 255)}};
+                                .alpha_or_emissive {Voxel::OpaqueAlpha},
+                                .srgb_r {util::convertLinearToSRGB(color.r)},
+                                .srgb_g {util::convertLinearToSRGB(color.g)},
+                                .srgb_b {util::convertLinearToSRGB(color.b)},
+                                .special {0},
+                                .specular {0},
+                                .roughness {0},
+                                .metallic {0}});
                     }
                 }
 
@@ -151,11 +171,48 @@ namespace game::world
                         end - start)
                         .count());
 
-                return workingVolume;
+                util::recordEvent(
+                    "Chunk volume generation finished",
+                    position.x,
+                    position.y,
+                    position.z);
+
+                start = std::chrono::high_resolution_clock::now();
+
+                std::shared_ptr<LightVolume> workingLight =
+                    std::make_shared<LightVolume>(*workingVolume);
+
+                workingLight->relight();
+
+                end = std::chrono::high_resolution_clock::now();
+
+                util::logTrace(
+                    "Lit chunk in {}ms",
+                    std::chrono::duration_cast<std::chrono::milliseconds>(
+                        end - start)
+                        .count());
+
+                start = std::chrono::high_resolution_clock::now();
+
+                ChunkVisibility workingVisibility {*workingVolume};
+
+                end = std::chrono::high_resolution_clock::now();
+
+                util::logTrace(
+                    "Found chunk visibility in {}ms",
+                    std::chrono::duration_cast<std::chrono::milliseconds>(
+                        end - start)
+                        .count());
+
+                return std::tuple {
+                    std::move(workingVolume),
+                    std::move(workingLight),
+                    workingVisibility};
             });
     }
 
-    void Chunk::updateDrawState(const gfx::Renderer& renderer)
+    void Chunk::updateDrawState(
+        const gfx::Renderer& renderer, Position worldOrigin)
     {
         switch (this->state)
         {
@@ -165,36 +222,81 @@ namespace game::world
             if (this->future_volume->valid())
             {
                 // NOLINTNEXTLINE: Checked by state machine
-                this->volume = this->future_volume->get();
+                std::tie(this->volume, this->light, this->visibility) =
+                    this->future_volume->get();
 
+                // Meshes a snapshot, so the volume may keep being edited
+                // while this runs
                 this->future_object = std::async(
                     std::launch::async,
                     [lambdaLocation  = this->location,
-                     lambdaVolume    = this->volume,
-                     &lambdaRenderer = renderer]
-                    -> std::shared_ptr<gfx::recordables::FlatRecordable>
+                     lambdaDrawMode  = this->draw_mode,
+                     lambdaVolume    = this->volume->snapshot(),
+                     lambdaLight     = this->light,
+                     lambdaTransform = this->getTransform(worldOrigin),
+                     &lambdaRenderer = renderer] -> Object
                     {
                         auto start = std::chrono::high_resolution_clock::now();
 
                         util::assertFatal(
                             lambdaVolume != nullptr, "Volume was nullptr!");
 
+                        // Drawn relative to the chunk so that the vertices
+                        // stay small, the chunk's transform places it
+                        if (lambdaDrawMode == ChunkDrawMode::Instanced)
+                        {
+                            std::vector<
+                                gfx::recordables::VoxelRecordable::Instance>
+                                instances =
+                                    lambdaVolume->drawInstances(*lambdaLight);
+
+                            auto end =
+                                std::chrono::high_resolution_clock::now();
+
+                            util::logTrace(
+                                "Instanced chunk in {}ms | {} bytes",
+                                std::chrono::duration_cast<
+                                    std::chrono::milliseconds>(end - start)
+                                    .count(),
+                                std::span {instances}.size_bytes());
+
+                            util::recordEvent(
+                                "Chunk instanced",
+                                lambdaLocation.x,
+                                lambdaLocation.y,
+                                lambdaLocation.z);
+
+                            return gfx::recordables::VoxelRecordable::create(
+                                lambdaRenderer,
+                                std::move(instances),
+                                lambdaTransform,
+                                "Chunk");
+                        }
+
                         auto [vertices, indices] =
-                            lambdaVolume->draw(lambdaLocation);
+                            lambdaVolume->draw(*lambdaLight);
 
                         auto end = std::chrono::high_resolution_clock::now();
 
                         util::logTrace(
-                            "Triangulated chunk in {}ms",
+                            "Triangulated chunk in {}ms | {} bytes",
                             std::chrono::duration_cast<
                                 std::chrono::milliseconds>(end - start)
-                                .count());
+                                .count(),
+                            std::span {vertices}.size_bytes()
+                                + std::span {indices}.size_bytes());
+
+                        util::recordEvent(
+                            "Chunk triangulated",
+                            lambdaLocation.x,
+                            lambdaLocation.y,
+                            lambdaLocation.z);
 
-                        return gfx::recordables::FlatRecordable::create(
+                        return gfx::recordables::ChunkRecordable::create(
                             lambdaRenderer,
                             std::move(vertices),
                             std::move(indices),
-                            gfx::Transform {},
+                            lambdaTransform,
                             "Chunk");
                     });
 
@@ -213,6 +315,9 @@ namespace game::world
                 // NOLINTNEXTLINE: Checked by state machine
                 this->object = this->future_object->get();
 
+                // The world may have been rebased while this was meshing
+                this->rebase(worldOrigin);
+
                 this->state = ChunkStates::Initalized;
 
                 this->future_object = std::nullopt;
@@ -224,7 +329,12 @@ namespace game::world
 
             // if this object is default constructed or moved from this->object
             // is nullptr, check this and print a warning
-            if (this->object == nullptr)
+            if (std::visit(
+                    [](const auto& object)
+                    {
+                        return object == nullptr;
+                    },
+                    this->object))
             {
                 util::logWarn(
                     "Chunk::draw() called on default constructed or moved from "
@@ -248,4 +358,52 @@ namespace game::world
 
         util::panic("Left control flow in Chunk::draw()");
     }
+
+    void Chunk::rebase(Position worldOrigin) const
+    {
+        std::visit(
+            [&](const auto& object)
+            {
+                if (object != nullptr)
+                {
+                    object->transform.publish(this->getTransform(worldOrigin));
+                }
+            },
+            this->object);
+    }
+
+    void Chunk::setCulled(bool isCulled) const
+    {
+        std::visit(
+            [&](const auto& object)
+            {
+                if (object != nullptr)
+                {
+                    object->setCulled(isCulled);
+                }
+            },
+            this->object);
+    }
+
+    ChunkCoordinate Chunk::getLocation() const
+    {
+        return this->location;
+    }
+
+    const SparseVoxelVolume* Chunk::getVolume() const
+    {
+        return this->volume.get();
+    }
+
+    const ChunkVisibility& Chunk::getVisibility() const
+    {
+        return this->visibility;
+    }
+
+    gfx::Transform Chunk::getTransform(Position worldOrigin) const
+    {
+        return gfx::Transform {
+            .translation {
+                static_cast<glm::vec3>(this->location - worldOrigin)}};
+    }
 } // namespace game::world
@@ -1,11 +1,16 @@
 #ifndef SRC_GAME_WORLD_CHUNK_HPP
 #define SRC_GAME_WORLD_CHUNK_HPP
 
+#include "game/world/chunk_visibility.hpp"
+#include "game/world/light_volume.hpp"
 #include "game/world/sparse_volume.hpp"
-#include <gfx/recordables/flat_recordable.hpp>
+#include <gfx/recordables/chunk_recordable.hpp>
+#include <gfx/recordables/voxel_recordable.hpp>
 #include <memory>
 #include <optional>
+#include <tuple>
 #include <util/misc.hpp>
+#include <variant>
 
 namespace game::world
 {
@@ -16,17 +21,17 @@ namespace game::world
     {
         explicit constexpr LodLevel(std::size_t distanceFromView)
         {
-            static_assert(SparseVoxelVolume::VoxelExtent == 512);
+            constexpr std::size_t VoxelExtent {SparseVoxelVolume::VoxelExtent};
 
-            if (distanceFromView <= 512)
+            if (distanceFromView <= VoxelExtent)
             {
-                this->level =
-                    static_cast<std::uint8_t>(util::log2<std::size_t>(512) + 1);
+                this->level = static_cast<std::uint8_t>(
+                    util::log2<std::size_t>(VoxelExtent) + 1);
             }
 
-            std::size_t result = 256;
+            std::size_t result = VoxelExtent / 2;
 
-            while (result > 1 && distanceFromView > 1024)
+            while (result > 1 && distanceFromView > VoxelExtent * 2)
             {
                 distanceFromView /= 2;
                 result /= 2;
@@ -45,10 +50,24 @@ namespace game::world
     private:
         std::uint8_t level;
     };
-    static_assert(LodLevel {755}.getNumberOfVoxelsPerChunks() == 256);
+    static_assert(
+        LodLevel {SparseVoxelVolume::VoxelExtent * 3 / 2}
+            .getNumberOfVoxelsPerChunks()
+        == SparseVoxelVolume::VoxelExtent / 2);
 
     enum class ChunkStates : std::uint8_t;
 
+    // How a chunk's voxels are turned into something the gpu draws. World
+    // picks one for every chunk from Setting::InstancedChunks
+    enum class ChunkDrawMode : std::uint8_t
+    {
+        // Faces meshed on the cpu, with smooth lighting and ambient occlusion
+        Meshed = 0,
+        // A cube instance for every voxel that isn't buried, far less cpu
+        // work and upload, but more triangles and no ambient occlusion
+        Instanced = 1,
+    };
+
     // yup its a state machine, deal with it :cry:
     class Chunk
     {
@@ -56,7 +75,8 @@ namespace game::world
         Chunk();
         Chunk(
             Position,
-            util::Fn<std::int32_t(std::int32_t, std::int32_t) noexcept>);
+            util::Fn<std::int32_t(std::int32_t, std::int32_t) noexcept>,
+            ChunkDrawMode = ChunkDrawMode::Meshed);
         ~Chunk() = default;
 
         Chunk(const Chunk&)                 = delete;
@@ -76,25 +96,47 @@ namespace game::world
         // isn't
         // ready
         // TODO: add position and have each one manage their own LODs
-        void updateDrawState(const gfx::Renderer&);
+        void updateDrawState(const gfx::Renderer&, Position worldOrigin);
+
+        // Moves this chunk's mesh to be relative to the new origin
+        void rebase(Position worldOrigin) const;
+
+        // Hides, or shows again, this chunk's mesh if it has one
+        void setCulled(bool) const;
+
+        [[nodiscard]] ChunkCoordinate getLocation() const;
+        // nullptr until the volume has been generated
+        [[nodiscard]] const SparseVoxelVolume* getVolume() const;
+        // Every face sees every other until the volume has been generated
+        [[nodiscard]] const ChunkVisibility& getVisibility() const;
 
     private:
+        using Object = std::variant<
+            std::shared_ptr<gfx::recordables::ChunkRecordable>,
+            std::shared_ptr<gfx::recordables::VoxelRecordable>>;
+
+        gfx::Transform getTransform(Position worldOrigin) const;
 
         Position getCenterLocation() const;
         bool     isPositionWithinRadius(Position) const;
 
         ChunkCoordinate     location;
         LodLevel            lod;
+        ChunkDrawMode       draw_mode;
         mutable ChunkStates state;
 
-        std::shared_ptr<SparseVoxelVolume>                volume;
-        std::shared_ptr<gfx::recordables::FlatRecordable> object;
+        // light refers to volume, so must be destroyed first
+        std::shared_ptr<SparseVoxelVolume> volume;
+        std::shared_ptr<LightVolume>       light;
+        ChunkVisibility                    visibility;
+        Object                             object;
 
-        std::optional<std::future<std::shared_ptr<SparseVoxelVolume>>>
+        std::optional<std::future<std::tuple<
+            std::shared_ptr<SparseVoxelVolume>,
+            std::shared_ptr<LightVolume>,
+            ChunkVisibility>>>
             future_volume;
-        std::optional<
-            std::future<std::shared_ptr<gfx::recordables::FlatRecordable>>>
-            future_object;
+        std::optional<std::future<Object>> future_object;
     };
 } // namespace game::world
 
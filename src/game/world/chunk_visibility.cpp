@@ -0,0 +1,327 @@
+#include "chunk_visibility.hpp"
+#include <utility>
+#include <vector>
+
+namespace game::world
+{
+    namespace
+    {
+        constexpr std::int32_t BrickExtent {VoxelVolume::Extent};
+        constexpr std::int32_t BricksPerAxis {SparseVoxelVolume::Extent};
+        constexpr std::size_t  VoxelsPerBrick {
+            static_cast<std::size_t>(BrickExtent * BrickExtent * BrickExtent)};
+
+        constexpr std::array<Position, 6> FaceNormals {
+            Position {1, 0, 0},
+            Position {-1, 0, 0},
+            Position {0, 1, 0},
+            Position {0, -1, 0},
+            Position {0, 0, 1},
+            Position {0, 0, -1},
+        };
+
+        std::size_t flattenBrickIndex(Position brickIndex)
+        {
+            return static_cast<std::size_t>(
+                (brickIndex.x * BricksPerAxis + brickIndex.y) * BricksPerAxis
+                + brickIndex.z);
+        }
+
+        std::size_t flattenPositionInBrick(Position positionInBrick)
+        {
+            return static_cast<std::size_t>(
+                (positionInBrick.x * BrickExtent + positionInBrick.y)
+                    * BrickExtent
+                + positionInBrick.z);
+        }
+
+        bool isBrickIndexInside(Position b)
+        {
+            return b.x >= 0 && b.x < BricksPerAxis && b.y >= 0
+                && b.y < BricksPerAxis && b.z >= 0 && b.z < BricksPerAxis;
+        }
+
+        bool isVoxelInside(Position p)
+        {
+            auto isAxisInside = [](std::int32_t a)
+            {
+                return a >= SparseVoxelVolume::VoxelMinimum
+                    && a <= SparseVoxelVolume::VoxelMaximum;
+            };
+
+            return isAxisInside(p.x) && isAxisInside(p.y) && isAxisInside(p.z);
+        }
+
+        // A step of the flood fill, either a single open voxel or a whole
+        // unallocated brick
+        struct Cell
+        {
+            // A voxel's local position, or a brick's index
+            Position position;
+            bool     is_brick;
+        };
+
+        class FloodFill
+        {
+        public:
+            explicit FloodFill(const SparseVoxelVolume& volume_)
+                : volume {volume_}
+                , brick_slots(
+                      static_cast<std::size_t>(
+                          BricksPerAxis * BricksPerAxis * BricksPerAxis),
+                      -1)
+                , is_brick_visited(brick_slots.size(), false)
+                , is_voxel_visited {}
+                , queue {}
+            {
+                std::int32_t nextSlot = 0;
+
+                this->volume.visitOccupiedBricks(
+                    [&](Position brickMinimum)
+                    {
+                        this->brick_slots[flattenBrickIndex(
+                            SparseVoxelVolume::getBrickIndex(brickMinimum))] =
+                            nextSlot++;
+                    });
+
+                this->is_voxel_visited.resize(
+                    static_cast<std::size_t>(nextSlot) * VoxelsPerBrick, false);
+            }
+
+            // Queues the cell containing this voxel, if it's open and hasn't
+            // been seen yet
+            bool visitVoxel(Position localPosition)
+            {
+                const Position brickIndex =
+                    SparseVoxelVolume::getBrickIndex(localPosition);
+                const std::int32_t slot =
+                    this->brick_slots[flattenBrickIndex(brickIndex)];
+
+                if (slot < 0)
+                {
+                    return this->visitBrick(brickIndex);
+                }
+
+                const std::size_t bit =
+                    static_cast<std::size_t>(slot) * VoxelsPerBrick
+                    + flattenPositionInBrick(
+                        SparseVoxelVolume::getPositionInBrick(localPosition));
+
+                if (this->is_voxel_visited[bit]
+                    || this->volume.readFromLocalPosition(localPosition)
+                           .isOpaque())
+                {
+                    return false;
+                }
+
+                this->is_voxel_visited[bit] = true;
+                this->queue.push_back(
+                    Cell {.position {localPosition}, .is_brick {false}});
+
+                return true;
+            }
+
+            // Visits everything connected to what's been queued, returning
+            // the faces of the volume that it touched
+            std::uint8_t flood()
+            {
+                std::uint8_t touchedFaces = 0;
+
+                while (!this->queue.empty())
+                {
+                    const Cell cell = this->queue.back();
+                    this->queue.pop_back();
+
+                    for (std::size_t f = 0; f < FaceNormals.size(); ++f)
+                    {
+                        const Position normal = FaceNormals[f]; // NOLINT
+
+                        const bool leftVolume =
+                            cell.is_brick
+                                ? this->expandBrick(cell.position, normal)
+                                : this->expandVoxel(cell.position, normal);
+
+                        if (leftVolume)
+                        {
+                            touchedFaces |= static_cast<std::uint8_t>(1U << f);
+                        }
+                    }
+                }
+
+                return touchedFaces;
+            }
+
+        private:
+            bool visitBrick(Position brickIndex)
+            {
+                const std::size_t index = flattenBrickIndex(brickIndex);
+
+                if (this->is_brick_visited[index])
+                {
+                    return false;
+                }
+
+                this->is_brick_visited[index] = true;
+                this->queue.push_back(
+                    Cell {.position {brickIndex}, .is_brick {true}});
+
+                return true;
+            }
+
+            // Returns true if the step leaves the volume
+            bool expandVoxel(Position localPosition, Position normal)
+            {
+                const Position next = localPosition + normal;
+
+                if (!isVoxelInside(next))
+                {
+                    return true;
+                }
+
+                this->visitVoxel(next);
+
+                return false;
+            }
+
+            bool expandBrick(Position brickIndex, Position normal)
+            {
+                const Position next = brickIndex + normal;
+
+                if (!isBrickIndexInside(next))
+                {
+                    return true;
+                }
+
+                if (this->brick_slots[flattenBrickIndex(next)] < 0)
+                {
+                    this->visitBrick(next);
+
+                    return false;
+                }
+
+                // The layer of the allocated brick that touches this one
+                const Position nextMinimum =
+                    (next
+                     + Position {
+                         SparseVoxelVolume::Minimum,
+                         SparseVoxelVolume::Minimum,
+                         SparseVoxelVolume::Minimum})
+                    * BrickExtent;
+
+                auto layer = [&](std::int32_t n) -> std::int32_t
+                {
+                    return n > 0 ? 0 : BrickExtent - 1;
+                };
+
+                for (std::int32_t u = 0; u < BrickExtent; ++u)
+                {
+                    for (std::int32_t v = 0; v < BrickExtent; ++v)
+                    {
+                        Position inBrick {};
+
+                        if (normal.x != 0)
+                        {
+                            inBrick = Position {layer(normal.x), u, v};
+                        }
+                        else if (normal.y != 0)
+                        {
+                            inBrick = Position {u, layer(normal.y), v};
+                        }
+                        else
+                        {
+                            inBrick = Position {u, v, layer(normal.z)};
+                        }
+
+                        this->visitVoxel(nextMinimum + inBrick);
+                    }
+                }
+
+                return false;
+            }
+
+            const SparseVoxelVolume& volume;
+
+            // Allocated bricks have a slot of VoxelsPerBrick bits in
+            // is_voxel_visited, the rest are -1
+            std::vector<std::int32_t> brick_slots;
+            std::vector<bool>         is_brick_visited;
+            std::vector<bool>         is_voxel_visited;
+            std::vector<Cell>         queue;
+        };
+    } // namespace
+
+    Position getFaceNormal(ChunkFace face)
+    {
+        return FaceNormals[std::to_underlying(face)]; // NOLINT
+    }
+
+    ChunkVisibility::ChunkVisibility()
+        : connections {}
+    {
+        this->connections.fill(0b11'1111);
+    }
+
+    ChunkVisibility::ChunkVisibility(const SparseVoxelVolume& volume)
+        : connections {}
+    {
+        FloodFill fill {volume};
+
+        // Every open voxel on the boundary, each component found is only
+        // flooded once
+        for (const Position normal : FaceNormals)
+        {
+            for (std::int32_t u = SparseVoxelVolume::VoxelMinimum;
+                 u <= SparseVoxelVolume::VoxelMaximum;
+                 ++u)
+            {
+                for (std::int32_t v = SparseVoxelVolume::VoxelMinimum;
+                     v <= SparseVoxelVolume::VoxelMaximum;
+                     ++v)
+                {
+                    auto boundary = [](std::int32_t n) -> std::int32_t
+                    {
+                        return n > 0 ? SparseVoxelVolume::VoxelMaximum
+                                     : SparseVoxelVolume::VoxelMinimum;
+                    };
+
+                    Position seed {};
+
+                    if (normal.x != 0)
+                    {
+                        seed = Position {boundary(normal.x), u, v};
+                    }
+                    else if (normal.y != 0)
+                    {
+                        seed = Position {u, boundary(normal.y), v};
+                    }
+                    else
+                    {
+                        seed = Position {u, v, boundary(normal.z)};
+                    }
+
+                    if (!fill.visitVoxel(seed))
+                    {
+                        continue;
+                    }
+
+                    const std::uint8_t faces = fill.flood();
+
+                    for (std::size_t f = 0; f < this->connections.size(); ++f)
+                    {
+                        if ((faces & (1U << f)) != 0)
+                        {
+                            this->connections[f] |= faces; // NOLINT
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    bool ChunkVisibility::canSeeThrough(ChunkFace from, ChunkFace to) const
+    {
+        return (this->connections[std::to_underlying(from)] // NOLINT
+                & (1U << std::to_underlying(to)))
+            != 0;
+    }
+} // namespace game::world
@@ -0,0 +1,68 @@
+#ifndef SRC_GAME_WORLD_CHUNK_VISIBILITY_HPP
+#define SRC_GAME_WORLD_CHUNK_VISIBILITY_HPP
+
+#include "sparse_volume.hpp"
+#include <array>
+#include <cstdint>
+
+namespace game::world
+{
+    // In the same order as the faces of a cube in sparse_volume.cpp, so the
+    // opposite of a face is the face ^ 1
+    enum class ChunkFace : std::uint8_t
+    {
+        PositiveX = 0,
+        NegativeX = 1,
+        PositiveY = 2,
+        NegativeY = 3,
+        PositiveZ = 4,
+        NegativeZ = 5,
+    };
+
+    inline constexpr std::array<ChunkFace, 6> AllChunkFaces {
+        ChunkFace::PositiveX,
+        ChunkFace::NegativeX,
+        ChunkFace::PositiveY,
+        ChunkFace::NegativeY,
+        ChunkFace::PositiveZ,
+        ChunkFace::NegativeZ,
+    };
+
+    [[nodiscard]] constexpr ChunkFace getOppositeFace(ChunkFace face)
+    {
+        return static_cast<ChunkFace>(std::to_underlying(face) ^ 1U);
+    }
+
+    // The unit step out of a chunk through this face
+    [[nodiscard]] Position getFaceNormal(ChunkFace);
+
+    /// Which faces of a SparseVoxelVolume can see each other through the
+    /// volume. Two faces are connected when some open, i.e. not opaque,
+    /// voxel on one can be reached from an open voxel on the other by
+    /// stepping between open voxels.
+    ///
+    /// Found with a flood fill from every open voxel on the volume's
+    /// boundary. Bricks that aren't allocated are empty, so they're
+    /// crossed as one step rather than voxel by voxel.
+    class ChunkVisibility
+    {
+    public:
+        // Every face sees every other face, for volumes that aren't known
+        ChunkVisibility();
+        explicit ChunkVisibility(const SparseVoxelVolume&);
+        ~ChunkVisibility() = default;
+
+        ChunkVisibility(const ChunkVisibility&)             = default;
+        ChunkVisibility(ChunkVisibility&&)                  = default;
+        ChunkVisibility& operator= (const ChunkVisibility&) = default;
+        ChunkVisibility& operator= (ChunkVisibility&&)      = default;
+
+        [[nodiscard]] bool canSeeThrough(ChunkFace from, ChunkFace to) const;
+
+    private:
+        // bit `to` of connections[from]
+        std::array<std::uint8_t, 6> connections;
+    };
+} // namespace game::world
+
+#endif // SRC_GAME_WORLD_CHUNK_VISIBILITY_HPP
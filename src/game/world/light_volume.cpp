@@ -0,0 +1,596 @@
+#include "light_volume.hpp"
+#include <algorithm>
+#include <optional>
+#include <utility>
+
+namespace game::world
+{
+    namespace
+    {
+        // Each level is 80% as bright as the one above it
+        constexpr std::array<float, LightVolume::MaxLevel + 1> LevelBrightness =
+            []
+        {
+            std::array<float, LightVolume::MaxLevel + 1> brightness {};
+
+            brightness[LightVolume::MaxLevel] = 1.0f;
+
+            for (std::size_t i = LightVolume::MaxLevel; i > 0; --i)
+            {
+                brightness[i - 1] = brightness[i] * 0.8f;
+            }
+
+            return brightness;
+        }();
+
+        constexpr std::array<Position, 6> NeighborOffsets {
+            Position {1, 0, 0},
+            Position {-1, 0, 0},
+            Position {0, 1, 0},
+            Position {0, -1, 0},
+            Position {0, 0, 1},
+            Position {0, 0, -1},
+        };
+
+        bool isInside(Position p)
+        {
+            auto isAxisInside = [](std::int32_t a)
+            {
+                return a >= SparseVoxelVolume::VoxelMinimum
+                    && a <= SparseVoxelVolume::VoxelMaximum;
+            };
+
+            return isAxisInside(p.x) && isAxisInside(p.y) && isAxisInside(p.z);
+        }
+
+        // [VoxelMinimum, VoxelMaximum] -> [0, VoxelExtent)
+        std::size_t toUnsigned(std::int32_t a)
+        {
+            return static_cast<std::size_t>(
+                a - SparseVoxelVolume::VoxelMinimum);
+        }
+
+        // [VoxelMinimum, VoxelMaximum] -> [Minimum, Maximum]
+        std::int32_t toBrickCoordinate(std::int32_t a)
+        {
+            return static_cast<std::int32_t>(
+                       toUnsigned(a)
+                       / static_cast<std::size_t>(VoxelVolume::Extent))
+                 + SparseVoxelVolume::Minimum;
+        }
+
+        std::size_t getBrickIndex(Position p)
+        {
+            constexpr std::size_t Bricks = SparseVoxelVolume::Extent;
+            constexpr std::size_t Voxels = VoxelVolume::Extent;
+
+            return ((toUnsigned(p.x) / Voxels) * Bricks
+                    + (toUnsigned(p.y) / Voxels))
+                     * Bricks
+                 + (toUnsigned(p.z) / Voxels);
+        }
+
+        std::size_t getIndexInBrick(Position p)
+        {
+            constexpr std::size_t Voxels = VoxelVolume::Extent;
+
+            return ((toUnsigned(p.x) % Voxels) * Voxels
+                    + (toUnsigned(p.y) % Voxels))
+                     * Voxels
+                 + (toUnsigned(p.z) % Voxels);
+        }
+
+        std::size_t getColumnIndex(std::int32_t x, std::int32_t z)
+        {
+            return toUnsigned(x) * SparseVoxelVolume::VoxelExtent
+                 + toUnsigned(z);
+        }
+
+        std::uint8_t getChannel(LightChannel channel, std::uint8_t packed)
+        {
+            return channel == LightChannel::Block
+                     ? static_cast<std::uint8_t>(packed & 0xFU)
+                     : static_cast<std::uint8_t>(packed >> 4U);
+        }
+
+        std::uint8_t setChannel(
+            LightChannel channel, std::uint8_t packed, std::uint8_t level)
+        {
+            return channel == LightChannel::Block
+                     ? static_cast<std::uint8_t>((packed & 0xF0U) | level)
+                     : static_cast<std::uint8_t>(
+                         (packed & 0x0FU) | static_cast<unsigned>(level << 4U));
+        }
+    } // namespace
+
+    LightVolume::LightVolume(const SparseVoxelVolume& volume_)
+        : volume {volume_}
+        , bricks {}
+        , heights(
+              static_cast<std::size_t>(VoxelsPerAxis * VoxelsPerAxis),
+              SparseVoxelVolume::VoxelMinimum - 1)
+        , is_brick_dirty(
+              static_cast<std::size_t>(
+                  BricksPerAxis * BricksPerAxis * BricksPerAxis),
+              false)
+        , dirty_bricks {}
+        , is_relighting {false}
+    {
+        this->bricks.resize(static_cast<std::size_t>(
+            BricksPerAxis * BricksPerAxis * BricksPerAxis));
+
+        for (auto& b : this->bricks)
+        {
+            b = std::uint8_t {0};
+        }
+    }
+
+    void LightVolume::relight()
+    {
+        for (auto& b : this->bricks)
+        {
+            b = std::uint8_t {0};
+        }
+
+        // Everything needs to be meshed after a relight anyway
+        this->is_relighting = true;
+
+        std::vector<Position> queue {};
+
+        this->recalculateAllHeights();
+
+        // Sky light enters from the side wherever a column is taller than its
+        // neighbor, seed with the neighbor's exposed voxels
+        for (std::int32_t x = SparseVoxelVolume::VoxelMinimum;
+             x <= SparseVoxelVolume::VoxelMaximum;
+             ++x)
+        {
+            for (std::int32_t z = SparseVoxelVolume::VoxelMinimum;
+                 z <= SparseVoxelVolume::VoxelMaximum;
+                 ++z)
+            {
+                const std::int32_t height =
+                    this->heights[getColumnIndex(x, z)];
+
+                for (Position offset : NeighborOffsets)
+                {
+                    const Position neighbor {x + offset.x, 0, z + offset.z};
+
+                    if (offset.y != 0 || !isInside(neighbor))
+                    {
+                        continue;
+                    }
+
+                    for (std::int32_t y =
+                             this->heights[getColumnIndex(
+                                 neighbor.x, neighbor.z)]
+                             + 1;
+                         y < height;
+                         ++y)
+                    {
+                        queue.push_back(Position {neighbor.x, y, neighbor.z});
+                    }
+                }
+            }
+        }
+
+        this->propagate(LightChannel::Sky, queue);
+
+        // Emissive voxels are the block light sources
+        this->volume.visitOccupiedBricks(
+            [&](Position brickMinimum)
+            {
+                for (std::int32_t x = 0; x < BrickExtent; ++x)
+                {
+                    for (std::int32_t y = 0; y < BrickExtent; ++y)
+                    {
+                        for (std::int32_t z = 0; z < BrickExtent; ++z)
+                        {
+                            const Position p =
+                                brickMinimum + Position {x, y, z};
+
+                            const std::uint8_t emission =
+                                this->volume.readFromLocalPosition(p)
+                                    .getEmission();
+
+                            if (emission != 0)
+                            {
+                                this->store(LightChannel::Block, p, emission);
+
+                                queue.push_back(p);
+                            }
+                        }
+                    }
+                }
+            });
+
+        this->propagate(LightChannel::Block, queue);
+
+        this->is_relighting = false;
+
+        std::fill(
+            this->is_brick_dirty.begin(), this->is_brick_dirty.end(), false);
+        this->dirty_bricks.clear();
+    }
+
+    void LightVolume::updateVoxel(Position p, Voxel previous)
+    {
+        const Voxel current = this->volume.readFromLocalPosition(p);
+
+        if (previous.isOpaque() == current.isOpaque()
+            && previous.getEmission() == current.getEmission())
+        {
+            return;
+        }
+
+        std::vector<Removal>  removals {};
+        std::vector<Position> queue {};
+
+        // Block light
+        {
+            const std::uint8_t oldLevel =
+                this->getLevel(LightChannel::Block, p);
+
+            if (oldLevel != 0)
+            {
+                this->store(LightChannel::Block, p, 0);
+
+                removals.push_back(Removal {.position {p}, .level {oldLevel}});
+            }
+
+            this->unpropagate(LightChannel::Block, removals, queue);
+
+            if (const std::uint8_t emission = current.getEmission();
+                emission != 0)
+            {
+                this->store(LightChannel::Block, p, emission);
+
+                queue.push_back(p);
+            }
+
+            // Let the surroundings flood back into where this voxel was
+            if (!current.isOpaque())
+            {
+                for (Position offset : NeighborOffsets)
+                {
+                    if (isInside(p + offset))
+                    {
+                        queue.push_back(p + offset);
+                    }
+                }
+            }
+
+            this->propagate(LightChannel::Block, queue);
+        }
+
+        // Sky light
+        {
+            const std::uint8_t oldLevel = this->getLevel(LightChannel::Sky, p);
+
+            std::int32_t&      height = this->heights[getColumnIndex(p.x, p.z)];
+            const std::int32_t oldHeight = height;
+
+            if (current.isOpaque() && p.y > height)
+            {
+                height = p.y;
+            }
+            else if (!current.isOpaque() && p.y == height)
+            {
+                this->recalculateHeight(p.x, p.z);
+            }
+
+            // These were lit by the sky and now are under something
+            for (std::int32_t y = oldHeight + 1; y < height; ++y)
+            {
+                const Position covered {p.x, y, p.z};
+
+                this->store(LightChannel::Sky, covered, 0);
+
+                removals.push_back(
+                    Removal {.position {covered}, .level {MaxLevel}});
+            }
+
+            if (current.isOpaque() && oldLevel != 0)
+            {
+                this->store(LightChannel::Sky, p, 0);
+
+                removals.push_back(Removal {.position {p}, .level {oldLevel}});
+            }
+
+            this->unpropagate(LightChannel::Sky, removals, queue);
+
+            // And these have been uncovered
+            for (std::int32_t y = height + 1; y <= oldHeight; ++y)
+            {
+                queue.push_back(Position {p.x, y, p.z});
+            }
+
+            if (!current.isOpaque())
+            {
+                for (Position offset : NeighborOffsets)
+                {
+                    if (isInside(p + offset))
+                    {
+                        queue.push_back(p + offset);
+                    }
+                }
+            }
+
+            this->propagate(LightChannel::Sky, queue);
+        }
+    }
+
+    std::uint8_t LightVolume::getLevel(LightChannel channel, Position p) const
+    {
+        if (channel == LightChannel::Sky && this->isSkyExposed(p))
+        {
+            return MaxLevel;
+        }
+
+        return getChannel(channel, this->loadPacked(p));
+    }
+
+    float LightVolume::getBrightness(Position p) const
+    {
+        return LevelBrightness[std::max( // NOLINT
+            this->getLevel(LightChannel::Block, p),
+            this->getLevel(LightChannel::Sky, p))];
+    }
+
+    std::vector<Position> LightVolume::takeDirtyBricks()
+    {
+        for (Position b : this->dirty_bricks)
+        {
+            this->is_brick_dirty[getBrickIndex(Position {
+                b.x * BrickExtent, b.y * BrickExtent, b.z * BrickExtent})] =
+                false;
+        }
+
+        return std::exchange(this->dirty_bricks, {});
+    }
+
+    std::uint8_t LightVolume::loadPacked(Position p) const
+    {
+        const auto& brick = this->bricks[getBrickIndex(p)];
+
+        if (const std::uint8_t* uniform = std::get_if<std::uint8_t>(&brick))
+        {
+            return *uniform;
+        }
+
+        return (**std::get_if<std::unique_ptr<LightBrick>>(&brick)) // NOLINT
+            [getIndexInBrick(p)];
+    }
+
+    void
+    LightVolume::store(LightChannel channel, Position p, std::uint8_t level)
+    {
+        auto& brick = this->bricks[getBrickIndex(p)];
+
+        if (const std::uint8_t* uniform = std::get_if<std::uint8_t>(&brick))
+        {
+            if (setChannel(channel, *uniform, level) == *uniform)
+            {
+                return;
+            }
+
+            std::unique_ptr<LightBrick> allocated =
+                std::make_unique<LightBrick>();
+
+            allocated->fill(*uniform);
+
+            brick = std::move(allocated);
+        }
+
+        std::uint8_t& packed =
+            (**std::get_if<std::unique_ptr<LightBrick>>(&brick)) // NOLINT
+                [getIndexInBrick(p)];
+
+        const std::uint8_t next = setChannel(channel, packed, level);
+
+        if (next != packed)
+        {
+            packed = next;
+
+            if (!this->is_relighting)
+            {
+                this->markDirty(p);
+            }
+        }
+    }
+
+    void LightVolume::markDirty(Position p)
+    {
+        // The vertices of a voxel sample the light around it, so a change on
+        // the face of a brick also affects the neighboring brick's mesh
+        auto getBrickRange = [](std::int32_t a)
+        {
+            return std::pair {
+                toBrickCoordinate(
+                    std::max(a - 1, SparseVoxelVolume::VoxelMinimum)),
+                toBrickCoordinate(
+                    std::min(a + 1, SparseVoxelVolume::VoxelMaximum))};
+        };
+
+        const auto [minX, maxX] = getBrickRange(p.x);
+        const auto [minY, maxY] = getBrickRange(p.y);
+        const auto [minZ, maxZ] = getBrickRange(p.z);
+
+        for (std::int32_t x = minX; x <= maxX; ++x)
+        {
+            for (std::int32_t y = minY; y <= maxY; ++y)
+            {
+                for (std::int32_t z = minZ; z <= maxZ; ++z)
+                {
+                    const Position brick {x, y, z};
+
+                    const std::size_t index = getBrickIndex(Position {
+                        x * BrickExtent, y * BrickExtent, z * BrickExtent});
+
+                    if (!this->is_brick_dirty[index])
+                    {
+                        this->is_brick_dirty[index] = true;
+
+                        this->dirty_bricks.push_back(brick);
+                    }
+                }
+            }
+        }
+    }
+
+    bool LightVolume::isSkyExposed(Position p) const
+    {
+        return p.y > this->heights[getColumnIndex(p.x, p.z)];
+    }
+
+    bool LightVolume::isTransparent(Position p) const
+    {
+        return !this->volume.readFromLocalPosition(p).isOpaque();
+    }
+
+    void LightVolume::recalculateHeight(std::int32_t x, std::int32_t z)
+    {
+        std::int32_t y = SparseVoxelVolume::VoxelMaximum;
+
+        while (y >= SparseVoxelVolume::VoxelMinimum)
+        {
+            const Position p {x, y, z};
+
+            // skip entire empty bricks at once
+            if (std::optional<Voxel> uniform =
+                    this->volume.readUniformBrick(p);
+                uniform.has_value() && !uniform->isOpaque())
+            {
+                y = toBrickCoordinate(y) * BrickExtent - 1;
+
+                continue;
+            }
+
+            if (this->volume.readFromLocalPosition(p).isOpaque())
+            {
+                break;
+            }
+
+            --y;
+        }
+
+        this->heights[getColumnIndex(x, z)] = y;
+    }
+
+    void LightVolume::recalculateAllHeights()
+    {
+        std::ranges::fill(this->heights, SparseVoxelVolume::VoxelMinimum - 1);
+
+        // Only allocated bricks can have anything opaque in them
+        this->volume.visitOccupiedBricks(
+            [&](Position brickMinimum)
+            {
+                const std::int32_t maxY = brickMinimum.y + BrickExtent - 1;
+
+                for (std::int32_t x = brickMinimum.x;
+                     x < brickMinimum.x + BrickExtent;
+                     ++x)
+                {
+                    for (std::int32_t z = brickMinimum.z;
+                         z < brickMinimum.z + BrickExtent;
+                         ++z)
+                    {
+                        std::int32_t& height =
+                            this->heights[getColumnIndex(x, z)];
+
+                        for (std::int32_t y = maxY;
+                             y > height && y >= brickMinimum.y;
+                             --y)
+                        {
+                            if (this->volume
+                                    .readFromLocalPosition(Position {x, y, z})
+                                    .isOpaque())
+                            {
+                                height = y;
+
+                                break;
+                            }
+                        }
+                    }
+                }
+            });
+    }
+
+    void
+    LightVolume::propagate(LightChannel channel, std::vector<Position>& queue)
+    {
+        // indexed, as the queue grows while it's walked
+        for (std::size_t i = 0; i < queue.size(); ++i)
+        {
+            const Position     p     = queue[i];
+            const std::uint8_t level = this->getLevel(channel, p);
+
+            if (level <= 1)
+            {
+                continue;
+            }
+
+            for (Position offset : NeighborOffsets)
+            {
+                const Position neighbor = p + offset;
+
+                // the light lookup is cheaper than the voxel lookup, do it
+                // first
+                if (isInside(neighbor)
+                    && this->getLevel(channel, neighbor) + 1 < level
+                    && this->isTransparent(neighbor))
+                {
+                    this->store(
+                        channel,
+                        neighbor,
+                        static_cast<std::uint8_t>(level - 1));
+
+                    queue.push_back(neighbor);
+                }
+            }
+        }
+
+        queue.clear();
+    }
+
+    void LightVolume::unpropagate(
+        LightChannel           channel,
+        std::vector<Removal>&  removals,
+        std::vector<Position>& queue)
+    {
+        for (std::size_t i = 0; i < removals.size(); ++i)
+        {
+            const Removal removal = removals[i];
+
+            for (Position offset : NeighborOffsets)
+            {
+                const Position neighbor = removal.position + offset;
+
+                if (!isInside(neighbor))
+                {
+                    continue;
+                }
+
+                const std::uint8_t level = this->getLevel(channel, neighbor);
+
+                // Either lit by what was removed, or by something else that
+                // must now flood back in. Opaque voxels only hold light if
+                // they're a source, so they always flood back
+                if (level != 0 && level < removal.level
+                    && this->isTransparent(neighbor))
+                {
+                    this->store(channel, neighbor, 0);
+
+                    removals.push_back(
+                        Removal {.position {neighbor}, .level {level}});
+                }
+                else if (level != 0)
+                {
+                    queue.push_back(neighbor);
+                }
+            }
+        }
+
+        removals.clear();
+    }
+} // namespace game::world
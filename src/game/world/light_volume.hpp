@@ -0,0 +1,110 @@
+#ifndef SRC_GAME_WORLD_LIGHT_VOLUME_HPP
+#define SRC_GAME_WORLD_LIGHT_VOLUME_HPP
+
+#include "sparse_volume.hpp"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <variant>
+#include <vector>
+
+namespace game::world
+{
+    enum class LightChannel : std::uint8_t
+    {
+        Block = 0,
+        Sky   = 1,
+    };
+
+    /// Block and sky light for every voxel of a SparseVoxelVolume, stored with
+    /// the same brick layout, bricks whose light is uniform aren't allocated.
+    ///
+    /// Light is propagated with a breadth first flood fill, each step away
+    /// from a source loses one level and opaque voxels stop it entirely.
+    /// Sky light is 15 above the highest opaque voxel of each column and
+    /// floods sideways from there, emissive voxels are the block light
+    /// sources.
+    ///
+    /// Light doesn't cross from one volume to another.
+    class LightVolume
+    {
+    public:
+        static constexpr std::uint8_t MaxLevel {15};
+
+    public:
+
+        // The volume must outlive this. Every change made to it after a
+        // relight() must be followed by a call to updateVoxel()
+        explicit LightVolume(const SparseVoxelVolume&);
+        ~LightVolume() = default;
+
+        LightVolume(const LightVolume&)             = delete;
+        LightVolume(LightVolume&&)                  = delete;
+        LightVolume& operator= (const LightVolume&) = delete;
+        LightVolume& operator= (LightVolume&&)      = delete;
+
+        // Recomputes all light from scratch
+        void relight();
+
+        // Must be called after the voxel at this position changes, the
+        // flood fills only visit what the change actually affects
+        void updateVoxel(Position localPosition, Voxel previous);
+
+        [[nodiscard]] std::uint8_t
+        getLevel(LightChannel, Position localPosition) const;
+
+        // The brighter of the two channels, mapped to [0, 1]
+        [[nodiscard]] float getBrightness(Position localPosition) const;
+
+        // The bricks, in [SparseVoxelVolume::Minimum, Maximum], whose
+        // lighting or whose neighbors' lighting has changed since the last
+        // call. Only these need to be remeshed
+        [[nodiscard]] std::vector<Position> takeDirtyBricks();
+
+    private:
+        static constexpr std::int32_t BrickExtent {VoxelVolume::Extent};
+        static constexpr std::int32_t BricksPerAxis {SparseVoxelVolume::Extent};
+        static constexpr std::int32_t VoxelsPerAxis {
+            SparseVoxelVolume::VoxelExtent};
+
+        // block light in the low nibble, sky light in the high nibble
+        using LightBrick = std::array<
+            std::uint8_t,
+            static_cast<std::size_t>(BrickExtent * BrickExtent * BrickExtent)>;
+
+        struct Removal
+        {
+            Position     position;
+            std::uint8_t level;
+        };
+
+        [[nodiscard]] std::uint8_t loadPacked(Position) const;
+        void                       store(LightChannel, Position, std::uint8_t);
+        void                       markDirty(Position);
+
+        [[nodiscard]] bool isSkyExposed(Position) const;
+        [[nodiscard]] bool isTransparent(Position) const;
+        void               recalculateHeight(std::int32_t x, std::int32_t z);
+        void               recalculateAllHeights();
+
+        void propagate(LightChannel, std::vector<Position>& queue);
+        void unpropagate(
+            LightChannel, std::vector<Removal>&, std::vector<Position>& queue);
+
+        const SparseVoxelVolume& volume;
+
+        std::vector<std::variant<std::unique_ptr<LightBrick>, std::uint8_t>>
+            bricks;
+
+        // the y of the highest opaque voxel in each column, everything above
+        // it is lit by the sky. Below VoxelMinimum if the column is empty
+        std::vector<std::int32_t> heights;
+
+        std::vector<bool>     is_brick_dirty;
+        std::vector<Position> dirty_bricks;
+        bool                  is_relighting;
+    };
+} // namespace game::world
+
+#endif // SRC_GAME_WORLD_LIGHT_VOLUME_HPP
@@ -1,37 +1,14 @@
 #include "sparse_volume.hpp"
+#include "game/world/light_volume.hpp"
 #include "game/world/sparse_volume.hpp"
 #include "glm/gtx/string_cast.hpp"
 #include "util/misc.hpp"
+#include <atomic>
 #include <engine/settings.hpp>
 #include <ranges>
 #include <util/log.hpp>
 #include <variant>
 
-namespace
-{
-    template<util::Integer I>
-    I cyclicMod(I in, I mod)
-    {
-        I val = in % mod;
-
-        return val < 0 ? val + mod : val;
-    }
-
-    template<util::Integer I>
-    I flooringDiv(I dividend, I divisor)
-    {
-        I quotient  = dividend / divisor;
-        I remainder = dividend % divisor;
-
-        if ((divisor < 0) != (remainder < 0))
-        {
-            quotient--;
-        }
-
-        return quotient;
-    }
-} // namespace
-
 namespace game::world
 {
     Position game::world::Position::operator- () const
@@ -50,6 +27,15 @@ namespace game::world
             this->x + other.x, this->y + other.y, this->z + other.z};
     }
 
+    Position Position::operator* (std::int32_t number) const
+    {
+        return Position {
+            this->x * number,
+            this->y * number,
+            this->z * number,
+        };
+    }
+
     Position Position::operator/ (std::int32_t number) const
     {
         return Position {
@@ -76,33 +62,59 @@ namespace game::world
     glm::vec4 Voxel::getColor() const
     {
         return glm::vec4 {
-            util::convertSRGBToLinear(this->r),
-            util::convertSRGBToLinear(this->g),
-            util::convertSRGBToLinear(this->b),
-            static_cast<float>(this->a) / 255.0f};
+            util::convertSRGBToLinear(this->srgb_r),
+            util::convertSRGBToLinear(this->srgb_g),
+            util::convertSRGBToLinear(this->srgb_b),
+            this->isOpaque() ? 1.0f
+                             : static_cast<float>(this->alpha_or_emissive)
+                                   / static_cast<float>(OpaqueAlpha - 1)};
     }
 
     Voxel::operator std::string () const
     {
         return fmt::format(
-            "R: {} | G: {} | B: {} | A: {}",
-            this->r,
-            this->g,
-            this->b,
-            this->a);
+            "R: {} | G: {} | B: {} | A: {} | Special: {} | Specular: {} | "
+            "Roughness: {} | Metallic: {}",
+            this->srgb_r,
+            this->srgb_g,
+            this->srgb_b,
+            this->alpha_or_emissive,
+            this->special,
+            this->specular,
+            this->roughness,
+            this->metallic);
     }
 
     bool Voxel::shouldDraw() const
     {
-        return this->a != 0;
+        return this->alpha_or_emissive != 0;
+    }
+
+    bool Voxel::isOpaque() const
+    {
+        return this->alpha_or_emissive >= OpaqueAlpha;
+    }
+
+    std::uint8_t Voxel::getEmission() const
+    {
+        if (this->alpha_or_emissive <= OpaqueAlpha)
+        {
+            return 0;
+        }
+
+        // [129, 255] -> [1, 15]
+        return static_cast<std::uint8_t>(
+            ((this->alpha_or_emissive - OpaqueAlpha - 1) * 14) / 126 + 1);
     }
 
-    VoxelVolume::VoxelVolume()
+    template<std::int32_t E>
+    BasicVoxelVolume<E>::BasicVoxelVolume()
     {
         std::memset(&this->storage, '\0', sizeof(this->storage));
     }
 
-    VoxelVolume::VoxelVolume(Voxel fillVoxel)
+    template<std::int32_t E>
+    BasicVoxelVolume<E>::BasicVoxelVolume(Voxel fillVoxel)
     {
         for (auto& xArray : this->storage)
         {
@@ -116,21 +128,22 @@ namespace game::world
         }
     }
 
-    Voxel& VoxelVolume::accessFromLocalPosition(Position localPosition)
+    template<std::int32_t E>
+    Voxel& BasicVoxelVolume<E>::accessFromLocalPosition(Position localPosition)
     {
         if (engine::getSettings()
                 .lookupSetting<engine::Setting::EnableAppValidation>())
         {
             util::assertFatal(
-                localPosition.x >= 0 && localPosition.x < VoxelVolume::Extent,
+                localPosition.x >= 0 && localPosition.x < Extent,
                 "X: {} is out of bounds!",
                 localPosition.x);
             util::assertFatal(
-                localPosition.y >= 0 && localPosition.y < VoxelVolume::Extent,
+                localPosition.y >= 0 && localPosition.y < Extent,
                 "Y: {} is out of bounds!",
                 localPosition.y);
             util::assertFatal(
-                localPosition.z >= 0 && localPosition.z < VoxelVolume::Extent,
+                localPosition.z >= 0 && localPosition.z < Extent,
                 "Z: {} is out of bounds!",
                 localPosition.z);
         }
@@ -141,12 +154,102 @@ namespace game::world
                             [static_cast<std::size_t>(localPosition.z)];
     }
 
-    void VoxelVolume::drawToVectors(
-        std::vector<gfx::recordables::FlatRecordable::Vertex>& outputVertices,
-        std::vector<gfx::recordables::FlatRecordable::Index>&  outputIndices,
-        Position                                               localOffset)
+    template<std::int32_t E>
+    Voxel
+    BasicVoxelVolume<E>::readFromLocalPosition(Position localPosition) const
     {
-        auto iterator = std::views::iota(0, static_cast<std::int32_t>(Extent));
+        // NOLINTNEXTLINE
+        return this->storage[static_cast<std::size_t>(localPosition.x)]
+                            [static_cast<std::size_t>(localPosition.y)]
+                            [static_cast<std::size_t>(localPosition.z)];
+    }
+
+    template<std::int32_t E>
+    std::span<const std::byte, BasicVoxelVolume<E>::Bytes>
+    BasicVoxelVolume<E>::getBytes() const
+    {
+        return std::as_bytes(std::span {this->storage});
+    }
+
+    namespace
+    {
+        struct CubeFace
+        {
+            // tangent x bitangent == normal, so walking the corners in the
+            // order of CornerSigns is counter clockwise seen from outside
+            Position normal;
+            Position tangent;
+            Position bitangent;
+        };
+
+        constexpr std::array<CubeFace, 6> CubeFaces {
+            CubeFace {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}},
+            CubeFace {{-1, 0, 0}, {0, 0, 1}, {0, 1, 0}},
+            CubeFace {{0, 1, 0}, {0, 0, 1}, {1, 0, 0}},
+            CubeFace {{0, -1, 0}, {1, 0, 0}, {0, 0, 1}},
+            CubeFace {{0, 0, 1}, {1, 0, 0}, {0, 1, 0}},
+            CubeFace {{0, 0, -1}, {0, 1, 0}, {1, 0, 0}},
+        };
+
+        struct CornerSign
+        {
+            std::int32_t tangent;
+            std::int32_t bitangent;
+        };
+
+        constexpr std::array<CornerSign, 4> CornerSigns {
+            CornerSign {-1, -1},
+            CornerSign {1, -1},
+            CornerSign {1, 1},
+            CornerSign {-1, 1},
+        };
+
+        // split along 0 -> 2
+        constexpr std::array<std::uint32_t, 6> QuadIndices {0, 1, 2, 0, 2, 3};
+        // split along 1 -> 3
+        constexpr std::array<std::uint32_t, 6> FlippedQuadIndices {
+            0, 1, 3, 1, 2, 3};
+
+        // Indexed by the number of unoccluded neighbors of a corner
+        constexpr std::array<float, 4> AmbientOcclusionBrightness {
+            0.5f, 0.7f, 0.85f, 1.0f};
+    } // namespace
+
+    template<std::int32_t BrickExtent, std::int32_t ChunkExtent>
+    void BasicSparseVoxelVolume<BrickExtent, ChunkExtent>::drawBrick(
+        std::vector<gfx::recordables::ChunkRecordable::Vertex>& outputVertices,
+        std::vector<gfx::recordables::ChunkRecordable::Index>&  outputIndices,
+        Position                                                brickMinimum,
+        const AllocatedBrick&                                   brick,
+        const LightVolume&                                      light,
+        AmbientOcclusion ambientOcclusion) const
+    {
+        std::int32_t visibleVoxels = brick.visible_voxels;
+
+        // [dx + 1][dy + 1][dz + 1], the 3x3x3 voxels centered on the one
+        // being meshed. Brightness is only looked up once it's needed, as
+        // most of these end up behind a hidden face
+        std::array<std::array<std::array<bool, 3>, 3>, 3>  isOpaque {};
+        std::array<std::array<std::array<float, 3>, 3>, 3> brightness {};
+        constexpr float UnsampledBrightness = -1.0f;
+
+        auto isInsideBrick = [](Position p)
+        {
+            return p.x >= 0 && p.x < BrickExtent && p.y >= 0
+                && p.y < BrickExtent && p.z >= 0 && p.z < BrickExtent;
+        };
+
+        auto isInsideParent = [](Position p)
+        {
+            auto isAxisInside = [](std::int32_t a)
+            {
+                return a >= VoxelMinimum && a <= VoxelMaximum;
+            };
+
+            return isAxisInside(p.x) && isAxisInside(p.y) && isAxisInside(p.z);
+        };
+
+        auto iterator = std::views::iota(0, BrickExtent);
 
         for (std::int32_t localX : iterator)
         {
@@ -154,241 +257,570 @@ namespace game::world
             {
                 for (std::int32_t localZ : iterator)
                 {
-                    const Voxel voxel = this->accessFromLocalPosition(
-                        Position {localX, localY, localZ});
+                    // Everything past the last visible voxel is empty
+                    if (visibleVoxels == 0)
+                    {
+                        return;
+                    }
+
+                    const Position local {localX, localY, localZ};
+                    const Voxel    voxel =
+                        brick.volume.readFromLocalPosition(local);
 
                     if (!voxel.shouldDraw())
                     {
                         continue;
                     }
 
-                    static constexpr std::
-                        array<gfx::recordables::FlatRecordable::Vertex, 8>
-                            cubeVertices {
-                                gfx::recordables::FlatRecordable::Vertex {
-                                    .color {0.0f, 0.0f, 0.0f, 1.0f},
-                                    .position {-1.0f, -1.0f, -1.0f},
-                                    .normal {},
-                                },
-                                gfx::recordables::FlatRecordable::Vertex {
-                                    .color {0.0f, 0.0f, 1.0f, 1.0f},
-                                    .position {-1.0f, -1.0f, 1.0f},
-                                    .normal {},
-                                },
-                                gfx::recordables::FlatRecordable::Vertex {
-                                    .color {0.0f, 1.0f, 0.0f, 1.0f},
-                                    .position {-1.0f, 1.0f, -1.0f},
-                                    .normal {},
-                                },
-                                gfx::recordables::FlatRecordable::Vertex {
-                                    .color {0.0f, 1.0f, 1.0f, 1.0f},
-                                    .position {-1.0f, 1.0f, 1.0f},
-                                    .normal {},
-                                },
-                                gfx::recordables::FlatRecordable::Vertex {
-                                    .color {1.0f, 0.0f, 0.0f, 1.0f},
-                                    .position {1.0f, -1.0f, -1.0f},
-                                    .normal {},
-                                },
-                                gfx::recordables::FlatRecordable::Vertex {
-                                    .color {1.0f, 0.0f, 1.0f, 1.0f},
-                                    .position {1.0f, -1.0f, 1.0f},
-                                    .normal {},
-                                },
-                                gfx::recordables::FlatRecordable::Vertex {
-                                    .color {1.0f, 1.0f, 0.0f, 1.0f},
-                                    .position {1.0f, 1.0f, -1.0f},
-                                    .normal {},
-                                },
-                                gfx::recordables::FlatRecordable::Vertex {
-                                    .color {1.0f, 1.0f, 1.0f, 1.0f},
-                                    .position {1.0f, 1.0f, 1.0f},
-                                    .normal {},
-                                },
-                            };
-
-                    constexpr std::
-                        array<gfx::recordables::FlatRecordable::Index, 36>
-                            cubeIndices {6, 2, 7, 2, 3, 7, 0, 4, 5, 1, 0, 5,
-                                         0, 2, 6, 4, 0, 6, 3, 1, 7, 1, 5, 7,
-                                         2, 0, 3, 0, 1, 3, 4, 6, 7, 5, 4, 7};
-
-                    const std::size_t IndicesOffset = outputVertices.size();
-
-                    // Update positions to be aligned with the world and insert
-                    // into output
-                    for (gfx::recordables::FlatRecordable::Vertex v :
-                         cubeVertices)
-                    {
-                        v.position /= 2.0f;
+                    visibleVoxels -= 1;
 
-                        v.position += static_cast<glm::vec3>(localOffset);
+                    // Relative to this volume's most negative voxel
+                    const Position fromMinimum =
+                        brickMinimum + local
+                        - Position {VoxelMinimum, VoxelMinimum, VoxelMinimum};
+                    const std::array<std::uint32_t, 3> packedPosition {
+                        static_cast<std::uint32_t>(fromMinimum.x),
+                        static_cast<std::uint32_t>(fromMinimum.y),
+                        static_cast<std::uint32_t>(fromMinimum.z)};
+                    const float alpha = voxel.getColor().a;
+
+                    for (std::int32_t dX : {-1, 0, 1})
+                    {
+                        for (std::int32_t dY : {-1, 0, 1})
+                        {
+                            for (std::int32_t dZ : {-1, 0, 1})
+                            {
+                                const Position neighbor =
+                                    local + Position {dX, dY, dZ};
+                                const Position inParent =
+                                    brickMinimum + neighbor;
 
-                        v.position += static_cast<glm::vec3>(
-                            Position {localX, localY, localZ});
+                                bool opaque = false;
 
-                        v.color *= voxel.getColor();
+                                if (isInsideBrick(neighbor))
+                                {
+                                    opaque = brick.volume
+                                                 .readFromLocalPosition(
+                                                     neighbor)
+                                                 .isOpaque();
+                                }
+                                else if (isInsideParent(inParent))
+                                {
+                                    opaque =
+                                        this->readFromLocalPosition(inParent)
+                                            .isOpaque();
+                                }
 
-                        outputVertices.push_back(v);
+                                // NOLINTBEGIN
+                                isOpaque[dX + 1][dY + 1][dZ + 1] = opaque;
+                                brightness[dX + 1][dY + 1][dZ + 1] =
+                                    UnsampledBrightness;
+                                // NOLINTEND
+                            }
+                        }
                     }
 
-                    // update indices to actually point to the correct index
-                    for (gfx::recordables::FlatRecordable::Index i :
-                         cubeIndices)
+                    auto sampleOpaque = [&](Position d) -> bool
                     {
-                        i += static_cast<std::uint32_t>(IndicesOffset);
+                        // NOLINTNEXTLINE
+                        return isOpaque[d.x + 1][d.y + 1][d.z + 1];
+                    };
+
+                    auto sampleBrightness = [&](Position d) -> float
+                    {
+                        // NOLINTNEXTLINE
+                        float& b = brightness[d.x + 1][d.y + 1][d.z + 1];
+
+                        if (b == UnsampledBrightness)
+                        {
+                            const Position inParent =
+                                brickMinimum + local + d;
+
+                            // Light doesn't cross volumes, so treat anything
+                            // outside of this one as open sky
+                            b = isInsideParent(inParent)
+                                  ? light.getBrightness(inParent)
+                                  : 1.0f;
+                        }
+
+                        return b;
+                    };
+
+                    for (std::uint32_t f = 0; f < CubeFaces.size(); ++f)
+                    {
+                        const CubeFace& face = CubeFaces[f]; // NOLINT
+
+                        // Hidden behind its neighbor
+                        if (sampleOpaque(face.normal))
+                        {
+                            continue;
+                        }
+
+                        std::array<float, 4> cornerBrightness {};
 
-                        outputIndices.push_back(i);
+                        const std::size_t firstVertex = outputVertices.size();
+
+                        for (std::size_t i = 0; i < 4; ++i)
+                        {
+                            const CornerSign sign = CornerSigns[i]; // NOLINT
+
+                            const Position side1 =
+                                face.normal + face.tangent * sign.tangent;
+                            const Position side2 =
+                                face.normal + face.bitangent * sign.bitangent;
+                            const Position corner = side1 + side2 - face.normal;
+
+                            // The three voxels touching this corner of the
+                            // face. If both sides are solid, the corner is
+                            // hidden, whatever the diagonal is
+                            std::int32_t occluders = 0;
+
+                            if (ambientOcclusion == AmbientOcclusion::Enabled)
+                            {
+                                occluders =
+                                    sampleOpaque(side1) && sampleOpaque(side2)
+                                        ? 3
+                                        : static_cast<std::int32_t>(
+                                              sampleOpaque(side1))
+                                              + static_cast<std::int32_t>(
+                                                  sampleOpaque(side2))
+                                              + static_cast<std::int32_t>(
+                                                  sampleOpaque(corner));
+                            }
+
+                            // Smooth lighting, the average of the open voxels
+                            // in front of this corner
+                            float        lightSum     = 0.0f;
+                            std::int32_t lightSamples = 0;
+
+                            for (Position sample :
+                                 {face.normal, side1, side2, corner})
+                            {
+                                if (!sampleOpaque(sample))
+                                {
+                                    lightSum += sampleBrightness(sample);
+                                    lightSamples += 1;
+                                }
+                            }
+
+                            cornerBrightness[i] = // NOLINT
+                                AmbientOcclusionBrightness[static_cast<
+                                    std::size_t>(3 - occluders)]
+                                * (lightSum
+                                   / static_cast<float>(lightSamples));
+
+                            outputVertices.push_back(
+                                gfx::recordables::ChunkRecordable::Vertex::pack(
+                                    {
+                                        .voxel {
+                                            packedPosition[0],
+                                            packedPosition[1],
+                                            packedPosition[2]},
+                                        .face {f},
+                                        .corner {
+                                            static_cast<std::uint32_t>(i)},
+                                        .srgb {
+                                            voxel.srgb_r,
+                                            voxel.srgb_g,
+                                            voxel.srgb_b},
+                                        .brightness {
+                                            cornerBrightness[i]}, // NOLINT
+                                        .alpha {alpha},
+                                    }));
+                        }
+
+                        // Split the quad along the brighter diagonal,
+                        // otherwise a single dark corner bleeds along the
+                        // other diagonal and the shading depends on the
+                        // quad's orientation
+                        const std::array<std::uint32_t, 6>& quadIndices =
+                            cornerBrightness[0] + cornerBrightness[2]
+                                    >= cornerBrightness[1]
+                                           + cornerBrightness[3]
+                                ? QuadIndices
+                                : FlippedQuadIndices;
+
+                        for (std::uint32_t i : quadIndices)
+                        {
+                            outputIndices.push_back(
+                                static_cast<std::uint32_t>(firstVertex) + i);
+                        }
                     }
                 }
             }
         }
     }
 
-    SparseVoxelVolume::SparseVoxelVolume()
-    {
-        // TODO: optimize!
-        for (auto& xArray : this->data)
-        {
-            for (auto& yArray : xArray)
-            {
-                for (auto& voxel : yArray)
-                {
-                    voxel = Voxel {};
-                }
-            }
-        }
-    }
+    template<std::int32_t BrickExtent, std::int32_t ChunkExtent>
+    BasicSparseVoxelVolume<BrickExtent, ChunkExtent>::BasicSparseVoxelVolume()
+        : pages {}
+    {}
 
-    Voxel& SparseVoxelVolume::accessFromLocalPosition(Position sparsePosition)
+    template<std::int32_t BrickExtent, std::int32_t ChunkExtent>
+    std::pair<Position, Position>
+    BasicSparseVoxelVolume<BrickExtent, ChunkExtent>::splitLocalPosition(
+        Position sparsePosition)
     {
         if (engine::getSettings()
                 .lookupSetting<engine::Setting::EnableAppValidation>())
         {
             util::assertFatal(
-                sparsePosition.x >= SparseVoxelVolume::VoxelMinimum
-                    && sparsePosition.x <= SparseVoxelVolume::VoxelMaximum,
+                sparsePosition.x >= VoxelMinimum
+                    && sparsePosition.x <= VoxelMaximum,
                 "X: {} is outside of {}->{}",
                 sparsePosition.x,
-                SparseVoxelVolume::VoxelMinimum,
-                SparseVoxelVolume::VoxelMaximum);
+                VoxelMinimum,
+                VoxelMaximum);
 
             util::assertFatal(
-                sparsePosition.y >= SparseVoxelVolume::VoxelMinimum
-                    && sparsePosition.y <= SparseVoxelVolume::VoxelMaximum,
+                sparsePosition.y >= VoxelMinimum
+                    && sparsePosition.y <= VoxelMaximum,
                 "Y: {} is outside of {}->{}",
                 sparsePosition.y,
-                SparseVoxelVolume::VoxelMinimum,
-                SparseVoxelVolume::VoxelMaximum);
+                VoxelMinimum,
+                VoxelMaximum);
 
             util::assertFatal(
-                sparsePosition.z >= SparseVoxelVolume::VoxelMinimum
-                    && sparsePosition.z <= SparseVoxelVolume::VoxelMaximum,
+                sparsePosition.z >= VoxelMinimum
+                    && sparsePosition.z <= VoxelMaximum,
                 "Z: {} is outside of {}->{}",
                 sparsePosition.z,
-                SparseVoxelVolume::VoxelMinimum,
-                SparseVoxelVolume::VoxelMaximum);
+                VoxelMinimum,
+                VoxelMaximum);
         }
 
-        const Position LocalVolumePosition {
-            flooringDiv(sparsePosition.x, VoxelVolume::Extent)
-                + SparseVoxelVolume::Extent / 2,
-            flooringDiv(sparsePosition.y, VoxelVolume::Extent)
-                + SparseVoxelVolume::Extent / 2,
-            flooringDiv(sparsePosition.z, VoxelVolume::Extent)
-                + SparseVoxelVolume::Extent / 2,
-        };
+        return {
+            getBrickIndex(sparsePosition), getPositionInBrick(sparsePosition)};
+    }
 
-        const Position volumeInternalPosition {
-            cyclicMod(sparsePosition.x, VoxelVolume::Extent),
-            cyclicMod(sparsePosition.y, VoxelVolume::Extent),
-            cyclicMod(sparsePosition.z, VoxelVolume::Extent)};
+    namespace
+    {
+        // Whether the caller holds the only reference to this, in which case
+        // it may be written to. Nobody can start sharing it concurrently, as
+        // every other reference is made by copying one the caller owns
+        template<class T>
+        bool isExclusive(const std::shared_ptr<T>& ptr)
+        {
+            if (ptr.use_count() != 1)
+            {
+                return false;
+            }
 
-        std::variant<std::unique_ptr<VoxelVolume>, Voxel>& maybeLocalVolume {
-            this->data // NOLINT
-                [static_cast<std::size_t>(LocalVolumePosition.x)]
-                [static_cast<std::size_t>(LocalVolumePosition.y)]
-                [static_cast<std::size_t>(LocalVolumePosition.z)]};
+            // Pairs with the release of the last other reference, so that
+            // its reads happen before any of the caller's writes
+            std::atomic_thread_fence(std::memory_order_acquire);
 
-        // If the volume doesn't exist then create it
-        if (Voxel* voxel = std::get_if<Voxel>(&maybeLocalVolume))
+            return true;
+        }
+    } // namespace
+
+    template<std::int32_t BrickExtent, std::int32_t ChunkExtent>
+    Voxel
+    BasicSparseVoxelVolume<BrickExtent, ChunkExtent>::writeToLocalPosition(
+        Position sparsePosition, Voxel voxel)
+    {
+        const auto [brickIndex, volumeInternalPosition] =
+            splitLocalPosition(sparsePosition);
+
+        const Voxel previous = this->readFromLocalPosition(sparsePosition);
+
+        // Nothing but the alpha of an invisible voxel is meaningful, so
+        // this also keeps empty writes from allocating or copying anything
+        if (previous == voxel
+            || (!previous.shouldDraw() && !voxel.shouldDraw()))
+        {
+            return previous;
+        }
+
+        std::shared_ptr<Page>& page = this->getPage(brickIndex);
+
+        if (page == nullptr)
+        {
+            page = std::make_shared<Page>();
+        }
+        else if (!isExclusive(page))
+        {
+            page = std::make_shared<Page>(*page);
+        }
+
+        std::shared_ptr<AllocatedBrick>& brick =
+            page->bricks // NOLINT
+                [static_cast<std::size_t>(brickIndex.x & (PageExtent - 1))]
+                [static_cast<std::size_t>(brickIndex.y & (PageExtent - 1))]
+                [static_cast<std::size_t>(brickIndex.z & (PageExtent - 1))];
+
+        if (brick == nullptr)
+        {
+            brick = std::make_shared<AllocatedBrick>();
+
+            page->allocated_bricks += 1;
+        }
+        else if (!isExclusive(brick))
         {
-            maybeLocalVolume = std::make_unique<VoxelVolume>(*voxel);
+            brick = std::make_shared<AllocatedBrick>(*brick);
         }
 
-        return (*std::get_if<std::unique_ptr<VoxelVolume>>(&maybeLocalVolume))
-            ->accessFromLocalPosition(volumeInternalPosition);
+        brick->volume.accessFromLocalPosition(volumeInternalPosition) = voxel;
+
+        if (voxel.shouldDraw() && !previous.shouldDraw())
+        {
+            brick->visible_voxels += 1;
+        }
+        else if (!voxel.shouldDraw() && previous.shouldDraw())
+        {
+            brick->visible_voxels -= 1;
+        }
+
+        if (brick->visible_voxels == 0)
+        {
+            brick.reset();
+
+            page->allocated_bricks -= 1;
+
+            if (page->allocated_bricks == 0)
+            {
+                page.reset();
+            }
+        }
+
+        return previous;
     }
 
+    template<std::int32_t BrickExtent, std::int32_t ChunkExtent>
+    Voxel
+    BasicSparseVoxelVolume<BrickExtent, ChunkExtent>::readFromLocalPosition(
+        Position sparsePosition) const
+    {
+        const auto [brickIndex, volumeInternalPosition] =
+            splitLocalPosition(sparsePosition);
+
+        const AllocatedBrick* brick = this->getBrick(brickIndex);
+
+        if (brick == nullptr)
+        {
+            return Voxel {};
+        }
+
+        return brick->volume.readFromLocalPosition(volumeInternalPosition);
+    }
+
+    template<std::int32_t BrickExtent, std::int32_t ChunkExtent>
+    std::optional<Voxel>
+    BasicSparseVoxelVolume<BrickExtent, ChunkExtent>::readUniformBrick(
+        Position sparsePosition) const
+    {
+        if (this->getBrick(splitLocalPosition(sparsePosition).first)
+            == nullptr)
+        {
+            return Voxel {};
+        }
+
+        return std::nullopt;
+    }
+
+    template<std::int32_t BrickExtent, std::int32_t ChunkExtent>
+    const typename BasicSparseVoxelVolume<BrickExtent, ChunkExtent>::Brick*
+    BasicSparseVoxelVolume<BrickExtent, ChunkExtent>::readBrick(
+        Position sparsePosition) const
+    {
+        const AllocatedBrick* brick =
+            this->getBrick(splitLocalPosition(sparsePosition).first);
+
+        return brick == nullptr ? nullptr : &brick->volume;
+    }
+
+    template<std::int32_t BrickExtent, std::int32_t ChunkExtent>
+    std::int32_t
+    BasicSparseVoxelVolume<BrickExtent, ChunkExtent>::getVisibleVoxelCount(
+        Position sparsePosition) const
+    {
+        const AllocatedBrick* brick =
+            this->getBrick(splitLocalPosition(sparsePosition).first);
+
+        return brick == nullptr ? 0 : brick->visible_voxels;
+    }
+
+    template<std::int32_t BrickExtent, std::int32_t ChunkExtent>
     std::pair<
-        std::vector<gfx::recordables::FlatRecordable::Vertex>,
-        std::vector<gfx::recordables::FlatRecordable::Index>>
-    SparseVoxelVolume::draw(Position localOffset)
+        std::vector<gfx::recordables::ChunkRecordable::Vertex>,
+        std::vector<gfx::recordables::ChunkRecordable::Index>>
+    BasicSparseVoxelVolume<BrickExtent, ChunkExtent>::draw(
+        const LightVolume& light, AmbientOcclusion ambientOcclusion) const
     {
-        std::vector<gfx::recordables::FlatRecordable::Vertex> vertices;
+        std::vector<gfx::recordables::ChunkRecordable::Vertex> vertices;
         vertices.reserve(3'000'000);
-        std::vector<gfx::recordables::FlatRecordable::Index> indices;
-        vertices.reserve(9'000'000);
-        // for (std::size_t x = 0; x < SparseVoxelVolume) }
+        std::vector<gfx::recordables::ChunkRecordable::Index> indices;
+        indices.reserve(9'000'000);
+
+        this->visitAllocatedBricks(
+            [&](Position brickMinimum, const AllocatedBrick& brick)
+            {
+                this->drawBrick(
+                    vertices,
+                    indices,
+                    brickMinimum,
+                    brick,
+                    light,
+                    ambientOcclusion);
+            });
 
-        for (std::size_t xIdx = 0; xIdx < this->data.size(); ++xIdx)
+        // vertices.shrink_to_fit();
+        // indices.shrink_to_fit();
+
+        return std::make_pair(std::move(vertices), std::move(indices));
+    }
+
+    template<std::int32_t BrickExtent, std::int32_t ChunkExtent>
+    std::vector<gfx::recordables::VoxelRecordable::Instance>
+    BasicSparseVoxelVolume<BrickExtent, ChunkExtent>::drawInstances(
+        const LightVolume& light) const
+    {
+        std::vector<gfx::recordables::VoxelRecordable::Instance> instances;
+
+        auto isInsideParent = [](Position p)
         {
-            for (std::size_t yIdx = 0; yIdx < this->data[xIdx].size(); ++yIdx)
+            auto isAxisInside = [](std::int32_t a)
             {
-                for (std::size_t zIdx = 0; zIdx < this->data[xIdx][yIdx].size();
-                     ++zIdx)
+                return a >= VoxelMinimum && a <= VoxelMaximum;
+            };
+
+            return isAxisInside(p.x) && isAxisInside(p.y) && isAxisInside(p.z);
+        };
+
+        auto iterator = std::views::iota(0, BrickExtent);
+
+        // Nothing past the brick's last visible voxel is visited
+        auto drawBrickInstances =
+            [&](Position brickMinimum, const AllocatedBrick& brick)
+        {
+            std::int32_t visibleVoxels = brick.visible_voxels;
+
+            for (std::int32_t localX : iterator)
+            {
+                for (std::int32_t localY : iterator)
                 {
-                    auto& voxel = this->data[xIdx][yIdx][zIdx];
+                    for (std::int32_t localZ : iterator)
+                    {
+                        if (visibleVoxels == 0)
+                        {
+                            return;
+                        }
+
+                        const Position local {localX, localY, localZ};
+                        const Voxel    voxel =
+                            brick.volume.readFromLocalPosition(local);
+
+                        if (!voxel.shouldDraw())
+                        {
+                            continue;
+                        }
+
+                        visibleVoxels -= 1;
+
+                        const Position inParent = brickMinimum + local;
+
+                        // Lit by the open voxels next to it, those are also
+                        // the faces that can be seen
+                        float        lightSum     = 0.0f;
+                        std::int32_t lightSamples = 0;
+
+                        for (const CubeFace& face : CubeFaces)
+                        {
+                            const Position neighbor = inParent + face.normal;
 
-                    std::visit(
-                        util::VariantHelper {
-                            [&](const std::unique_ptr<VoxelVolume>& volume)
+                            if (!isInsideParent(neighbor))
                             {
-                                const Position LocalVolumeOffset {
-                                    localOffset
-                                    + Position {
-                                        (static_cast<std::int32_t>(xIdx)
-                                         - static_cast<std::int32_t>(
-                                               SparseVoxelVolume::Extent)
-                                               / 2)
-                                            * static_cast<std::int32_t>(
-                                                VoxelVolume::Extent),
-                                        (static_cast<std::int32_t>(yIdx)
-                                         - static_cast<std::int32_t>(
-                                               SparseVoxelVolume::Extent)
-                                               / 2)
-                                            * static_cast<std::int32_t>(
-                                                VoxelVolume::Extent),
-                                        (static_cast<std::int32_t>(zIdx)
-                                         - static_cast<std::int32_t>(
-                                               SparseVoxelVolume::Extent)
-                                               / 2)
-                                            * static_cast<std::int32_t>(
-                                                VoxelVolume::Extent),
-                                    }};
-
-                                volume->drawToVectors(
-                                    vertices, indices, LocalVolumeOffset);
-                            },
-                            [](Voxel v) -> void
+                                lightSum += 1.0f;
+                                lightSamples += 1;
+                            }
+                            else if (!this->readFromLocalPosition(neighbor)
+                                          .isOpaque())
                             {
-                                if (v.shouldDraw())
-                                {
-                                    util::logTrace(
-                                        "TODO: implement {}",
-                                        glm::to_string(v.getColor()));
-                                }
-
-                                return;
-                            }},
-                        voxel);
+                                lightSum += light.getBrightness(neighbor);
+                                lightSamples += 1;
+                            }
+                        }
+
+                        if (lightSamples == 0)
+                        {
+                            continue;
+                        }
+
+                        const Position fromMinimum =
+                            inParent
+                            - Position {
+                                VoxelMinimum, VoxelMinimum, VoxelMinimum};
+
+                        instances.push_back(
+                            gfx::recordables::VoxelRecordable::Instance::pack({
+                                .voxel {
+                                    static_cast<std::uint32_t>(fromMinimum.x),
+                                    static_cast<std::uint32_t>(fromMinimum.y),
+                                    static_cast<std::uint32_t>(fromMinimum.z)},
+                                .srgb {
+                                    voxel.srgb_r, voxel.srgb_g, voxel.srgb_b},
+                                .brightness {
+                                    lightSum
+                                    / static_cast<float>(lightSamples)},
+                                .alpha {voxel.getColor().a},
+                            }));
+                    }
                 }
             }
-        }
+        };
 
-        // vertices.shrink_to_fit();
-        // indices.shrink_to_fit();
+        this->visitAllocatedBricks(drawBrickInstances);
 
-        return std::make_pair(std::move(vertices), std::move(indices));
+        return instances;
     }
+
+    template<std::int32_t BrickExtent, std::int32_t ChunkExtent>
+    std::shared_ptr<const BasicSparseVoxelVolume<BrickExtent, ChunkExtent>>
+    BasicSparseVoxelVolume<BrickExtent, ChunkExtent>::snapshot() const
+    {
+        std::shared_ptr<BasicSparseVoxelVolume> snapshot =
+            std::make_shared<BasicSparseVoxelVolume>();
+
+        snapshot->pages = this->pages;
+
+        return snapshot;
+    }
+
+    template<std::int32_t BrickExtent, std::int32_t ChunkExtent>
+    auto BasicSparseVoxelVolume<BrickExtent, ChunkExtent>::getPage(
+        Position brickIndex) -> std::shared_ptr<Page>&
+    {
+        return this->pages // NOLINT
+            [static_cast<std::size_t>(brickIndex.x >> PageShift)]
+            [static_cast<std::size_t>(brickIndex.y >> PageShift)]
+            [static_cast<std::size_t>(brickIndex.z >> PageShift)];
+    }
+
+    template<std::int32_t BrickExtent, std::int32_t ChunkExtent>
+    auto BasicSparseVoxelVolume<BrickExtent, ChunkExtent>::getBrick(
+        Position brickIndex) const -> const AllocatedBrick*
+    {
+        const std::shared_ptr<Page>& page =
+            this->pages // NOLINT
+                [static_cast<std::size_t>(brickIndex.x >> PageShift)]
+                [static_cast<std::size_t>(brickIndex.y >> PageShift)]
+                [static_cast<std::size_t>(brickIndex.z >> PageShift)];
+
+        if (page == nullptr)
+        {
+            return nullptr;
+        }
+
+        return page
+            ->bricks // NOLINT
+                [static_cast<std::size_t>(brickIndex.x & (PageExtent - 1))]
+                [static_cast<std::size_t>(brickIndex.y & (PageExtent - 1))]
+                [static_cast<std::size_t>(brickIndex.z & (PageExtent - 1))]
+            .get();
+    }
+
+    template struct BasicVoxelVolume<VERDIGRIS_BRICK_EXTENT>;
+    template class BasicSparseVoxelVolume<
+        VERDIGRIS_BRICK_EXTENT,
+        VERDIGRIS_CHUNK_EXTENT>;
 } // namespace game::world
@@ -1,20 +1,30 @@
 #ifndef SRC_GAME_WORLD_SPARSE_VOLUME_HPP
 #define SRC_GAME_WORLD_SPARSE_VOLUME_HPP
 
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <compare>
+#include <concepts>
 #include <cstdint>
-#include <gfx/recordables/flat_recordable.hpp>
+#include <gfx/recordables/chunk_recordable.hpp>
+#include <gfx/recordables/voxel_recordable.hpp>
 #include <gfx/vulkan/gpu_structures.hpp>
 #include <glm/fwd.hpp>
+#include <limits>
 #include <memory>
+#include <optional>
+#include <span>
 #include <string>
+#include <type_traits>
 #include <util/misc.hpp>
-#include <variant>
 #include <vector>
+#include <volume_extents.h>
 
 namespace game::world
 {
+    class LightVolume;
+
     struct Position
     {
         std::int32_t x;
@@ -24,6 +34,7 @@ namespace game::world
         Position             operator- () const;
         Position             operator- (Position other) const;
         Position             operator+ (Position other) const;
+        Position             operator* (std::int32_t) const;
         Position             operator/ (std::int32_t) const;
         bool                 operator== (const Position&) const  = default;
         std::strong_ordering operator<=> (const Position&) const = default;
@@ -32,88 +43,432 @@ namespace game::world
         explicit operator std::string () const;
     };
 
+    /// Byte for byte the Voxel in shaders/include/voxel.glsl, so bricks of
+    /// these can be copied straight into a std430 buffer
     struct Voxel
     {
-        std::uint8_t r;
-        std::uint8_t g;
-        std::uint8_t b;
-        std::uint8_t a;
-
-        [[nodiscard]] bool      shouldDraw() const;
-        [[nodiscard]] glm::vec4 getColor() const;
-        explicit                operator std::string () const;
+        static constexpr std::uint8_t OpaqueAlpha {128};
+
+        /// 0          - Invisible
+        /// [1, 127]   - Translucent
+        /// 128        - Opaque
+        /// [129, 255] - Emissive
+        std::uint8_t alpha_or_emissive;
+
+        std::uint8_t srgb_r;
+        std::uint8_t srgb_g;
+        std::uint8_t srgb_b;
+
+        /// 0 - nothing special
+        /// 1 - anisotropic?
+        /// [2, 255] UB
+        std::uint8_t special;
+        std::uint8_t specular;
+        std::uint8_t roughness;
+        std::uint8_t metallic;
+
+        [[nodiscard]] bool         shouldDraw() const;
+        [[nodiscard]] bool         isOpaque() const;
+        // The block light level this voxel emits, [0, 15]
+        [[nodiscard]] std::uint8_t getEmission() const;
+        [[nodiscard]] glm::vec4    getColor() const;
+        explicit                   operator std::string () const;
+
+        bool operator== (const Voxel&) const = default;
     };
 
-    struct VoxelVolume
+    static_assert(sizeof(Voxel) == sizeof(std::uint64_t));
+    static_assert(alignof(Voxel) == 1);
+    static_assert(std::is_trivially_copyable_v<Voxel>);
+    static_assert(std::has_unique_object_representations_v<Voxel>);
+    static_assert(
+        std::bit_cast<std::array<std::uint8_t, sizeof(Voxel)>>(
+            Voxel {1, 2, 3, 4, 5, 6, 7, 8})
+        == std::array<std::uint8_t, sizeof(Voxel)> {1, 2, 3, 4, 5, 6, 7, 8});
+
+    /// A VoxelBrick from voxel_brick_def.glsl as laid out in a std430
+    /// buffer, worked out from the std430 rules rather than from Voxel so
+    /// that the two can be checked against each other.
+    ///
+    /// Every member of the GLSL Voxel is a uint8_t, base alignment 1, so the
+    /// struct's alignment is 1 and its members sit at offsets 0 through 7 in
+    /// declaration order. An array's stride is its element's size rounded up
+    /// to the element's alignment, 8. std140 would round that up to 16,
+    /// which is why bricks can't be put in a std140 block
+    namespace std430
     {
-        static constexpr std::int32_t Extent {8};
+        // The GLSL Voxel's members, in declaration order
+        inline constexpr std::array<std::uint8_t Voxel::*, 8> VoxelMembers {
+            &Voxel::alpha_or_emissive,
+            &Voxel::srgb_r,
+            &Voxel::srgb_g,
+            &Voxel::srgb_b,
+            &Voxel::special,
+            &Voxel::specular,
+            &Voxel::roughness,
+            &Voxel::metallic,
+        };
+
+        inline constexpr std::size_t VoxelStride {VoxelMembers.size()};
+
+        // Where member `member` of VoxelBrick.voxels[x][y][z] is, for bricks
+        // `extent` voxels on a side
+        constexpr std::size_t getVoxelMemberOffset(
+            std::size_t extent,
+            std::size_t x,
+            std::size_t y,
+            std::size_t z,
+            std::size_t member)
+        {
+            return ((((x * extent) + y) * extent) + z) * VoxelStride + member;
+        }
+
+        // Copies a brick of E^3 voxels into a std430 buffer and back, true if
+        // every member landed at its std430 offset and came back unchanged
+        template<std::int32_t E>
+        consteval bool doesBrickRoundTrip()
+        {
+            constexpr std::size_t Extent {static_cast<std::size_t>(E)};
+
+            using Brick  = util::CubicArray<Voxel, Extent>;
+            using Buffer = std::array<
+                std::uint8_t,
+                Extent * Extent * Extent * VoxelStride>;
+
+            auto getByte = [](std::size_t x,
+                              std::size_t y,
+                              std::size_t z,
+                              std::size_t member)
+            {
+                return static_cast<std::uint8_t>(
+                    (x * 131) + (y * 37) + (z * 11) + (member * 3) + 1);
+            };
+
+            Brick brick {};
+
+            for (std::size_t x = 0; x < Extent; ++x)
+            {
+                for (std::size_t y = 0; y < Extent; ++y)
+                {
+                    for (std::size_t z = 0; z < Extent; ++z)
+                    {
+                        for (std::size_t m = 0; m < VoxelStride; ++m)
+                        {
+                            brick[x][y][z].*VoxelMembers[m] = // NOLINT
+                                getByte(x, y, z, m);
+                        }
+                    }
+                }
+            }
+
+            const Buffer buffer = std::bit_cast<Buffer>(brick);
+
+            for (std::size_t x = 0; x < Extent; ++x)
+            {
+                for (std::size_t y = 0; y < Extent; ++y)
+                {
+                    for (std::size_t z = 0; z < Extent; ++z)
+                    {
+                        for (std::size_t m = 0; m < VoxelStride; ++m)
+                        {
+                            if (buffer[getVoxelMemberOffset( // NOLINT
+                                    Extent, x, y, z, m)]
+                                != getByte(x, y, z, m))
+                            {
+                                return false;
+                            }
+                        }
+                    }
+                }
+            }
+
+            return std::bit_cast<Brick>(buffer) == brick;
+        }
+    } // namespace std430
+
+    /// A dense cube of voxels, laid out like a VoxelBrick in
+    /// voxel_brick_def.glsl
+    template<std::int32_t E>
+    struct BasicVoxelVolume
+    {
+        static_assert(
+            E > 0 && std::has_single_bit(static_cast<std::uint32_t>(E)));
+
+        static constexpr std::int32_t Extent {E};
         static constexpr std::int32_t Minimum {0};
         static constexpr std::int32_t Maximum {Extent - 1};
+        static constexpr std::size_t  Bytes {
+            static_cast<std::size_t>(Extent * Extent * Extent) * sizeof(Voxel)};
 
-        VoxelVolume();
-        VoxelVolume(Voxel fillVoxel);
+        BasicVoxelVolume();
+        BasicVoxelVolume(Voxel fillVoxel);
 
         Voxel& accessFromLocalPosition(Position localPosition);
+        [[nodiscard]] Voxel readFromLocalPosition(Position localPosition) const;
 
-        void drawToVectors(
-            std::vector<gfx::recordables::FlatRecordable::Vertex>&,
-            std::vector<gfx::recordables::FlatRecordable::Index>&,
-            Position localOffset);
+        [[nodiscard]] std::span<const std::byte, Bytes> getBytes() const;
 
     private:
-        std::array<std::array<std::array<Voxel, Extent>, Extent>, Extent>
-            storage;
+        util::CubicArray<Voxel, static_cast<std::size_t>(Extent)> storage;
+    };
+
+    // Whether meshing darkens the corners of faces next to opaque voxels
+    enum class AmbientOcclusion : bool
+    {
+        Disabled,
+        Enabled,
     };
 
-    class SparseVoxelVolume
+    /// A cube of ChunkExtent^3 bricks, centered on the origin, where only
+    /// the bricks with something visible in them are allocated.
+    ///
+    /// Bricks, and the pages of the brick table that point to them, are
+    /// shared with snapshots and copied on write. Taking a snapshot only
+    /// copies the page table, after which the first write to each page and
+    /// brick copies just that page and brick.
+    template<std::int32_t BrickExtent, std::int32_t ChunkExtent>
+    class BasicSparseVoxelVolume
     {
+        static_assert(
+            ChunkExtent > 1
+            && std::has_single_bit(static_cast<std::uint32_t>(ChunkExtent)));
     public:
-        static constexpr std::int32_t Extent {64}; // TODO: make int32_t pls
+        using Brick = BasicVoxelVolume<BrickExtent>;
+
+        static constexpr std::int32_t Extent {ChunkExtent};
 
-        static constexpr std::int32_t Minimum {
-            -static_cast<std::int32_t>(Extent / 2)};
+        static constexpr std::int32_t Minimum {-(Extent / 2)};
 
-        static constexpr std::int32_t Maximum {
-            static_cast<std::int32_t>(Extent / 2) - 1};
+        static constexpr std::int32_t Maximum {(Extent / 2) - 1};
 
-        static constexpr std::int32_t VoxelMinimum {
-            Minimum * VoxelVolume::Extent};
+        static constexpr std::int32_t VoxelMinimum {Minimum * BrickExtent};
 
         static constexpr std::int32_t VoxelMaximum {
-            (Maximum + 1) * VoxelVolume::Extent - 1};
+            (Maximum + 1) * BrickExtent - 1};
+
+        static constexpr std::int32_t VoxelExtent {Extent * BrickExtent};
 
-        static constexpr std::int32_t VoxelExtent {
-            Extent * VoxelVolume::Extent};
+        // The brick that contains this position, in [0, Extent). Positions
+        // are floored, so this is a shift as the extents are powers of two
+        [[nodiscard]] static constexpr Position
+        getBrickIndex(Position localPosition)
+        {
+            return Position {
+                (localPosition.x >> BrickShift) - Minimum,
+                (localPosition.y >> BrickShift) - Minimum,
+                (localPosition.z >> BrickShift) - Minimum};
+        }
 
-        // Initalized with empty Voxels
-        explicit SparseVoxelVolume();
-        ~SparseVoxelVolume() = default;
+        // The position within the brick that contains this position
+        [[nodiscard]] static constexpr Position
+        getPositionInBrick(Position localPosition)
+        {
+            return Position {
+                localPosition.x & (BrickExtent - 1),
+                localPosition.y & (BrickExtent - 1),
+                localPosition.z & (BrickExtent - 1)};
+        }
 
-        SparseVoxelVolume(const SparseVoxelVolume&)             = delete;
-        SparseVoxelVolume(SparseVoxelVolume&&)                  = delete;
-        SparseVoxelVolume& operator= (const SparseVoxelVolume&) = delete;
-        SparseVoxelVolume& operator= (SparseVoxelVolume&&)      = delete;
+        // Initalized with empty Voxels, bricks are only allocated while they
+        // have a visible voxel in them
+        explicit BasicSparseVoxelVolume();
+        ~BasicSparseVoxelVolume() = default;
+
+        BasicSparseVoxelVolume(const BasicSparseVoxelVolume&) = delete;
+        BasicSparseVoxelVolume(BasicSparseVoxelVolume&&)      = delete;
+        BasicSparseVoxelVolume&
+        operator= (const BasicSparseVoxelVolume&) = delete;
+        BasicSparseVoxelVolume& operator= (BasicSparseVoxelVolume&&) = delete;
 
         void populateVoxelsFromHeightFunction(
             util::Fn<std::int32_t>(std::int32_t, std::int32_t));
-        Voxel& accessFromLocalPosition(Position localPosition);
+        // Returns the voxel that was there before
+        Voxel writeToLocalPosition(Position localPosition, Voxel);
+        // Never allocates a brick
+        [[nodiscard]] Voxel readFromLocalPosition(Position localPosition) const;
+        // The voxel the brick containing this position is filled with, if
+        // that brick hasn't been allocated
+        [[nodiscard]] std::optional<Voxel>
+        readUniformBrick(Position localPosition) const;
+        // The brick containing this position, nullptr if it hasn't been
+        // allocated, in which case readUniformBrick has its voxel
+        [[nodiscard]] const Brick* readBrick(Position localPosition) const;
+
+        // Calls func with the minimum position of every allocated brick,
+        // without allocating, so that it's cheap to walk on every relight
+        void visitOccupiedBricks(std::invocable<Position> auto func) const
+        {
+            this->visitAllocatedBricks(
+                [&](Position brickMinimum, const AllocatedBrick&)
+                {
+                    func(brickMinimum);
+                });
+        }
+        [[nodiscard]] std::int32_t
+        getVisibleVoxelCount(Position localPosition) const;
 
+        // Vertex colors are lit by the given light, which must belong to this.
+        // Vertices are relative to this volume, see ChunkRecordable::Vertex
         [[nodiscard]] std::pair<
-            std::vector<gfx::recordables::FlatRecordable::Vertex>,
-            std::vector<gfx::recordables::FlatRecordable::Index>>
-        draw(Position offset);
+            std::vector<gfx::recordables::ChunkRecordable::Vertex>,
+            std::vector<gfx::recordables::ChunkRecordable::Index>>
+        draw(
+            const LightVolume&,
+            AmbientOcclusion = AmbientOcclusion::Enabled) const;
+        // The alternative to draw(), every voxel with an open neighbor as a
+        // cube lit by the light of those neighbors
+        [[nodiscard]] std::vector<gfx::recordables::VoxelRecordable::Instance>
+        drawInstances(const LightVolume&) const;
+
+        // An immutable view of this volume as it is now, which is safe to
+        // read from any thread while this keeps being written to. Must be
+        // called by whoever writes to this
+        [[nodiscard]] std::shared_ptr<const BasicSparseVoxelVolume>
+        snapshot() const;
+
     private:
-        //   TODO: change to be contigious!
-        std::array<
-            std::array<
-                std::array<
-                    std::variant<std::unique_ptr<VoxelVolume>, Voxel>,
-                    Extent>,
-                Extent>,
-            Extent>
-            data;
+        static constexpr std::int32_t BrickShift {
+            std::countr_zero(static_cast<std::uint32_t>(BrickExtent))};
+
+        // Bricks per axis of a page of the brick table
+        static constexpr std::int32_t PageExtent {std::min(Extent, 8)};
+        static constexpr std::int32_t PageShift {
+            std::countr_zero(static_cast<std::uint32_t>(PageExtent))};
+        static constexpr std::int32_t PagesPerAxis {Extent / PageExtent};
+
+        struct AllocatedBrick
+        {
+            Brick         volume;
+            std::uint16_t visible_voxels;
+        };
+
+        struct Page
+        {
+            util::CubicArray<
+                std::shared_ptr<AllocatedBrick>,
+                static_cast<std::size_t>(PageExtent)>
+                          bricks;
+            std::uint32_t allocated_bricks;
+        };
+
+        static_assert(
+            Brick::Extent * Brick::Extent * Brick::Extent
+            <= std::numeric_limits<std::uint16_t>::max());
+
+        // Every voxel must be addressable by a packed chunk vertex or
+        // instance, cmakelists.txt rejects extents past this up front
+        static_assert(VoxelExtent <= gfx::recordables::MaxPackedVoxelExtent);
+
+        // Validates the position and splits it into the position of the brick
+        // that it's in and the position within that brick
+        static std::pair<Position, Position> splitLocalPosition(Position);
+
+        std::shared_ptr<Page>& getPage(Position brickIndex);
+        // nullptr if it isn't allocated
+        const AllocatedBrick*  getBrick(Position brickIndex) const;
+
+        // Unallocated pages are skipped whole
+        void visitAllocatedBricks(
+            std::invocable<Position, const AllocatedBrick&> auto func) const
+        {
+            for (std::int32_t pX = 0; pX < PagesPerAxis; ++pX)
+            {
+                for (std::int32_t pY = 0; pY < PagesPerAxis; ++pY)
+                {
+                    for (std::int32_t pZ = 0; pZ < PagesPerAxis; ++pZ)
+                    {
+                        const Page* page =
+                            this->pages // NOLINT
+                                [static_cast<std::size_t>(pX)]
+                                [static_cast<std::size_t>(pY)]
+                                [static_cast<std::size_t>(pZ)]
+                                    .get();
+
+                        if (page == nullptr)
+                        {
+                            continue;
+                        }
+
+                        this->visitPage(Position {pX, pY, pZ}, *page, func);
+                    }
+                }
+            }
+        }
+
+        void visitPage(
+            Position    pageIndex,
+            const Page& page,
+            std::invocable<Position, const AllocatedBrick&> auto& func) const
+        {
+            for (std::int32_t x = 0; x < PageExtent; ++x)
+            {
+                for (std::int32_t y = 0; y < PageExtent; ++y)
+                {
+                    for (std::int32_t z = 0; z < PageExtent; ++z)
+                    {
+                        const AllocatedBrick* brick =
+                            page.bricks // NOLINT
+                                [static_cast<std::size_t>(x)]
+                                [static_cast<std::size_t>(y)]
+                                [static_cast<std::size_t>(z)]
+                                    .get();
+
+                        if (brick == nullptr)
+                        {
+                            continue;
+                        }
+
+                        const Position brickIndex =
+                            pageIndex * PageExtent + Position {x, y, z};
+
+                        func(
+                            (brickIndex + Position {Minimum, Minimum, Minimum})
+                                * BrickExtent,
+                            *brick);
+                    }
+                }
+            }
+        }
+
+        // Emits a quad for every face that isn't hidden by an opaque
+        // neighbor, with ambient occlusion and light baked into its vertex
+        // colors. Nothing past the brick's last visible voxel is visited
+        void drawBrick(
+            std::vector<gfx::recordables::ChunkRecordable::Vertex>&,
+            std::vector<gfx::recordables::ChunkRecordable::Index>&,
+            Position brickMinimum,
+            const AllocatedBrick&,
+            const LightVolume&,
+            AmbientOcclusion) const;
+
+        util::CubicArray<
+            std::shared_ptr<Page>,
+            static_cast<std::size_t>(PagesPerAxis)>
+            pages;
     };
 
+    // The extents the rest of the engine and the shaders are built with, see
+    // VERDIGRIS_BRICK_EXTENT and VERDIGRIS_CHUNK_EXTENT in cmakelists.txt
+    using VoxelVolume = BasicVoxelVolume<VERDIGRIS_BRICK_EXTENT>;
+    using SparseVoxelVolume =
+        BasicSparseVoxelVolume<VERDIGRIS_BRICK_EXTENT, VERDIGRIS_CHUNK_EXTENT>;
+
+    static_assert(sizeof(VoxelVolume) == VoxelVolume::Bytes);
+    static_assert(std::is_trivially_copyable_v<VoxelVolume>);
+    static_assert(std430::doesBrickRoundTrip<VoxelVolume::Extent>());
+
+    static_assert(
+        SparseVoxelVolume::getBrickIndex(Position {
+            SparseVoxelVolume::VoxelMinimum,
+            -1,
+            SparseVoxelVolume::VoxelMaximum})
+        == Position {
+            0, -SparseVoxelVolume::Minimum - 1, SparseVoxelVolume::Extent - 1});
+    static_assert(
+        SparseVoxelVolume::getPositionInBrick(Position {
+            SparseVoxelVolume::VoxelMinimum, -1, 0})
+        == Position {0, VoxelVolume::Extent - 1, 0});
+
     // array lmfao
 
 } // namespace game::world
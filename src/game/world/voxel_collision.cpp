@@ -0,0 +1,260 @@
+#include "voxel_collision.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <optional>
+#include <util/log.hpp>
+
+namespace game::world
+{
+    namespace
+    {
+        constexpr std::int32_t BrickExtent {VoxelVolume::Extent};
+
+        std::int32_t getBrickMinimum(std::int32_t voxel)
+        {
+            return voxel & ~(BrickExtent - 1);
+        }
+
+        std::int32_t getBrickMaximum(std::int32_t voxel)
+        {
+            return getBrickMinimum(voxel) + BrickExtent - 1;
+        }
+
+        std::int32_t floorToVoxel(float f)
+        {
+            return static_cast<std::int32_t>(std::floor(f));
+        }
+
+        std::int32_t ceilToVoxel(float f)
+        {
+            return static_cast<std::int32_t>(std::ceil(f));
+        }
+
+        Position makePosition(
+            glm::length_t axis,
+            std::int32_t  along,
+            std::int32_t  u,
+            std::int32_t  v)
+        {
+            glm::ivec3 components {};
+
+            components[axis]           = along;
+            components[(axis + 1) % 3] = u;
+            components[(axis + 2) % 3] = v;
+
+            return Position {components.x, components.y, components.z};
+        }
+    } // namespace
+
+    Aabb Aabb::operator+ (glm::vec3 offset) const
+    {
+        return Aabb {
+            .minimum {this->minimum + offset},
+            .maximum {this->maximum + offset}};
+    }
+
+    float sweepAxis(
+        const SparseVoxelVolume& volume,
+        const Aabb&              box,
+        glm::length_t            axis,
+        float                    distance)
+    {
+        if (distance == 0.0f)
+        {
+            return 0.0f;
+        }
+
+        const glm::length_t uAxis = (axis + 1) % 3;
+        const glm::length_t vAxis = (axis + 2) % 3;
+
+        // The voxels that the box overlaps on the other two axes
+        const std::int32_t uFirst = std::max(
+            floorToVoxel(box.minimum[uAxis] - 0.5f) + 1,
+            SparseVoxelVolume::VoxelMinimum);
+        const std::int32_t uLast = std::min(
+            ceilToVoxel(box.maximum[uAxis] + 0.5f) - 1,
+            SparseVoxelVolume::VoxelMaximum);
+        const std::int32_t vFirst = std::max(
+            floorToVoxel(box.minimum[vAxis] - 0.5f) + 1,
+            SparseVoxelVolume::VoxelMinimum);
+        const std::int32_t vLast = std::min(
+            ceilToVoxel(box.maximum[vAxis] + 0.5f) - 1,
+            SparseVoxelVolume::VoxelMaximum);
+
+        // The voxels ahead of the box that it could reach, nearest first
+        const std::int32_t step = distance > 0.0f ? 1 : -1;
+        std::int32_t       first {};
+        std::int32_t       last {};
+
+        if (step > 0)
+        {
+            first = std::max(
+                ceilToVoxel(box.maximum[axis] + 0.5f),
+                SparseVoxelVolume::VoxelMinimum);
+            last = std::min(
+                ceilToVoxel(box.maximum[axis] + distance + CollisionSkin + 0.5f)
+                    - 1,
+                SparseVoxelVolume::VoxelMaximum);
+        }
+        else
+        {
+            first = std::min(
+                floorToVoxel(box.minimum[axis] - 0.5f),
+                SparseVoxelVolume::VoxelMaximum);
+            last = std::max(
+                floorToVoxel(
+                    box.minimum[axis] + distance - CollisionSkin - 0.5f)
+                    + 1,
+                SparseVoxelVolume::VoxelMinimum);
+        }
+
+        if (uFirst > uLast || vFirst > vLast || step * (last - first) < 0)
+        {
+            return distance;
+        }
+
+        // One layer of bricks along the axis at a time, the first layer
+        // with a hit has the nearest one
+        std::int32_t layerEnd {};
+
+        for (std::int32_t layerStart = first; step * (last - layerStart) >= 0;
+             layerStart              = layerEnd + step)
+        {
+            layerEnd = step > 0
+                         ? std::min(getBrickMaximum(layerStart), last)
+                         : std::max(getBrickMinimum(layerStart), last);
+
+            std::optional<std::int32_t> nearest {};
+
+            // The nearest voxel within one allocated brick, if it's nearer
+            // than the nearest found so far
+            auto sweepBrick =
+                [&](const auto& brick, std::int32_t uStart, std::int32_t vStart)
+            {
+                const std::int32_t uEnd =
+                    std::min(getBrickMaximum(uStart), uLast);
+                const std::int32_t vEnd =
+                    std::min(getBrickMaximum(vStart), vLast);
+
+                for (std::int32_t a = layerStart;
+                     step * (layerEnd - a) >= 0
+                     && (!nearest.has_value() || step * (*nearest - a) > 0);
+                     a += step)
+                {
+                    for (std::int32_t u = uStart; u <= uEnd; ++u)
+                    {
+                        for (std::int32_t v = vStart; v <= vEnd; ++v)
+                        {
+                            if (brick
+                                    .readFromLocalPosition(
+                                        SparseVoxelVolume::getPositionInBrick(
+                                            makePosition(axis, a, u, v)))
+                                    .shouldDraw())
+                            {
+                                nearest = a;
+
+                                return;
+                            }
+                        }
+                    }
+                }
+            };
+
+            for (std::int32_t uStart = uFirst; uStart <= uLast;
+                 uStart              = getBrickMaximum(uStart) + 1)
+            {
+                for (std::int32_t vStart = vFirst; vStart <= vLast;
+                     vStart              = getBrickMaximum(vStart) + 1)
+                {
+                    const auto* brick = volume.readBrick(
+                        makePosition(axis, layerStart, uStart, vStart));
+
+                    // Unallocated bricks are empty
+                    if (brick != nullptr)
+                    {
+                        sweepBrick(*brick, uStart, vStart);
+                    }
+                }
+            }
+
+            if (nearest.has_value())
+            {
+                const float face = static_cast<float>(*nearest)
+                                 - (static_cast<float>(step) * 0.5f);
+
+                return step > 0 ? std::clamp(
+                                      face - box.maximum[axis] - CollisionSkin,
+                                      0.0f,
+                                      distance)
+                                : std::clamp(
+                                      face - box.minimum[axis] + CollisionSkin,
+                                      distance,
+                                      0.0f);
+            }
+        }
+
+        return distance;
+    }
+
+    SweepResult sweepBox(
+        std::span<const PositionedVolume> volumes,
+        Aabb                              box,
+        glm::vec3                         displacement)
+    {
+        // y first so that falling onto a ledge doesn't also stop the
+        // sideways movement that got there
+        constexpr std::array<glm::length_t, 3> AxisOrder {1, 0, 2};
+
+        SweepResult result {
+            .displacement {0.0f, 0.0f, 0.0f},
+            .collided {false, false, false}};
+
+        for (glm::length_t axis : AxisOrder)
+        {
+            float allowed = displacement[axis];
+
+            if (allowed == 0.0f)
+            {
+                continue;
+            }
+
+            for (const PositionedVolume& v : volumes)
+            {
+                if (v.volume != nullptr)
+                {
+                    allowed = sweepAxis(
+                        *v.volume, box + -v.position, axis, allowed);
+                }
+            }
+
+            box.minimum[axis] += allowed;
+            box.maximum[axis] += allowed;
+
+            result.displacement[axis] = allowed;
+            result.collided[axis]     = allowed != displacement[axis];
+        }
+
+        return result;
+    }
+
+    void sweepBoxes(
+        std::span<const PositionedVolume> volumes,
+        std::span<const Sweep>            sweeps,
+        std::span<SweepResult>            results)
+    {
+        util::assertFatal(
+            sweeps.size() == results.size(),
+            "Swept {} boxes into {} results",
+            sweeps.size(),
+            results.size());
+
+        for (std::size_t i = 0; i < sweeps.size(); ++i)
+        {
+            const Sweep& sweep = sweeps[i]; // NOLINT
+
+            results[i] = // NOLINT
+                sweepBox(volumes, sweep.box, sweep.displacement);
+        }
+    }
+} // namespace game::world
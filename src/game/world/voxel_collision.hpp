@@ -0,0 +1,72 @@
+#ifndef SRC_GAME_WORLD_VOXEL_COLLISION_HPP
+#define SRC_GAME_WORLD_VOXEL_COLLISION_HPP
+
+#include "sparse_volume.hpp"
+#include <span>
+
+namespace game::world
+{
+    /// An axis aligned box. Voxels are centered on their position, so the
+    /// voxel at p fills [p - 0.5, p + 0.5] on every axis
+    struct Aabb
+    {
+        glm::vec3 minimum;
+        glm::vec3 maximum;
+
+        [[nodiscard]] Aabb operator+ (glm::vec3) const;
+    };
+
+    // A box that wants to move by displacement
+    struct Sweep
+    {
+        Aabb      box;
+        glm::vec3 displacement;
+    };
+
+    struct SweepResult
+    {
+        // How far the box actually moved, never further than asked
+        glm::vec3  displacement;
+        // The axes that were stopped short by a voxel
+        glm::bvec3 collided;
+    };
+
+    // Anything that isn't empty blocks, boxes are kept this far away from
+    // the voxels that they touch so that they don't start the next sweep
+    // inside of one
+    inline constexpr float CollisionSkin {1.0f / 1024.0f};
+
+    // How far, up to distance, the box can move along the axis, 0 for x
+    // to 2 for z, before it touches a voxel of the volume. The box is
+    // relative to the volume. Voxels that the box already overlaps are
+    // ignored so that it can always move out of them, and everything
+    // outside of the volume is empty. Bricks that aren't allocated are
+    // skipped whole
+    [[nodiscard]] float sweepAxis(
+        const SparseVoxelVolume&,
+        const Aabb&   box,
+        glm::length_t axis,
+        float         distance);
+
+    // A volume that boxes collide against, at some position in the boxes'
+    // space
+    struct PositionedVolume
+    {
+        const SparseVoxelVolume* volume;
+        // Where the volume's local (0, 0, 0) is
+        glm::vec3                position;
+    };
+
+    // Moves the box along y, then x, then z, so that a box blocked on one
+    // axis keeps sliding along the others
+    [[nodiscard]] SweepResult sweepBox(
+        std::span<const PositionedVolume>, Aabb, glm::vec3 displacement);
+
+    // sweepBox() for each sweep, results must be as long as sweeps
+    void sweepBoxes(
+        std::span<const PositionedVolume>,
+        std::span<const Sweep> sweeps,
+        std::span<SweepResult> results);
+} // namespace game::world
+
+#endif // SRC_GAME_WORLD_VOXEL_COLLISION_HPP
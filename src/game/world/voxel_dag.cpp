@@ -0,0 +1,410 @@
+#include "voxel_dag.hpp"
+#include <algorithm>
+#include <bit>
+#include <boost/functional/hash.hpp>
+#include <engine/settings.hpp>
+#include <fmt/format.h>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <util/log.hpp>
+
+namespace game::world
+{
+    namespace
+    {
+        constexpr std::int32_t BrickExtent {VoxelVolume::Extent};
+
+        Position getChildOffset(std::size_t child)
+        {
+            return Position {
+                static_cast<std::int32_t>((child >> 2) & 1),
+                static_cast<std::int32_t>((child >> 1) & 1),
+                static_cast<std::int32_t>(child & 1)};
+        }
+
+        std::optional<Voxel> getUniformVoxel(const VoxelVolume& brick)
+        {
+            const Voxel first = brick.readFromLocalPosition({0, 0, 0});
+
+            for (std::int32_t x = 0; x < BrickExtent; ++x)
+            {
+                for (std::int32_t y = 0; y < BrickExtent; ++y)
+                {
+                    for (std::int32_t z = 0; z < BrickExtent; ++z)
+                    {
+                        if (brick.readFromLocalPosition({x, y, z}) != first)
+                        {
+                            return std::nullopt;
+                        }
+                    }
+                }
+            }
+
+            return first;
+        }
+
+        std::size_t hashBrick(const VoxelVolume& brick)
+        {
+            const std::span<const std::byte, VoxelVolume::Bytes> bytes =
+                brick.getBytes();
+
+            return std::hash<std::string_view> {}(std::string_view {
+                reinterpret_cast<const char*>(bytes.data()), // NOLINT
+                bytes.size()});
+        }
+
+        bool areBricksEqual(const VoxelVolume& l, const VoxelVolume& r)
+        {
+            return std::ranges::equal(l.getBytes(), r.getBytes());
+        }
+    } // namespace
+
+    struct VoxelDag::Builder
+    {
+        const SparseVoxelVolume& volume;
+
+        // hash -> indices of every brick / node with that hash
+        std::unordered_map<std::size_t, std::vector<std::uint32_t>>
+            brick_buckets;
+        std::unordered_map<std::size_t, std::vector<std::uint32_t>>
+            node_buckets;
+    };
+
+    VoxelDag::Iterator::Iterator(const VoxelDag& dag_)
+        : dag {&dag_}
+        , stack {}
+        , current {}
+        , is_done {false}
+    {
+        const Position rootMinimum {
+            SparseVoxelVolume::VoxelMinimum,
+            SparseVoxelVolume::VoxelMinimum,
+            SparseVoxelVolume::VoxelMinimum};
+
+        if (const Voxel* voxel = std::get_if<Voxel>(&this->dag->root))
+        {
+            this->current = Region {
+                .minimum {rootMinimum},
+                .extent {SparseVoxelVolume::VoxelExtent},
+                .contents {*voxel}};
+
+            this->is_done = !voxel->shouldDraw();
+
+            return;
+        }
+
+        this->stack.push_back(Frame {
+            .node {std::to_underlying(std::get<Index>(this->dag->root))},
+            .minimum {rootMinimum},
+            .extent {SparseVoxelVolume::VoxelExtent},
+            .next_child {0}});
+
+        this->advance();
+    }
+
+    const VoxelDag::Region& VoxelDag::Iterator::operator* () const
+    {
+        return this->current;
+    }
+
+    const VoxelDag::Region* VoxelDag::Iterator::operator->() const
+    {
+        return &this->current;
+    }
+
+    VoxelDag::Iterator& VoxelDag::Iterator::operator++ ()
+    {
+        this->advance();
+
+        return *this;
+    }
+
+    void VoxelDag::Iterator::operator++ (int)
+    {
+        this->advance();
+    }
+
+    bool VoxelDag::Iterator::operator== (std::default_sentinel_t) const
+    {
+        return this->is_done;
+    }
+
+    void VoxelDag::Iterator::advance()
+    {
+        while (!this->stack.empty())
+        {
+            Frame& frame = this->stack.back();
+
+            if (frame.next_child == 8)
+            {
+                this->stack.pop_back();
+
+                continue;
+            }
+
+            const std::size_t  childIndex = frame.next_child++;
+            const std::int32_t half       = frame.extent / 2;
+            const Position     minimum =
+                frame.minimum + getChildOffset(childIndex) * half;
+            const Child child =
+                this->dag->nodes[frame.node][childIndex]; // NOLINT
+
+            if (const Voxel* voxel = std::get_if<Voxel>(&child))
+            {
+                if (voxel->shouldDraw())
+                {
+                    this->current = Region {
+                        .minimum {minimum}, .extent {half}, .contents {*voxel}};
+
+                    return;
+                }
+
+                continue;
+            }
+
+            const std::uint32_t index =
+                std::to_underlying(std::get<Index>(child));
+
+            if (half == BrickExtent)
+            {
+                this->current = Region {
+                    .minimum {minimum},
+                    .extent {half},
+                    .contents {&this->dag->bricks[index]}};
+
+                return;
+            }
+
+            this->stack.push_back(Frame {
+                .node {index},
+                .minimum {minimum},
+                .extent {half},
+                .next_child {0}});
+        }
+
+        this->is_done = true;
+    }
+
+    double VoxelDag::Statistics::getCompressionRatio() const
+    {
+        return static_cast<double>(this->source_bytes)
+             / static_cast<double>(this->bytes);
+    }
+
+    VoxelDag::Statistics::operator std::string () const
+    {
+        return fmt::format(
+            "Bricks {} -> {} | Nodes {} | Bytes {} -> {} | Ratio {:.2f}",
+            this->source_bricks,
+            this->unique_bricks,
+            this->nodes,
+            this->source_bytes,
+            this->bytes,
+            this->getCompressionRatio());
+    }
+
+    VoxelDag::VoxelDag(const SparseVoxelVolume& volume)
+        : bricks {}
+        , nodes {}
+        , root {Voxel {}}
+        , source_bricks {0}
+    {
+        Builder builder {
+            .volume {volume}, .brick_buckets {}, .node_buckets {}};
+
+        this->root = this->build(
+            builder,
+            Position {
+                SparseVoxelVolume::Minimum,
+                SparseVoxelVolume::Minimum,
+                SparseVoxelVolume::Minimum},
+            SparseVoxelVolume::Extent);
+
+        this->bricks.shrink_to_fit();
+        this->nodes.shrink_to_fit();
+    }
+
+    Voxel VoxelDag::readFromLocalPosition(Position localPosition) const
+    {
+        if (engine::getSettings()
+                .lookupSetting<engine::Setting::EnableAppValidation>())
+        {
+            auto isInside = [](std::int32_t c)
+            {
+                return c >= SparseVoxelVolume::VoxelMinimum
+                    && c <= SparseVoxelVolume::VoxelMaximum;
+            };
+
+            util::assertFatal(
+                isInside(localPosition.x) && isInside(localPosition.y)
+                    && isInside(localPosition.z),
+                "{} is outside of the volume",
+                static_cast<std::string>(localPosition));
+        }
+
+        // [0, VoxelExtent), the bit for each level's half extent picks the
+        // child on that axis
+        const Position unsignedPosition {
+            localPosition.x - SparseVoxelVolume::VoxelMinimum,
+            localPosition.y - SparseVoxelVolume::VoxelMinimum,
+            localPosition.z - SparseVoxelVolume::VoxelMinimum};
+
+        Child        child  = this->root;
+        std::int32_t extent = SparseVoxelVolume::VoxelExtent;
+
+        while (true)
+        {
+            if (const Voxel* voxel = std::get_if<Voxel>(&child))
+            {
+                return *voxel;
+            }
+
+            const std::uint32_t index =
+                std::to_underlying(std::get<Index>(child));
+
+            if (extent == BrickExtent)
+            {
+                return this->bricks[index].readFromLocalPosition(Position {
+                    unsignedPosition.x % BrickExtent,
+                    unsignedPosition.y % BrickExtent,
+                    unsignedPosition.z % BrickExtent});
+            }
+
+            extent /= 2;
+
+            const std::size_t childIndex =
+                (static_cast<std::size_t>((unsignedPosition.x & extent) != 0)
+                 << 2)
+                | (static_cast<std::size_t>((unsignedPosition.y & extent) != 0)
+                   << 1)
+                | static_cast<std::size_t>((unsignedPosition.z & extent) != 0);
+
+            child = this->nodes[index][childIndex]; // NOLINT
+        }
+    }
+
+    VoxelDag::Iterator VoxelDag::begin() const
+    {
+        return Iterator {*this};
+    }
+
+    std::default_sentinel_t VoxelDag::end() const // NOLINT
+    {
+        return std::default_sentinel;
+    }
+
+    VoxelDag::Statistics VoxelDag::getStatistics() const
+    {
+        return Statistics {
+            .source_bricks {this->source_bricks},
+            .source_bytes {this->source_bricks * sizeof(VoxelVolume)},
+            .unique_bricks {this->bricks.size()},
+            .nodes {this->nodes.size()},
+            .bytes {
+                this->bricks.size() * sizeof(VoxelVolume)
+                + this->nodes.size() * sizeof(Node) + sizeof(Child)},
+        };
+    }
+
+    VoxelDag::Child VoxelDag::build(
+        Builder& builder, Position brickMinimum, std::int32_t extentInBricks)
+    {
+        if (extentInBricks == 1)
+        {
+            const Position voxelPosition = brickMinimum * BrickExtent;
+
+            const VoxelVolume* brick = builder.volume.readBrick(voxelPosition);
+
+            if (brick == nullptr)
+            {
+                return *builder.volume.readUniformBrick(voxelPosition);
+            }
+
+            this->source_bricks += 1;
+
+            if (std::optional<Voxel> uniform = getUniformVoxel(*brick))
+            {
+                return *uniform;
+            }
+
+            std::vector<std::uint32_t>& bucket =
+                builder.brick_buckets[hashBrick(*brick)];
+
+            for (std::uint32_t index : bucket)
+            {
+                if (areBricksEqual(this->bricks[index], *brick))
+                {
+                    return Index {index};
+                }
+            }
+
+            const auto index = static_cast<std::uint32_t>(this->bricks.size());
+
+            this->bricks.push_back(*brick);
+            bucket.push_back(index);
+
+            return Index {index};
+        }
+
+        const std::int32_t half = extentInBricks / 2;
+
+        Node node {};
+
+        for (std::size_t i = 0; i < node.size(); ++i)
+        {
+            node[i] = this->build( // NOLINT
+                builder,
+                brickMinimum + getChildOffset(i) * half,
+                half);
+        }
+
+        if (std::ranges::all_of(
+                node,
+                [&](const Child& c)
+                {
+                    return std::holds_alternative<Voxel>(c) && c == node[0];
+                }))
+        {
+            return node[0];
+        }
+
+        std::size_t hash = 0;
+
+        for (const Child& c : node)
+        {
+            if (const Voxel* voxel = std::get_if<Voxel>(&c))
+            {
+                boost::hash_combine(
+                    hash, std::bit_cast<std::uint64_t>(*voxel));
+            }
+            else
+            {
+                // Keep indices from colliding with voxels that happen to
+                // have the same bits
+                boost::hash_combine(
+                    hash,
+                    ~static_cast<std::uint64_t>(
+                        std::to_underlying(std::get<Index>(c))));
+            }
+        }
+
+        std::vector<std::uint32_t>& bucket = builder.node_buckets[hash];
+
+        for (std::uint32_t index : bucket)
+        {
+            if (this->nodes[index] == node)
+            {
+                return Index {index};
+            }
+        }
+
+        const auto index = static_cast<std::uint32_t>(this->nodes.size());
+
+        this->nodes.push_back(node);
+        bucket.push_back(index);
+
+        return Index {index};
+    }
+} // namespace game::world
@@ -0,0 +1,133 @@
+#ifndef SRC_GAME_WORLD_VOXEL_DAG_HPP
+#define SRC_GAME_WORLD_VOXEL_DAG_HPP
+
+#include "sparse_volume.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace game::world
+{
+    /// An immutable copy of a SparseVoxelVolume stored as a sparse voxel
+    /// directed acyclic graph. The bricks are the leaves of an octree and
+    /// every subtree that's identical to one already seen, bricks included,
+    /// is stored once and shared. Subtrees made of a single voxel collapse
+    /// into that voxel.
+    ///
+    /// Building one walks and hashes the whole volume, so it's meant to be
+    /// done on a background thread, the result is then cheap to keep around
+    /// for chunks that are far away.
+    class VoxelDag
+    {
+    public:
+        /// A cube of the volume that's either filled with a single visible
+        /// voxel or is one brick
+        struct Region
+        {
+            Position     minimum;
+            std::int32_t extent;
+
+            std::variant<Voxel, const VoxelVolume*> contents;
+        };
+
+        class Iterator
+        {
+        public:
+            using value_type      = Region;
+            using difference_type = std::ptrdiff_t;
+
+            Iterator() = default;
+            explicit Iterator(const VoxelDag&);
+
+            const Region& operator* () const;
+            const Region* operator->() const;
+            Iterator&     operator++ ();
+            void          operator++ (int);
+
+            bool operator== (std::default_sentinel_t) const;
+
+        private:
+            struct Frame
+            {
+                std::uint32_t node;
+                Position      minimum;
+                std::int32_t  extent;
+                std::uint8_t  next_child;
+            };
+
+            void advance();
+
+            const VoxelDag*    dag {nullptr};
+            std::vector<Frame> stack;
+            Region             current {};
+            bool               is_done {true};
+        };
+
+        struct Statistics
+        {
+            // allocated bricks in the source volume, and the size of just
+            // their voxels as the brick table is shared between snapshots
+            std::size_t source_bricks;
+            std::size_t source_bytes;
+
+            std::size_t unique_bricks;
+            std::size_t nodes;
+            std::size_t bytes;
+
+            [[nodiscard]] double getCompressionRatio() const;
+            explicit             operator std::string () const;
+        };
+
+    public:
+
+        explicit VoxelDag(const SparseVoxelVolume&);
+        ~VoxelDag() = default;
+
+        VoxelDag(const VoxelDag&)             = delete;
+        VoxelDag(VoxelDag&&)                  = default;
+        VoxelDag& operator= (const VoxelDag&) = delete;
+        VoxelDag& operator= (VoxelDag&&)      = default;
+
+        // Same positions as SparseVoxelVolume::readFromLocalPosition
+        [[nodiscard]] Voxel readFromLocalPosition(Position localPosition) const;
+
+        // Visits every region with something visible in it, empty space is
+        // skipped. Shared subtrees are visited once for every place they're in
+        [[nodiscard]] Iterator                begin() const;
+        [[nodiscard]] std::default_sentinel_t end() const;
+
+        [[nodiscard]] Statistics getStatistics() const;
+
+    private:
+        // Indexes nodes, or bricks for the children of nodes whose children
+        // are a single brick in extent
+        enum class Index : std::uint32_t
+        {
+        };
+
+        using Child = std::variant<Voxel, Index>;
+
+        // Children are ordered by (x << 2) | (y << 1) | z
+        using Node = std::array<Child, 8>;
+
+        struct Builder;
+
+        Child build(
+            Builder&, Position brickMinimum, std::int32_t extentInBricks);
+
+        std::vector<VoxelVolume> bricks;
+        std::vector<Node>        nodes;
+        Child                    root;
+        std::size_t              source_bricks;
+    };
+
+    static_assert(std::input_iterator<VoxelDag::Iterator>);
+    static_assert(
+        std::sentinel_for<std::default_sentinel_t, VoxelDag::Iterator>);
+} // namespace game::world
+
+#endif // SRC_GAME_WORLD_VOXEL_DAG_HPP
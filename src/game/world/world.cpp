@@ -1,41 +1,321 @@
 
 #include "game/world/world.hpp"
 #include "game/world/sparse_volume.hpp"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <engine/settings.hpp>
+#include <future>
 #include <game/game.hpp>
 #include <gfx/renderer.hpp>
+#include <map>
+#include <set>
+#include <util/log.hpp>
 #include <util/misc.hpp>
 #include <util/noise.hpp>
+#include <vector>
 
 namespace game::world
 {
+    namespace
+    {
+        // Neighbouring chunks share their boundary voxels
+        constexpr std::int32_t ChunkSpacing {
+            SparseVoxelVolume::VoxelExtent - 1};
+
+        bool isPositionInChunk(ChunkCoordinate chunk, Position position)
+        {
+            auto isAxisInside = [](std::int32_t offset)
+            {
+                return offset >= SparseVoxelVolume::VoxelMinimum
+                    && offset <= SparseVoxelVolume::VoxelMaximum;
+            };
+
+            const Position offset = position - chunk;
+
+            return isAxisInside(offset.x) && isAxisInside(offset.y)
+                && isAxisInside(offset.z);
+        }
+    } // namespace
+
+    glm::vec3 Rebase::getShift() const
+    {
+        return static_cast<glm::vec3>(this->origin - this->previous_origin);
+    }
 
     World::World(const Game& game_)
         : game {game_}
+        , origin {0, 0, 0}
+        , culling_statistics {.chunks {0}, .culled {0}}
     {
         std::int32_t radius = 0;
 
+        const ChunkDrawMode drawMode =
+            engine::getSettings()
+                    .lookupSetting<engine::Setting::InstancedChunks>()
+                ? ChunkDrawMode::Instanced
+                : ChunkDrawMode::Meshed;
+
         for (std::int32_t x = -radius; x <= radius; x++)
         {
             for (std::int32_t z = -radius; z <= radius; z++)
             {
-                std::int32_t chunkX = static_cast<std::int32_t>(x * 512);
-                std::int32_t chunkZ = static_cast<std::int32_t>(z * 512);
-
                 this->chunks.insert(Chunk {
-                    Position {chunkX - x, 0, chunkZ - z}, generationFunc});
+                    Position {x, 0, z} * ChunkSpacing,
+                    generationFunc,
+                    drawMode});
             }
         }
     }
 
-    void World::updateChunkState()
+    void World::updateChunkState(glm::vec3 cameraPosition)
     {
         for (const Chunk& c : this->chunks)
         {
             // this function, while non const, doesn't change the chunk's
             // ordering, thus this is fine
             // NOLINTNEXTLINE
-            const_cast<Chunk&>(c).updateDrawState(this->game.renderer);
+            const_cast<Chunk&>(c).updateDrawState(
+                this->game.renderer, this->origin);
+        }
+
+        this->cullChunks(
+            this->origin
+            + Position {
+                static_cast<std::int32_t>(std::floor(cameraPosition.x)),
+                static_cast<std::int32_t>(std::floor(cameraPosition.y)),
+                static_cast<std::int32_t>(std::floor(cameraPosition.z))});
+    }
+
+    World::CullingStatistics World::getCullingStatistics() const
+    {
+        return this->culling_statistics;
+    }
+
+    SweepResult World::sweepBox(Aabb box, glm::vec3 displacement) const
+    {
+        const std::vector<PositionedVolume> volumes =
+            this->getCollisionVolumes();
+
+        return world::sweepBox(volumes, box, displacement);
+    }
+
+    void World::sweepBoxes(
+        std::span<const Sweep> sweeps, std::span<SweepResult> results) const
+    {
+        // Below this a worker isn't worth starting
+        constexpr std::size_t SweepsPerWorker {4096};
+
+        util::assertFatal(
+            sweeps.size() == results.size(),
+            "Swept {} boxes into {} results",
+            sweeps.size(),
+            results.size());
+
+        const std::vector<PositionedVolume> volumes =
+            this->getCollisionVolumes();
+
+        if (sweeps.size() <= SweepsPerWorker)
+        {
+            world::sweepBoxes(volumes, sweeps, results);
+
+            return;
+        }
+
+        std::vector<std::future<void>> futures {};
+        futures.reserve(sweeps.size() / SweepsPerWorker + 1);
+
+        for (std::size_t i = 0; i < sweeps.size(); i += SweepsPerWorker)
+        {
+            const std::size_t count =
+                std::min(SweepsPerWorker, sweeps.size() - i);
+
+            futures.push_back(std::async(
+                std::launch::async,
+                [&volumes,
+                 workerSweeps  = sweeps.subspan(i, count),
+                 workerResults = results.subspan(i, count)]
+                {
+                    world::sweepBoxes(volumes, workerSweeps, workerResults);
+                }));
         }
+
+        for (std::future<void>& f : futures)
+        {
+            f.get();
+        }
+    }
+
+    std::vector<PositionedVolume> World::getCollisionVolumes() const
+    {
+        std::vector<PositionedVolume> volumes {};
+        volumes.reserve(this->chunks.size());
+
+        for (const Chunk& c : this->chunks)
+        {
+            if (const SparseVoxelVolume* volume = c.getVolume();
+                volume != nullptr)
+            {
+                volumes.push_back(PositionedVolume {
+                    .volume {volume},
+                    .position {static_cast<glm::vec3>(
+                        c.getLocation() - this->origin)}});
+            }
+        }
+
+        return volumes;
+    }
+
+    void World::cullChunks(Position cameraPosition)
+    {
+        std::map<ChunkCoordinate, const Chunk*> chunksByLocation {};
+        const Chunk*                            cameraChunk = nullptr;
+
+        for (const Chunk& c : this->chunks)
+        {
+            chunksByLocation.emplace(c.getLocation(), &c);
+
+            if (isPositionInChunk(c.getLocation(), cameraPosition))
+            {
+                cameraChunk = &c;
+            }
+        }
+
+        this->culling_statistics =
+            CullingStatistics {.chunks {this->chunks.size()}, .culled {0}};
+
+        // Nowhere to walk from, everything stays visible
+        if (cameraChunk == nullptr)
+        {
+            for (const Chunk& c : this->chunks)
+            {
+                c.setCulled(false);
+            }
+
+            return;
+        }
+
+        struct Step
+        {
+            const Chunk* chunk;
+            // std::nullopt for the camera's chunk, which is seen from inside
+            std::optional<ChunkFace> entered_through;
+            // Bit per ChunkFace that has been stepped out of on the way here
+            std::uint8_t             directions;
+        };
+
+        std::set<const Chunk*> reached {cameraChunk};
+        std::deque<Step>       queue {};
+
+        queue.push_back(Step {
+            .chunk {cameraChunk},
+            .entered_through {std::nullopt},
+            .directions {0}});
+
+        while (!queue.empty())
+        {
+            const Step step = queue.front();
+            queue.pop_front();
+
+            for (ChunkFace exit : AllChunkFaces)
+            {
+                const auto backwards = static_cast<std::uint8_t>(
+                    1U << std::to_underlying(getOppositeFace(exit)));
+
+                // Only ever walking away from the camera keeps this from
+                // seeing around corners that it can't
+                if ((step.directions & backwards) != 0)
+                {
+                    continue;
+                }
+
+                if (step.entered_through.has_value()
+                    && !step.chunk->getVisibility().canSeeThrough(
+                        *step.entered_through, exit))
+                {
+                    continue;
+                }
+
+                const auto maybeNeighbour = chunksByLocation.find(
+                    step.chunk->getLocation()
+                    + getFaceNormal(exit) * ChunkSpacing);
+
+                if (maybeNeighbour == chunksByLocation.cend()
+                    || !reached.insert(maybeNeighbour->second).second)
+                {
+                    continue;
+                }
+
+                queue.push_back(Step {
+                    .chunk {maybeNeighbour->second},
+                    .entered_through {getOppositeFace(exit)},
+                    .directions {static_cast<std::uint8_t>(
+                        step.directions
+                        | (1U << std::to_underlying(exit)))}});
+            }
+        }
+
+        for (const Chunk& c : this->chunks)
+        {
+            const bool isCulled = !reached.contains(&c);
+
+            c.setCulled(isCulled);
+
+            if (isCulled)
+            {
+                this->culling_statistics.culled += 1;
+            }
+        }
+    }
+
+    Position World::getOrigin() const
+    {
+        return this->origin;
+    }
+
+    std::optional<Rebase> World::getRecentering(glm::vec3 localPosition) const
+    {
+        const glm::vec3 distance = glm::abs(localPosition);
+
+        if (distance.x <= RecenterDistance && distance.y <= RecenterDistance
+            && distance.z <= RecenterDistance)
+        {
+            return std::nullopt;
+        }
+
+        // Keep the origin on the chunk grid so that every chunk's offset
+        // from it is a whole number of chunks
+        auto snapToChunk = [](float f) -> std::int32_t
+        {
+            return static_cast<std::int32_t>(
+                       std::round(f / static_cast<float>(ChunkSpacing)))
+                 * ChunkSpacing;
+        };
+
+        return Rebase {
+            .previous_origin {this->origin},
+            .origin {
+                this->origin
+                + Position {
+                    snapToChunk(localPosition.x),
+                    snapToChunk(localPosition.y),
+                    snapToChunk(localPosition.z)}},
+        };
+    }
+
+    void World::rebase(const Rebase& rebase)
+    {
+        this->origin = rebase.origin;
+
+        for (const Chunk& c : this->chunks)
+        {
+            c.rebase(this->origin);
+        }
+
+        util::logLog(
+            "Rebased world from {} to {}",
+            static_cast<std::string>(rebase.previous_origin),
+            static_cast<std::string>(rebase.origin));
     }
 
     std::size_t World::estimateSize() const
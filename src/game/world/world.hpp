@@ -2,7 +2,10 @@
 #define SRC_GAME_WORLD_WORLD_HPP
 
 #include "chunk.hpp"
+#include "voxel_collision.hpp"
+#include <optional>
 #include <set>
+#include <span>
 #include <util/noise.hpp>
 
 namespace game
@@ -12,10 +15,33 @@ namespace game
 
 namespace game::world
 {
+    /// Emitted whenever the World moves its origin.
+    /// Everything that keeps a position relative to the origin must subtract
+    /// getShift() from it, so that its absolute position is unchanged
+    struct Rebase
+    {
+        Position previous_origin;
+        Position origin;
+
+        [[nodiscard]] glm::vec3 getShift() const;
+    };
 
+    /// Floating origin:
+    /// Absolute positions are integer voxel coordinates, everything that is
+    /// handed to the gpu, or otherwise stored as a float, is relative to the
+    /// World's origin. The origin follows the player so that those floats
+    /// stay small, and thus precise, no matter how far from (0, 0, 0) the
+    /// player is.
     class World
     {
     public:
+        // From the last updateChunkState
+        struct CullingStatistics
+        {
+            std::size_t chunks;
+            std::size_t culled;
+        };
+
         static std::int32_t
         generationFunc(std::int32_t x, std::int32_t z) noexcept
         {
@@ -55,11 +81,49 @@ namespace game::world
         World& operator= (World&&)      = delete;
 
         [[nodiscard]] std::size_t estimateSize() const;
-        void                      updateChunkState();
+
+        // Also culls the chunks that can't be seen from the camera, given
+        // relative to the origin
+        void updateChunkState(glm::vec3 cameraPosition);
+
+        [[nodiscard]] CullingStatistics getCullingStatistics() const;
+
+        // Boxes are relative to the origin. Chunks that are still being
+        // generated don't collide with anything
+        [[nodiscard]] SweepResult
+        sweepBox(Aabb, glm::vec3 displacement) const;
+        // Spread over worker threads when there are enough sweeps, results
+        // must be as long as sweeps
+        void sweepBoxes(
+            std::span<const Sweep> sweeps,
+            std::span<SweepResult> results) const;
+
+        [[nodiscard]] Position getOrigin() const;
+
+        // The rebase that recentering around the given position, relative to
+        // the current origin, would make if it has drifted too far from it
+        [[nodiscard]] std::optional<Rebase>
+        getRecentering(glm::vec3 localPosition) const;
+        // Moves the origin and publishes every chunk's new transform
+        void rebase(const Rebase&);
 
     private:
-        const Game&     game;
-        std::set<Chunk> chunks;
+        // How far from the origin, on any axis, before recentering
+        static constexpr float RecenterDistance {
+            2.0f * static_cast<float>(SparseVoxelVolume::VoxelExtent)};
+
+        // Walks the chunks outwards from the one containing the camera,
+        // only through faces that the chunks can see through, and culls
+        // every chunk that isn't reached
+        void cullChunks(Position cameraPosition);
+
+        // Every generated chunk, relative to the origin
+        std::vector<PositionedVolume> getCollisionVolumes() const;
+
+        const Game&       game;
+        std::set<Chunk>   chunks;
+        Position          origin;
+        CullingStatistics culling_statistics;
     };
 } // namespace game::world
 
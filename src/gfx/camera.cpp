@@ -100,6 +100,15 @@ namespace gfx
             this->yaw);
     }
 
+    Camera blend(const Camera& from, const Camera& to, float t)
+    {
+        Camera result = to;
+
+        result.transform = blend(from.transform, to.transform, t);
+
+        return result;
+    }
+
     void Camera::updateTransformFromRotations()
     {
         glm::quat q {1.0f, 0.0f, 0.0f, 0.0f};
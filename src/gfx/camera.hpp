@@ -27,6 +27,9 @@ namespace gfx
 
         explicit operator std::string () const;
 
+        // The transform is blended, the pitch and yaw are to's
+        friend Camera blend(const Camera& from, const Camera& to, float t);
+
     private:
         void updateTransformFromRotations();
 
@@ -35,6 +38,8 @@ namespace gfx
 
         Transform transform;
     };
+
+    [[nodiscard]] Camera blend(const Camera& from, const Camera& to, float t);
 } // namespace gfx
 
 #endif // SRC_GfX_CAMERA_HPP
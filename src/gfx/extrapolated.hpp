@@ -0,0 +1,128 @@
+#ifndef SRC_GFX_EXTRAPOLATED_HPP
+#define SRC_GFX_EXTRAPOLATED_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <engine/settings.hpp>
+#include <util/threads.hpp>
+
+namespace gfx
+{
+    /// The last two states that the game thread published, each stamped
+    /// with the time of the tick that made it, so that the render thread can
+    /// draw where the state should be by the time the frame is drawn. Motion
+    /// continues past the newest state at the rate between the two, so a
+    /// tick that runs late doesn't freeze what's on screen.
+    ///
+    /// Publish with the tick's scheduled time rather than when the tick ran,
+    /// ticks that are caught up on back to back run microseconds apart.
+    ///
+    /// T must have a `blend(const T& from, const T& to, float t)` that
+    /// can be found from gfx, see Transform and Camera.
+    template<class T>
+        requires std::is_trivially_copyable_v<T>
+    class Extrapolated
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        // Past this, states are held rather than guessed at any further
+        static constexpr Clock::duration MaxExtrapolation {
+            std::chrono::milliseconds {100}};
+
+    public:
+
+        explicit Extrapolated(const T& t)
+            : samples {Samples {
+                  .previous {t},
+                  .current {t},
+                  .previous_time {},
+                  .current_time {}}}
+        {}
+        ~Extrapolated() = default;
+
+        Extrapolated(const Extrapolated&)             = delete;
+        Extrapolated(Extrapolated&&)                  = delete;
+        Extrapolated& operator= (const Extrapolated&) = delete;
+        Extrapolated& operator= (Extrapolated&&)      = delete;
+
+        // Must not be called concurrently with another publish or reset
+        void publish(const T& t, Clock::time_point time = Clock::now())
+            const noexcept
+        {
+            const Samples last = this->samples.copyInner();
+
+            this->samples.publish(Samples {
+                .previous {last.current},
+                .current {t},
+                .previous_time {last.current_time},
+                .current_time {time}});
+        }
+
+        // Drops the motion up to this state, i.e. after a teleport or a
+        // rebase, which would otherwise be extrapolated as a huge velocity
+        void
+        reset(const T& t, Clock::time_point time = Clock::now()) const noexcept
+        {
+            this->samples.publish(Samples {
+                .previous {t},
+                .current {t},
+                .previous_time {time},
+                .current_time {time}});
+        }
+
+        [[nodiscard]] T sample(Clock::time_point time) const noexcept
+        {
+            const Samples s = this->samples.copyInner();
+
+            const Clock::duration step = s.current_time - s.previous_time;
+
+            if (step <= Clock::duration::zero())
+            {
+                return s.current;
+            }
+
+            const Clock::duration ahead = std::clamp(
+                time - s.current_time,
+                Clock::duration::zero(),
+                MaxExtrapolation);
+
+            // However close together two states were published, never go
+            // further past the newest than MaxExtrapolation at the tick rate
+            const float maxBlend =
+                1.0f
+                + (std::chrono::duration<float> {MaxExtrapolation}.count()
+                   * static_cast<float>(
+                       engine::getSettings()
+                           .lookupSetting<engine::Setting::TickRateHz>()));
+
+            return blend(
+                s.previous,
+                s.current,
+                std::min(
+                    1.0f
+                        + (std::chrono::duration<float> {ahead}
+                           / std::chrono::duration<float> {step}),
+                    maxBlend));
+        }
+
+        // The newest state, as published
+        [[nodiscard]] T copyInner() const noexcept
+        {
+            return this->samples.copyInner().current;
+        }
+
+    private:
+        struct Samples
+        {
+            T                 previous;
+            T                 current;
+            Clock::time_point previous_time;
+            Clock::time_point current_time;
+        };
+
+        util::SeqLock<Samples> samples;
+    };
+} // namespace gfx
+
+#endif // SRC_GFX_EXTRAPOLATED_HPP
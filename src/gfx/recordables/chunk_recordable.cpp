@@ -0,0 +1,152 @@
+#include "chunk_recordable.hpp"
+#include <atomic>
+#include <gfx/vulkan/allocator.hpp>
+#include <gfx/vulkan/buffer.hpp>
+#include <gfx/vulkan/device.hpp>
+#include <gfx/vulkan/pipelines.hpp>
+#include <util/log.hpp>
+
+namespace gfx::recordables
+{
+
+    const vk::VertexInputBindingDescription*
+    ChunkRecordable::Vertex::getBindingDescription()
+    {
+        static const vk::VertexInputBindingDescription bindings {
+            .binding {0},
+            .stride {sizeof(Vertex)},
+            .inputRate {vk::VertexInputRate::eVertex},
+        };
+
+        return &bindings;
+    }
+
+    const std::array<vk::VertexInputAttributeDescription, 1>*
+    ChunkRecordable::Vertex::getAttributeDescriptions()
+    {
+        static const std::array<vk::VertexInputAttributeDescription, 1>
+            descriptions {vk::VertexInputAttributeDescription {
+                .location {0},
+                .binding {0},
+                .format {vk::Format::eR32G32Uint},
+                .offset {0},
+            }};
+
+        return &descriptions;
+    }
+
+    std::shared_ptr<ChunkRecordable> ChunkRecordable::create(
+        const gfx::Renderer& renderer_,
+        std::vector<Vertex>  vertices,
+        std::vector<Index>   indicies,
+        Transform            transform_,
+        std::string          name_)
+    {
+        std::shared_ptr<ChunkRecordable> recordable {new ChunkRecordable {
+            renderer_,
+            std::move(vertices),
+            std::move(indicies),
+            transform_,
+            std::move(name_)}};
+
+        recordable->registerSelf();
+
+        return recordable;
+    }
+
+    void ChunkRecordable::updateFrameState() const
+    {
+        const bool hasVertexBuffer =
+            tryResolveBuffer(this->future_vertex_buffer, this->vertex_buffer);
+        const bool hasIndexBuffer =
+            tryResolveBuffer(this->future_index_buffer, this->index_buffer);
+
+        if (hasVertexBuffer && hasIndexBuffer && !this->shouldDraw())
+        {
+            this->should_draw.store(true, std::memory_order::release);
+        }
+    }
+
+    void ChunkRecordable::record(
+        vk::CommandBuffer  commandBuffer,
+        vk::PipelineLayout layout,
+        const Camera&      camera) const
+    {
+        util::assertFatal(
+            this->vertex_buffer.has_value() && this->index_buffer.has_value(),
+            "buffers weren't valid when drawing occurred");
+
+        commandBuffer.bindVertexBuffers(
+            0, **this->vertex_buffer, {0}); // NOLINT
+
+        commandBuffer.bindIndexBuffer(
+            **this->index_buffer, 0, vk::IndexType::eUint32); // NOLINT
+
+        PushConstants pushConstants {
+            .model_view_proj {camera.getPerspectiveMatrix(
+                this->renderer, this->transform.copyInner())}};
+
+        commandBuffer.pushConstants<PushConstants>(
+            layout, vk::ShaderStageFlagBits::eVertex, 0, pushConstants);
+
+        commandBuffer.drawIndexed(
+            static_cast<std::uint32_t>(this->number_of_indices), 1, 0, 0, 0);
+    }
+
+    std::pair<vulkan::PipelineCache::PipelineHandle, vk::PipelineBindPoint>
+    ChunkRecordable::getPipeline(const vulkan::PipelineCache& cache) const
+    {
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wexit-time-destructors"
+        static util::Mutex<vulkan::PipelineCache::PipelineHandle>
+            maybeHandleMutex {}; // NOLINT
+#pragma clang diagnostic pop
+
+        const vulkan::PipelineCache::PipelineHandle handle =
+            this->getOrCreateGraphicsPipeline(
+                cache,
+                maybeHandleMutex,
+                GraphicsPipelineDescription {
+                    .vertex_shader {"chunk.vert.bin"},
+                    .fragment_shader {"flat_pipeline.frag.bin"},
+                    .vertex_binding {Vertex::getBindingDescription()},
+                    .vertex_attributes {*Vertex::getAttributeDescriptions()},
+                    .topology {vk::PrimitiveTopology::eTriangleList},
+                    .push_constants_size {sizeof(PushConstants)},
+                    .name {"ChunkRecordable"},
+                });
+
+        return {handle, vk::PipelineBindPoint::eGraphics};
+    }
+
+    ChunkRecordable::ChunkRecordable(
+        const gfx::Renderer& renderer_,
+        std::vector<Vertex>  vertices,
+        std::vector<Index>   indicies,
+        Transform            transform_,
+        std::string          name_)
+        : Recordable {
+            renderer_,
+            fmt::format(
+                "ChunkRecordable | {} | Vertices: {} | Indicies {}",
+                name_,
+                vertices.size(),
+                indicies.size()),
+            DrawStage::DisplayPass}
+        , transform {transform_}
+        , number_of_vertices {vertices.size()}
+        , number_of_indices {indicies.size()}
+    {
+        this->future_vertex_buffer = this->uploadBuffer(
+            std::move(vertices),
+            vk::BufferUsageFlagBits::eVertexBuffer,
+            fmt::format(
+                "Vertex Buffer | {}", static_cast<std::string>(*this)));
+
+        this->future_index_buffer = this->uploadBuffer(
+            std::move(indicies),
+            vk::BufferUsageFlagBits::eIndexBuffer,
+            fmt::format("Index Buffer | {}", static_cast<std::string>(*this)));
+    }
+
+} // namespace gfx::recordables
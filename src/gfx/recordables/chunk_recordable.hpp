@@ -0,0 +1,114 @@
+#ifndef SRC_GFX_RECORDABLES_CHUNK_RECORDABLE_HPP
+#define SRC_GFX_RECORDABLES_CHUNK_RECORDABLE_HPP
+
+#include "packed_voxel.hpp"
+#include "recordable.hpp"
+#include <array>
+#include <cstdint>
+#include <future>
+#include <gfx/vulkan/buffer.hpp>
+#include <util/threads.hpp>
+
+namespace gfx::recordables
+{
+    /// The mesh of a chunk's voxels. Every vertex is a corner of a voxel's
+    /// face packed into 8 bytes, which chunk.vert unpacks, rather than the 40
+    /// of a FlatRecordable::Vertex.
+    class ChunkRecordable final : public Recordable
+    {
+    public:
+        struct Vertex
+        {
+            struct Unpacked
+            {
+                // Relative to the chunk's most negative voxel, in
+                // [0, MaxPackedVoxelExtent)
+                std::array<std::uint32_t, 3> voxel;
+                // An index into CubeFaces in sparse_volume.cpp, which
+                // chunk.vert's tables match, and the corner of that face
+                std::uint32_t                face;
+                std::uint32_t                corner;
+
+                std::array<std::uint8_t, 3> srgb;
+                // Ambient occlusion and light, [0, 1]
+                float                       brightness;
+                float                       alpha;
+            };
+
+            static Vertex pack(const Unpacked& u) noexcept
+            {
+                return Vertex {
+                    .voxel_face_corner {
+                        packVoxelPosition(u.voxel)
+                        | (u.face << PackedVoxelPositionBits)
+                        | (u.corner << (PackedVoxelPositionBits + 3))},
+                    .color_light_alpha {
+                        packVoxelColor(u.srgb, u.brightness, u.alpha)},
+                };
+            }
+
+            // A packed voxel position, see packed_voxel.hpp
+            // [27, 30) face
+            // [30, 32) corner
+            std::uint32_t voxel_face_corner;
+            // A packed voxel color
+            std::uint32_t color_light_alpha;
+
+            bool operator== (const Vertex&) const = default;
+
+            static const vk::VertexInputBindingDescription*
+            getBindingDescription();
+
+            static const std::array<vk::VertexInputAttributeDescription, 1>*
+            getAttributeDescriptions();
+        };
+
+        static_assert(sizeof(Vertex) == 8);
+
+        struct PushConstants
+        {
+            glm::mat4 model_view_proj;
+        };
+
+        using Index = std::uint32_t;
+    public:
+
+        static std::shared_ptr<ChunkRecordable> create(
+            const gfx::Renderer&,
+            std::vector<Vertex>,
+            std::vector<Index>,
+            Transform,
+            std::string name);
+        ~ChunkRecordable() override = default;
+
+        void updateFrameState() const override;
+        void record(vk::CommandBuffer, vk::PipelineLayout, const Camera&)
+            const override;
+
+        // Published by the owning chunk, read once per draw
+        util::SeqLock<Transform> transform;
+
+    private:
+        std::pair<vulkan::PipelineCache::PipelineHandle, vk::PipelineBindPoint>
+        getPipeline(const vulkan::PipelineCache&) const override;
+
+        mutable std::optional<std::future<gfx::vulkan::Buffer>>
+                                                   future_vertex_buffer;
+        std::size_t                                number_of_vertices;
+        mutable std::optional<gfx::vulkan::Buffer> vertex_buffer;
+
+        mutable std::optional<std::future<gfx::vulkan::Buffer>>
+                                                   future_index_buffer;
+        std::size_t                                number_of_indices;
+        mutable std::optional<gfx::vulkan::Buffer> index_buffer;
+
+        ChunkRecordable(
+            const gfx::Renderer&,
+            std::vector<Vertex>,
+            std::vector<Index>,
+            Transform,
+            std::string name);
+    };
+} // namespace gfx::recordables
+
+#endif // SRC_GFX_RECORDABLES_CHUNK_RECORDABLE_HPP
@@ -314,6 +314,20 @@ namespace gfx::recordables
 
                 ImGui::TextWrapped("%s", fpsAndTps.c_str());
 
+                const std::string chunks = std::format(
+                    "Chunks: {} | Culled: {}",
+                    state.chunks,
+                    state.culled_chunks);
+                ImGui::TextWrapped("%s", chunks.c_str());
+
+                const std::string ticks = std::format(
+                    "Tick overruns: {} | Dropped ticks: {}"
+                    " | Longest tick (ms): {:.3f}",
+                    state.tick_overruns,
+                    state.dropped_ticks,
+                    state.longest_tick_ms);
+                ImGui::TextWrapped("%s", ticks.c_str());
+
                 // const float displayImageAspectRatio =
                 //     static_cast<float>(this->display_image_size.height)
                 //     / static_cast<float>(this->display_image_size.width);
@@ -21,10 +21,15 @@ namespace gfx::recordables
     public:
         struct State
         {
-            glm::vec3   player_position;
-            float       fps;
-            float       tps;
-            std::string string;
+            glm::vec3     player_position;
+            float         fps;
+            float         tps;
+            std::size_t   chunks;
+            std::size_t   culled_chunks;
+            std::uint64_t tick_overruns;
+            std::uint64_t dropped_ticks;
+            float         longest_tick_ms;
+            std::string   string;
         };
     public:
 
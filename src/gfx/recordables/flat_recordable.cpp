@@ -69,24 +69,12 @@ namespace gfx::recordables
 
     void FlatRecordable::updateFrameState() const
     {
-        if (this->future_vertex_buffer.has_value()
-            && this->future_vertex_buffer->valid())
-        {
-            this->vertex_buffer = this->future_vertex_buffer->get();
-
-            this->future_vertex_buffer = std::nullopt;
-        }
-
-        if (this->future_index_buffer.has_value()
-            && this->future_index_buffer->valid())
-        {
-            this->index_buffer = this->future_index_buffer->get();
-
-            this->future_index_buffer = std::nullopt;
-        }
+        const bool hasVertexBuffer =
+            tryResolveBuffer(this->future_vertex_buffer, this->vertex_buffer);
+        const bool hasIndexBuffer =
+            tryResolveBuffer(this->future_index_buffer, this->index_buffer);
 
-        if (this->vertex_buffer.has_value() && this->index_buffer.has_value()
-            && !this->shouldDraw())
+        if (hasVertexBuffer && hasIndexBuffer && !this->shouldDraw())
         {
             this->should_draw.store(true, std::memory_order::release);
         }
@@ -109,7 +97,9 @@ namespace gfx::recordables
 
         PushConstants pushConstants {
             .model_view_proj {camera.getPerspectiveMatrix(
-                this->renderer, this->transform.copyInner())}};
+                this->renderer,
+                this->transform.sample(
+                    Extrapolated<Transform>::Clock::now()))}};
 
         commandBuffer.pushConstants<PushConstants>(
             layout, vk::ShaderStageFlagBits::eVertex, 0, pushConstants);
@@ -129,112 +119,19 @@ namespace gfx::recordables
             maybeHandleMutex {}; // NOLINT
 #pragma clang diagnostic pop
 
-        vulkan::PipelineCache::PipelineHandle handle = maybeHandleMutex.lock(
-            [&](vulkan::PipelineCache::PipelineHandle& maybeHandle)
-            {
-                std::expected<
-                    const vulkan::Pipeline*,
-                    vulkan::PipelineCache::InvalidCacheHandle>
-                    result = cache.lookupPipeline(maybeHandle);
-
-                if (result.has_value())
-                {
-                    return maybeHandle;
-                }
-
-                // this *is* a double read lock...
-                this->accessRenderPass(
-                    this->stage,
-                    [&](const vulkan::RenderPass* renderPass) -> void
-                    {
-                        std::vector<vk::UniqueShaderModule> uniqueShaders {};
-
-                        std::vector<std::pair<
-                            vk::ShaderStageFlagBits,
-                            vk::ShaderModule>>
-                            pipelineShaders {};
-
-                        {
-                            vk::UniqueShaderModule fragmentShader =
-                                vulkan::createShaderFromFile(
-                                    this->getAllocator()
-                                        .getOwningDevice()
-                                        ->asLogicalDevice(),
-                                    "src/gfx/vulkan/shaders/"
-                                    "flat_pipeline.frag.bin");
-
-                            pipelineShaders.push_back(
-                                {vk::ShaderStageFlagBits::eFragment,
-                                 *fragmentShader});
-
-                            uniqueShaders.push_back(std::move(fragmentShader));
-                        }
-
-                        {
-                            vk::UniqueShaderModule vertexShader =
-                                vulkan::createShaderFromFile(
-                                    this->getAllocator()
-                                        .getOwningDevice()
-                                        ->asLogicalDevice(),
-                                    "src/gfx/vulkan/shaders/"
-                                    "flat_pipeline.vert.bin");
-
-                            pipelineShaders.push_back(
-                                {vk::ShaderStageFlagBits::eVertex,
-                                 *vertexShader});
-
-                            uniqueShaders.push_back(std::move(vertexShader));
-                        }
-
-                        std::unique_ptr<vulkan::Pipeline> newPipeline {
-                            new vulkan::GraphicsPipeline {
-                                this->renderer,
-                                renderPass,
-                                pipelineShaders,
-                                vk::PipelineVertexInputStateCreateInfo {
-                                    .sType {
-                                        vk::StructureType::
-                                            ePipelineVertexInputStateCreateInfo},
-                                    .pNext {nullptr},
-                                    .flags {},
-                                    .vertexBindingDescriptionCount {1},
-                                    .pVertexBindingDescriptions {
-                                        Vertex::getBindingDescription()},
-                                    .vertexAttributeDescriptionCount {
-                                        static_cast<std::uint32_t>(
-                                            Vertex::getAttributeDescriptions()
-                                                ->size())},
-                                    .pVertexAttributeDescriptions {
-                                        Vertex::getAttributeDescriptions()
-                                            ->data()},
-                                },
-                                vk::PrimitiveTopology::eTriangleList,
-                                {},
-                                std::array {vk::PushConstantRange {
-                                    .stageFlags {
-                                        vk::ShaderStageFlagBits::eVertex},
-                                    .offset {0},
-                                    .size {sizeof(PushConstants)},
-                                }},
-                                "FlatRecordable"}};
-
-                        util::logDebug(
-                            "Created Pipeline @ {}",
-                            static_cast<const void*>(newPipeline.get()));
-
-                        maybeHandle =
-                            cache.cachePipeline(std::move(newPipeline));
-                    });
-
-                return maybeHandle;
-            });
-
-        // util::logDebug(
-        //     "Acquired handle Pipeline Handle {} @ {}",
-        //     handle.getID().has_value(),
-        //     handle.getID().has_value()
-        //         ? static_cast<std::string>(handle.getID().value())
-        //         : "null");
+        const vulkan::PipelineCache::PipelineHandle handle =
+            this->getOrCreateGraphicsPipeline(
+                cache,
+                maybeHandleMutex,
+                GraphicsPipelineDescription {
+                    .vertex_shader {"flat_pipeline.vert.bin"},
+                    .fragment_shader {"flat_pipeline.frag.bin"},
+                    .vertex_binding {Vertex::getBindingDescription()},
+                    .vertex_attributes {*Vertex::getAttributeDescriptions()},
+                    .topology {vk::PrimitiveTopology::eTriangleList},
+                    .push_constants_size {sizeof(PushConstants)},
+                    .name {"FlatRecordable"},
+                });
 
         return {handle, vk::PipelineBindPoint::eGraphics};
     }
@@ -253,45 +150,20 @@ namespace gfx::recordables
                 vertices.size(),
                 indicies.size()), 
             DrawStage::DisplayPass}
-        , transform {std::move(transform_)} // NOLINT: rvalue is needed
+        , transform {transform_}
         , number_of_vertices {vertices.size()}
         , number_of_indices {indicies.size()}
     {
-        this->future_vertex_buffer = std::async(
-            [lambdaVertices = std::move(vertices),
-             &allocator     = this->getAllocator(),
-             debugName      = static_cast<std::string>(*this)]
-            {
-                vulkan::Buffer vertexBuffer {
-                    &allocator,
-                    std::span {lambdaVertices}.size_bytes(),
-                    vk::BufferUsageFlagBits::eVertexBuffer,
-                    vk::MemoryPropertyFlagBits::eHostVisible
-                        | vk::MemoryPropertyFlagBits::eDeviceLocal,
-                    fmt::format("Vertex Buffer | {}", debugName)};
-
-                vertexBuffer.write(std::as_bytes(std::span {lambdaVertices}));
-
-                return vertexBuffer;
-            });
-
-        this->future_index_buffer = std::async(
-            [lambdaIndicies = std::move(indicies),
-             &allocator     = this->getAllocator(),
-             debugName      = static_cast<std::string>(*this)]
-            {
-                vulkan::Buffer indexBuffer {
-                    &allocator,
-                    std::span {lambdaIndicies}.size_bytes(),
-                    vk::BufferUsageFlagBits::eIndexBuffer,
-                    vk::MemoryPropertyFlagBits::eHostVisible
-                        | vk::MemoryPropertyFlagBits::eDeviceLocal,
-                    fmt::format("INdex Buffer | {}", debugName)};
-
-                indexBuffer.write(std::as_bytes(std::span {lambdaIndicies}));
+        this->future_vertex_buffer = this->uploadBuffer(
+            std::move(vertices),
+            vk::BufferUsageFlagBits::eVertexBuffer,
+            fmt::format(
+                "Vertex Buffer | {}", static_cast<std::string>(*this)));
 
-                return indexBuffer;
-            });
+        this->future_index_buffer = this->uploadBuffer(
+            std::move(indicies),
+            vk::BufferUsageFlagBits::eIndexBuffer,
+            fmt::format("Index Buffer | {}", static_cast<std::string>(*this)));
     }
 
 } // namespace gfx::recordables
@@ -5,6 +5,7 @@
 #include <boost/functional/hash.hpp>
 #include <compare>
 #include <future>
+#include <gfx/extrapolated.hpp>
 #include <gfx/vulkan/buffer.hpp>
 #include <util/threads.hpp>
 
@@ -78,7 +79,9 @@ namespace gfx::recordables
         void record(vk::CommandBuffer, vk::PipelineLayout, const Camera&)
             const override;
 
-        util::Mutex<Transform> transform;
+        // Published by the owning entity's tick, extrapolated to the time
+        // of each draw
+        Extrapolated<Transform> transform;
 
     private:
         std::pair<vulkan::PipelineCache::PipelineHandle, vk::PipelineBindPoint>
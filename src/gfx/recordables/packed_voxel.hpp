@@ -0,0 +1,57 @@
+#ifndef SRC_GFX_RECORDABLES_PACKED_VOXEL_HPP
+#define SRC_GFX_RECORDABLES_PACKED_VOXEL_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace gfx::recordables
+{
+    /// The two words that ChunkRecordable::Vertex and
+    /// VoxelRecordable::Instance are made of, unpacked on the gpu by
+    /// shaders/include/packed_voxel.glsl. Both must change together.
+    ///
+    /// Position word:
+    /// [0, 27)  x, y, z, 9 bits each
+    /// [27, 32) free for the user of the word
+    ///
+    /// Color word:
+    /// [0, 24)  sRGB r, g, b
+    /// [24, 30) brightness
+    /// [30, 32) alpha
+
+    // Voxels along each axis that a packed position can address
+    inline constexpr std::uint32_t MaxPackedVoxelExtent {512};
+    // The bits of the position word above the position
+    inline constexpr std::uint32_t PackedVoxelPositionBits {27};
+
+    // Relative to the chunk's most negative voxel, in
+    // [0, MaxPackedVoxelExtent)
+    constexpr std::uint32_t
+    packVoxelPosition(std::array<std::uint32_t, 3> voxel) noexcept
+    {
+        return voxel[0] | (voxel[1] << 9) | (voxel[2] << 18);
+    }
+
+    // The brightness, [0, 1], is stored as its square root, which spends
+    // more of the 6 bits on dark corners where steps are easier to see.
+    // Alpha is rounded to the nearest quarter, at least one
+    inline std::uint32_t packVoxelColor(
+        std::array<std::uint8_t, 3> srgb,
+        float                       brightness,
+        float                       alpha) noexcept
+    {
+        const auto packedBrightness = static_cast<std::uint32_t>(std::lround(
+            std::sqrt(std::clamp(brightness, 0.0f, 1.0f)) * 63.0f));
+        const auto packedAlpha = static_cast<std::uint32_t>(
+            std::clamp(std::lround(alpha * 4.0f) - 1, 0L, 3L));
+
+        return static_cast<std::uint32_t>(srgb[0])
+             | (static_cast<std::uint32_t>(srgb[1]) << 8)
+             | (static_cast<std::uint32_t>(srgb[2]) << 16)
+             | (packedBrightness << 24) | (packedAlpha << 30);
+    }
+} // namespace gfx::recordables
+
+#endif // SRC_GFX_RECORDABLES_PACKED_VOXEL_HPP
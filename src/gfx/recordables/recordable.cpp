@@ -1,8 +1,11 @@
 #include "recordable.hpp"
 #include <gfx/renderer.hpp>
+#include <gfx/vulkan/allocator.hpp>
+#include <gfx/vulkan/device.hpp>
 #include <gfx/vulkan/image.hpp>
 #include <gfx/vulkan/pipelines.hpp>
 #include <ranges>
+#include <util/log.hpp>
 
 namespace gfx::recordables
 {
@@ -80,9 +83,9 @@ namespace gfx::recordables
     Recordable::operator std::string () const
     {
         return fmt::format(
-            "Object {} | ID: {} | Drawing?: {}",
+            "Object {} | @ {} | Drawing?: {}",
             this->name,
-            static_cast<std::string>(this->uuid),
+            static_cast<const void*>(this),
             this->shouldDraw());
     }
 
@@ -96,9 +99,14 @@ namespace gfx::recordables
         return this->should_draw.load(std::memory_order_acquire);
     }
 
-    util::UUID Recordable::getUUID() const
+    void Recordable::setCulled(bool isCulled) const
     {
-        return this->uuid;
+        this->is_culled.store(isCulled, std::memory_order_release);
+    }
+
+    bool Recordable::isCulled() const
+    {
+        return this->is_culled.load(std::memory_order_acquire);
     }
 
     vulkan::Allocator& Recordable::getAllocator() const
@@ -110,7 +118,7 @@ namespace gfx::recordables
         DrawStage                                      accessStage,
         std::function<void(const vulkan::RenderPass*)> func) const
     {
-        this->renderer.render_passes.readLock(
+        this->renderer.render_passes.read(
             [&](const Renderer::RenderPasses& passes)
             {
                 std::optional<const vulkan::RenderPass*> maybeRenderPass =
@@ -126,6 +134,117 @@ namespace gfx::recordables
             });
     }
 
+    vulkan::PipelineCache::PipelineHandle
+    Recordable::getOrCreateGraphicsPipeline(
+        const vulkan::PipelineCache&                              cache,
+        const util::Mutex<vulkan::PipelineCache::PipelineHandle>& cachedHandle,
+        const GraphicsPipelineDescription& description) const
+    {
+        return cachedHandle.lock(
+            [&](vulkan::PipelineCache::PipelineHandle& maybeHandle)
+            {
+                std::expected<
+                    const vulkan::Pipeline*,
+                    vulkan::PipelineCache::InvalidCacheHandle>
+                    result = cache.lookupPipeline(maybeHandle);
+
+                if (result.has_value())
+                {
+                    return maybeHandle;
+                }
+
+                // this *is* a double read lock...
+                this->accessRenderPass(
+                    this->stage,
+                    [&](const vulkan::RenderPass* renderPass) -> void
+                    {
+                        const vk::Device device =
+                            this->getAllocator()
+                                .getOwningDevice()
+                                ->asLogicalDevice();
+
+                        vk::UniqueShaderModule fragmentShader =
+                            vulkan::createShaderFromFile(
+                                device,
+                                fmt::format(
+                                    "src/gfx/vulkan/shaders/{}",
+                                    description.fragment_shader)
+                                    .c_str());
+                        vk::UniqueShaderModule vertexShader =
+                            vulkan::createShaderFromFile(
+                                device,
+                                fmt::format(
+                                    "src/gfx/vulkan/shaders/{}",
+                                    description.vertex_shader)
+                                    .c_str());
+
+                        std::array pipelineShaders {
+                            std::pair {
+                                vk::ShaderStageFlagBits::eFragment,
+                                *fragmentShader},
+                            std::pair {
+                                vk::ShaderStageFlagBits::eVertex,
+                                *vertexShader}};
+
+                        const vk::PipelineVertexInputStateCreateInfo
+                            vertexInput {
+                                .sType {
+                                    vk::StructureType::
+                                        ePipelineVertexInputStateCreateInfo},
+                                .pNext {nullptr},
+                                .flags {},
+                                .vertexBindingDescriptionCount {1},
+                                .pVertexBindingDescriptions {
+                                    description.vertex_binding},
+                                .vertexAttributeDescriptionCount {
+                                    static_cast<std::uint32_t>(
+                                        description.vertex_attributes.size())},
+                                .pVertexAttributeDescriptions {
+                                    description.vertex_attributes.data()},
+                            };
+
+                        std::unique_ptr<vulkan::Pipeline> newPipeline {
+                            new vulkan::GraphicsPipeline {
+                                this->renderer,
+                                renderPass,
+                                pipelineShaders,
+                                vertexInput,
+                                description.topology,
+                                {},
+                                std::array {vk::PushConstantRange {
+                                    .stageFlags {
+                                        vk::ShaderStageFlagBits::eVertex},
+                                    .offset {0},
+                                    .size {description.push_constants_size},
+                                }},
+                                description.name}};
+
+                        util::logDebug(
+                            "Created Pipeline @ {}",
+                            static_cast<const void*>(newPipeline.get()));
+
+                        maybeHandle =
+                            cache.cachePipeline(std::move(newPipeline));
+                    });
+
+                return maybeHandle;
+            });
+    }
+
+    bool Recordable::tryResolveBuffer(
+        std::optional<std::future<vulkan::Buffer>>& futureBuffer,
+        std::optional<vulkan::Buffer>&              buffer)
+    {
+        if (futureBuffer.has_value() && futureBuffer->valid())
+        {
+            buffer = futureBuffer->get();
+
+            futureBuffer = std::nullopt;
+        }
+
+        return buffer.has_value();
+    }
+
     void Recordable::registerSelf()
     {
         this->renderer.registerRecordable(this->shared_from_this());
@@ -139,9 +258,9 @@ namespace gfx::recordables
         bool                 shouldDraw)
         : renderer {renderer_}
         , name {std::move(name_)}
-        , uuid {util::UUID {}}
         , stage {stage_}
         , should_draw {shouldDraw}
+        , is_culled {false}
         , sets {sets_}
     {}
 
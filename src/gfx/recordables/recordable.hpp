@@ -3,10 +3,16 @@
 
 #include <array>
 #include <functional>
+#include <future>
 #include <gfx/camera.hpp>
 #include <gfx/draw_stages.hpp>
+#include <gfx/vulkan/buffer.hpp>
 #include <gfx/vulkan/pipelines.hpp>
-#include <util/uuid.hpp>
+#include <optional>
+#include <span>
+#include <string>
+#include <util/threads.hpp>
+#include <vector>
 #include <vulkan/vulkan_format_traits.hpp>
 #include <vulkan/vulkan_handles.hpp>
 
@@ -50,11 +56,16 @@ namespace gfx::recordables
         virtual void
         record(vk::CommandBuffer, vk::PipelineLayout, const Camera&) const = 0;
 
-        std::strong_ordering     operator<=> (const Recordable&) const;
-        [[nodiscard]] explicit   operator std::string () const;
-        [[nodiscard]] DrawStage  getDrawStage() const;
-        [[nodiscard]] bool       shouldDraw() const;
-        [[nodiscard]] util::UUID getUUID() const;
+        std::strong_ordering    operator<=> (const Recordable&) const;
+        [[nodiscard]] explicit  operator std::string () const;
+        [[nodiscard]] DrawStage getDrawStage() const;
+        [[nodiscard]] bool      shouldDraw() const;
+
+        /// Culled recordables are skipped for the frame, independently of
+        /// shouldDraw(), so that whoever owns them may hide them while
+        /// they're still loading
+        void               setCulled(bool) const;
+        [[nodiscard]] bool isCulled() const;
 
     protected:
         // TODO: combine allocator into master class of memory, descriptor,
@@ -69,13 +80,69 @@ namespace gfx::recordables
             DrawStage                                      accessStage,
             std::function<void(const vulkan::RenderPass*)> func) const;
 
+        struct GraphicsPipelineDescription
+        {
+            // Compiled shaders, relative to src/gfx/vulkan/shaders/
+            const char*                                 vertex_shader;
+            const char*                                 fragment_shader;
+            const vk::VertexInputBindingDescription*    vertex_binding;
+            std::span<const vk::VertexInputAttributeDescription>
+                                                        vertex_attributes;
+            vk::PrimitiveTopology                       topology;
+            // Visible to the vertex shader only
+            std::uint32_t                               push_constants_size;
+            const char*                                 name;
+        };
+
+        // The pipeline in cachedHandle, which is shared by every recordable
+        // of a type. Whenever the cache doesn't have it, e.g. after the
+        // cache is recreated, it's created from the description again
+        vulkan::PipelineCache::PipelineHandle getOrCreateGraphicsPipeline(
+            const vulkan::PipelineCache&,
+            const util::Mutex<vulkan::PipelineCache::PipelineHandle>&
+                                               cachedHandle,
+            const GraphicsPipelineDescription&) const;
+
+        // Creates and fills a host visible device buffer on another thread
+        template<class T>
+        [[nodiscard]] std::future<vulkan::Buffer> uploadBuffer(
+            std::vector<T>       data,
+            vk::BufferUsageFlags usage,
+            std::string          debugName) const
+        {
+            return std::async(
+                [lambdaData = std::move(data),
+                 &allocator = this->getAllocator(),
+                 usage,
+                 lambdaName = std::move(debugName)]
+                {
+                    vulkan::Buffer buffer {
+                        &allocator,
+                        std::span {lambdaData}.size_bytes(),
+                        usage,
+                        vk::MemoryPropertyFlagBits::eHostVisible
+                            | vk::MemoryPropertyFlagBits::eDeviceLocal,
+                        lambdaName};
+
+                    buffer.write(std::as_bytes(std::span {lambdaData}));
+
+                    return buffer;
+                });
+        }
+
+        // Moves the buffer out of the future once it's ready, returns
+        // whether there's a buffer
+        static bool tryResolveBuffer(
+            std::optional<std::future<vulkan::Buffer>>& futureBuffer,
+            std::optional<vulkan::Buffer>&              buffer);
+
         void registerSelf();
 
         const Renderer&           renderer;
         const std::string         name;
-        const util::UUID          uuid;
         const DrawStage           stage;
         mutable std::atomic<bool> should_draw;
+        mutable std::atomic<bool> is_culled;
 
         /// You must manage the lifetime on the descriptors
         Recordable(
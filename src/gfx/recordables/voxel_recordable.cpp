@@ -0,0 +1,134 @@
+#include "voxel_recordable.hpp"
+#include <atomic>
+#include <gfx/vulkan/allocator.hpp>
+#include <gfx/vulkan/buffer.hpp>
+#include <gfx/vulkan/device.hpp>
+#include <gfx/vulkan/pipelines.hpp>
+#include <util/log.hpp>
+
+namespace gfx::recordables
+{
+
+    const vk::VertexInputBindingDescription*
+    VoxelRecordable::Instance::getBindingDescription()
+    {
+        static const vk::VertexInputBindingDescription bindings {
+            .binding {0},
+            .stride {sizeof(Instance)},
+            .inputRate {vk::VertexInputRate::eInstance},
+        };
+
+        return &bindings;
+    }
+
+    const std::array<vk::VertexInputAttributeDescription, 1>*
+    VoxelRecordable::Instance::getAttributeDescriptions()
+    {
+        static const std::array<vk::VertexInputAttributeDescription, 1>
+            descriptions {vk::VertexInputAttributeDescription {
+                .location {0},
+                .binding {0},
+                .format {vk::Format::eR32G32Uint},
+                .offset {0},
+            }};
+
+        return &descriptions;
+    }
+
+    std::shared_ptr<VoxelRecordable> VoxelRecordable::create(
+        const gfx::Renderer&  renderer_,
+        std::vector<Instance> instances,
+        Transform             transform_,
+        std::string           name_)
+    {
+        std::shared_ptr<VoxelRecordable> recordable {new VoxelRecordable {
+            renderer_, std::move(instances), transform_, std::move(name_)}};
+
+        recordable->registerSelf();
+
+        return recordable;
+    }
+
+    void VoxelRecordable::updateFrameState() const
+    {
+        if (tryResolveBuffer(
+                this->future_instance_buffer, this->instance_buffer)
+            && !this->shouldDraw())
+        {
+            this->should_draw.store(true, std::memory_order::release);
+        }
+    }
+
+    void VoxelRecordable::record(
+        vk::CommandBuffer  commandBuffer,
+        vk::PipelineLayout layout,
+        const Camera&      camera) const
+    {
+        util::assertFatal(
+            this->instance_buffer.has_value(),
+            "buffers weren't valid when drawing occurred");
+
+        commandBuffer.bindVertexBuffers(
+            0, **this->instance_buffer, {0}); // NOLINT
+
+        PushConstants pushConstants {
+            .model_view_proj {camera.getPerspectiveMatrix(
+                this->renderer, this->transform.copyInner())}};
+
+        commandBuffer.pushConstants<PushConstants>(
+            layout, vk::ShaderStageFlagBits::eVertex, 0, pushConstants);
+
+        // One triangle strip around a cube per instance, see voxel.vert
+        commandBuffer.draw(
+            14, static_cast<std::uint32_t>(this->number_of_instances), 0, 0);
+    }
+
+    std::pair<vulkan::PipelineCache::PipelineHandle, vk::PipelineBindPoint>
+    VoxelRecordable::getPipeline(const vulkan::PipelineCache& cache) const
+    {
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wexit-time-destructors"
+        static util::Mutex<vulkan::PipelineCache::PipelineHandle>
+            maybeHandleMutex {}; // NOLINT
+#pragma clang diagnostic pop
+
+        const vulkan::PipelineCache::PipelineHandle handle =
+            this->getOrCreateGraphicsPipeline(
+                cache,
+                maybeHandleMutex,
+                GraphicsPipelineDescription {
+                    .vertex_shader {"voxel.vert.bin"},
+                    .fragment_shader {"voxel.frag.bin"},
+                    .vertex_binding {Instance::getBindingDescription()},
+                    .vertex_attributes {*Instance::getAttributeDescriptions()},
+                    .topology {vk::PrimitiveTopology::eTriangleStrip},
+                    .push_constants_size {sizeof(PushConstants)},
+                    .name {"VoxelRecordable"},
+                });
+
+        return {handle, vk::PipelineBindPoint::eGraphics};
+    }
+
+    VoxelRecordable::VoxelRecordable(
+        const gfx::Renderer&  renderer_,
+        std::vector<Instance> instances,
+        Transform             transform_,
+        std::string           name_)
+        : Recordable {
+            renderer_,
+            fmt::format(
+                "VoxelRecordable | {} | Instances: {}",
+                name_,
+                instances.size()),
+            DrawStage::DisplayPass}
+        , transform {transform_}
+        , number_of_instances {instances.size()}
+    {
+        this->future_instance_buffer = this->uploadBuffer(
+            std::move(instances),
+            vk::BufferUsageFlagBits::eVertexBuffer,
+            fmt::format(
+                "Instance Buffer | {}", static_cast<std::string>(*this)));
+    }
+
+} // namespace gfx::recordables
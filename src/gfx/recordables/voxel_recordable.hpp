@@ -0,0 +1,96 @@
+#ifndef SRC_GFX_RECORDABLES_VOXEL_RECORDABLE_HPP
+#define SRC_GFX_RECORDABLES_VOXEL_RECORDABLE_HPP
+
+#include "packed_voxel.hpp"
+#include "recordable.hpp"
+#include <array>
+#include <cstdint>
+#include <future>
+#include <gfx/vulkan/buffer.hpp>
+#include <util/threads.hpp>
+
+namespace gfx::recordables
+{
+    /// A chunk's voxels drawn as instanced cubes, one 8 byte Instance per
+    /// voxel. voxel.vert builds each cube's triangle strip from
+    /// gl_VertexIndex, so nothing but the instances is uploaded. The
+    /// alternative to meshing a chunk into a ChunkRecordable.
+    class VoxelRecordable final : public Recordable
+    {
+    public:
+        struct Instance
+        {
+            struct Unpacked
+            {
+                // Relative to the chunk's most negative voxel, in
+                // [0, MaxPackedVoxelExtent)
+                std::array<std::uint32_t, 3> voxel;
+
+                std::array<std::uint8_t, 3> srgb;
+                // Light, [0, 1]
+                float                       brightness;
+                float                       alpha;
+            };
+
+            static Instance pack(const Unpacked& u) noexcept
+            {
+                return Instance {
+                    .voxel {packVoxelPosition(u.voxel)},
+                    .color_light_alpha {
+                        packVoxelColor(u.srgb, u.brightness, u.alpha)},
+                };
+            }
+
+            // A packed voxel position and color, see packed_voxel.hpp
+            std::uint32_t voxel;
+            std::uint32_t color_light_alpha;
+
+            bool operator== (const Instance&) const = default;
+
+            static const vk::VertexInputBindingDescription*
+            getBindingDescription();
+
+            static const std::array<vk::VertexInputAttributeDescription, 1>*
+            getAttributeDescriptions();
+        };
+
+        static_assert(sizeof(Instance) == 8);
+
+        struct PushConstants
+        {
+            glm::mat4 model_view_proj;
+        };
+    public:
+
+        static std::shared_ptr<VoxelRecordable> create(
+            const gfx::Renderer&,
+            std::vector<Instance>,
+            Transform,
+            std::string name);
+        ~VoxelRecordable() override = default;
+
+        void updateFrameState() const override;
+        void record(vk::CommandBuffer, vk::PipelineLayout, const Camera&)
+            const override;
+
+        // Published by the owning chunk, read once per draw
+        util::SeqLock<Transform> transform;
+
+    private:
+        std::pair<vulkan::PipelineCache::PipelineHandle, vk::PipelineBindPoint>
+        getPipeline(const vulkan::PipelineCache&) const override;
+
+        mutable std::optional<std::future<gfx::vulkan::Buffer>>
+                                                   future_instance_buffer;
+        std::size_t                                number_of_instances;
+        mutable std::optional<gfx::vulkan::Buffer> instance_buffer;
+
+        VoxelRecordable(
+            const gfx::Renderer&,
+            std::vector<Instance>,
+            Transform,
+            std::string name);
+    };
+} // namespace gfx::recordables
+
+#endif // SRC_GFX_RECORDABLES_VOXEL_RECORDABLE_HPP
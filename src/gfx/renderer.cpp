@@ -79,11 +79,12 @@ namespace gfx
         , allocator {std::make_unique<vulkan::Allocator>(
               *this->instance, &*this->device)}
         , swapchain {nullptr}
-        , render_passes {RenderPasses {}} // , debug_menu {nullptr}
+        , render_passes {std::make_unique<RenderPasses>()}
         , draw_camera {Camera {{0.0f, 0.0f, 0.0f}}}
         , is_cursor_attached {true}
+        , rebase_lock {}
     {
-        this->initializeRenderer(std::nullopt);
+        this->initializeRenderer();
 
         this->window->attachCursor();
 
@@ -168,9 +169,10 @@ namespace gfx
         return static_cast<float>(width) / static_cast<float>(height);
     }
 
-    void Renderer::setCamera(Camera c)
+    void Renderer::setCamera(
+        Camera c, std::chrono::steady_clock::time_point tickTime)
     {
-        this->draw_camera = c;
+        this->draw_camera.publish(c, tickTime);
     }
 
     bool Renderer::continueTicking()
@@ -185,37 +187,49 @@ namespace gfx
             std::vector<std::shared_ptr<const recordables::Recordable>>
                 renderables = [&]
             {
-                std::vector<util::UUID> weakRecordablesToRemove {};
+                std::vector<util::Registrar<
+                    std::weak_ptr<const recordables::Recordable>>::Handle>
+                    weakRecordablesToRemove {};
 
                 std::vector<std::shared_ptr<const recordables::Recordable>>
                                                strongMaybeDrawRenderables {};
                 std::vector<std::future<void>> maybeDrawStateUpdateFutures {};
 
+                this->recordable_registry.flush();
+
+                strongMaybeDrawRenderables.reserve(
+                    this->recordable_registry.size());
+                maybeDrawStateUpdateFutures.reserve(
+                    this->recordable_registry.size());
+
                 // Collect the strong
-                for (const auto& [weakUUID, weakRecordable] :
-                     this->recordable_registry.access())
-                {
-                    if (std::shared_ptr<const recordables::Recordable>
-                            recordable = weakRecordable.lock())
-                    {
-                        maybeDrawStateUpdateFutures.push_back(std::async(
-                            [rawRecordable = recordable.get()]
-                            {
-                                rawRecordable->updateFrameState();
-                            }));
-                        strongMaybeDrawRenderables.push_back(
-                            std::move(recordable));
-                    }
-                    else
+                this->recordable_registry.visit(
+                    [&](util::Registrar<std::weak_ptr<
+                            const recordables::Recordable>>::Handle weakHandle,
+                        const std::weak_ptr<const recordables::Recordable>&
+                            weakRecordable)
                     {
-                        weakRecordablesToRemove.push_back(weakUUID);
-                    }
-                }
+                        if (std::shared_ptr<const recordables::Recordable>
+                                recordable = weakRecordable.lock())
+                        {
+                            maybeDrawStateUpdateFutures.push_back(std::async(
+                                [rawRecordable = recordable.get()]
+                                {
+                                    rawRecordable->updateFrameState();
+                                }));
+                            strongMaybeDrawRenderables.push_back(
+                                std::move(recordable));
+                        }
+                        else
+                        {
+                            weakRecordablesToRemove.push_back(weakHandle);
+                        }
+                    });
 
                 // Purge the weak
-                for (const util::UUID& weakID : weakRecordablesToRemove)
+                for (auto weakHandle : weakRecordablesToRemove)
                 {
-                    this->recordable_registry.remove(weakID);
+                    this->recordable_registry.remove(weakHandle);
                 }
 
                 std::vector<std::shared_ptr<const recordables::Recordable>>
@@ -226,7 +240,8 @@ namespace gfx
                 for (std::shared_ptr<const recordables::Recordable>&
                          maybeDrawingRecordable : strongMaybeDrawRenderables)
                 {
-                    if (maybeDrawingRecordable->shouldDraw())
+                    if (maybeDrawingRecordable->shouldDraw()
+                        && !maybeDrawingRecordable->isCulled())
                     {
                         strongDrawingRenderables.push_back(
                             std::move(maybeDrawingRecordable));
@@ -266,7 +281,7 @@ namespace gfx
 
             //! I don't have to say this is bad, this is bad, but it's not a
             //! race!
-            this->render_passes.readLock(
+            this->render_passes.read(
                 [&](const RenderPasses& renderPasses)
                 {
                     for (auto& [stage, recordables] : stageMap)
@@ -287,13 +302,18 @@ namespace gfx
             //     recordables.size());
             // }
 
-            return this->render_passes.readLock(
+            return this->render_passes.read(
                 [&](const RenderPasses& renderPasses)
                 {
-                    return this->frame_manager->renderObjectsFromCamera(
-                        this->draw_camera,
-                        drawRecordables,
-                        *renderPasses.pipeline_cache);
+                    return this->rebase_lock.readLock(
+                        [&]
+                        {
+                            return this->frame_manager->renderObjectsFromCamera(
+                                this->draw_camera.sample(
+                                    Extrapolated<Camera>::Clock::now()),
+                                drawRecordables,
+                                *renderPasses.pipeline_cache);
+                        });
                 });
         }();
 
@@ -334,6 +354,8 @@ namespace gfx
                 state.fps = 1 / this->getFrameDeltaTimeSeconds();
             });
 
+        this->render_passes.reclaim();
+
         this->window->endFrame();
     }
 
@@ -365,34 +387,52 @@ namespace gfx
         this->window->blockThisThreadWhileMinimized();
         this->device->asLogicalDevice().waitIdle(); // stall TODO: make better?
 
-        this->render_passes.writeLock(
-            [&](RenderPasses& renderPasses)
-            {
-                // Destroy things that need to be recreated
-                {
-                    // this->debug_menu.reset();
-                    this->frame_manager.reset();
-
-                    renderPasses.pipeline_cache.reset();
-                    renderPasses.final_raster_pass.reset();
-                    renderPasses.voxel_discovery_image.reset();
-                    renderPasses.voxel_discovery_pass.reset();
-                    renderPasses.depth_buffer.reset();
+        // Destroy things that need to be recreated, the old render passes
+        // are destroyed when the new ones are published, or once the last
+        // reader of them is done
+        {
+            // this->debug_menu.reset();
+            this->frame_manager.reset();
 
-                    this->swapchain.reset();
-                }
+            this->swapchain.reset();
+        }
 
-                this->initializeRenderer(&renderPasses);
-            });
+        this->initializeRenderer();
     }
 
-    void Renderer::initializeRenderer(
-        std::optional<RenderPasses*> maybeWriteLockedRenderPass)
+    void Renderer::initializeRenderer()
     {
         this->swapchain = std::make_unique<vulkan::Swapchain>(
             *this->device, **this->surface, this->window->getFramebufferSize());
 
-        auto renderPassInitFunc = [&](RenderPasses& renderPasses)
+        std::unique_ptr<RenderPasses> renderPasses = this->createRenderPasses();
+
+        this->frame_manager = std::make_unique<vulkan::FrameManager>(
+            &*this->device,
+            &*this->swapchain,
+            *renderPasses->depth_buffer,
+            **renderPasses->final_raster_pass);
+
+        // if (this->debug_menu == nullptr)
+        // {
+        //     this->debug_menu = recordables::DebugMenu::create(
+        //         *this,
+        //         *this->instance,
+        //         *this->device,
+        //         *this->window,
+        //         **renderPasses->final_raster_pass);
+        // }
+
+        this->render_passes.publish(std::move(renderPasses));
+
+        util::logTrace("Finished initialization of renderer");
+    }
+
+    std::unique_ptr<Renderer::RenderPasses> Renderer::createRenderPasses()
+    {
+        std::unique_ptr<RenderPasses> output = std::make_unique<RenderPasses>();
+        RenderPasses&                 renderPasses = *output;
+
         {
             renderPasses.depth_buffer = std::make_unique<vulkan::Image2D>(
                 &*this->allocator,
@@ -645,41 +685,15 @@ namespace gfx
             }
             renderPasses.pipeline_cache =
                 std::make_unique<vulkan::PipelineCache>();
-
-            this->frame_manager = std::make_unique<vulkan::FrameManager>(
-                &*this->device,
-                &*this->swapchain,
-                *renderPasses.depth_buffer,
-                **renderPasses.final_raster_pass);
-
-            // if (this->debug_menu == nullptr)
-            // {
-            //     this->debug_menu = recordables::DebugMenu::create(
-            //         *this,
-            //         *this->instance,
-            //         *this->device,
-            //         *this->window,
-            //         **renderPasses.final_raster_pass);
-            // }
-        };
-
-        if (maybeWriteLockedRenderPass.has_value())
-        {
-            renderPassInitFunc(**maybeWriteLockedRenderPass);
-        }
-        else
-        {
-            this->render_passes.writeLock(renderPassInitFunc);
         }
 
-        util::logTrace("Finished initialization of renderer");
+        return output;
     }
 
     void Renderer::registerRecordable(
         const std::shared_ptr<const recordables::Recordable>& objectToRegister)
         const
     {
-        this->recordable_registry.insert(
-            {objectToRegister->getUUID(), std::weak_ptr {objectToRegister}});
+        this->recordable_registry.insert(std::weak_ptr {objectToRegister});
     }
 } // namespace gfx
@@ -2,13 +2,15 @@
 #define SRC_GFX_RENDERER_HPP
 
 #include "camera.hpp"
+#include "extrapolated.hpp"
 #include "recordables/debug_menu.hpp"
 #include "window.hpp"
+#include <concepts>
 #include <gfx/vulkan/render_pass.hpp>
 #include <memory>
+#include <util/epoch.hpp>
 #include <util/registrar.hpp>
 #include <util/threads.hpp>
-#include <util/uuid.hpp>
 #include <vulkan/vulkan_format_traits.hpp>
 #include <vulkan/vulkan_handles.hpp>
 
@@ -64,7 +66,22 @@ namespace gfx
         [[nodiscard]] float getFovXRadians() const;
         [[nodiscard]] float getAspectRatio() const;
 
-        void               setCamera(Camera);
+        // The camera moves smoothly from the last one set to this, tickTime
+        // is when the tick that moved it was scheduled
+        void setCamera(Camera, std::chrono::steady_clock::time_point tickTime);
+        // Jumps straight to this camera after running `republish`, which
+        // must publish everything that the rebase moved. No frame draws some
+        // of it moved and some of it not, frames in flight finish first
+        void rebase(Camera c, std::invocable<> auto republish)
+        {
+            this->rebase_lock.writeLock(
+                [&]
+                {
+                    republish();
+
+                    this->draw_camera.reset(c);
+                });
+        }
         [[nodiscard]] bool continueTicking();
         void               drawFrame();
         void               waitIdle();
@@ -81,9 +98,9 @@ namespace gfx
         // Pre-renderpass Rendering objects
         std::unique_ptr<vulkan::Swapchain> swapchain;
 
-        // basically on resize we need the game thread to stall, however as many
-        // game threads can work on this at once. we're solving this with an
-        // RwLock, write is the resize
+        // Replaced wholesale on resize. Readers, i.e. drawFrame and every
+        // Recordable, never block and the old passes are destroyed once the
+        // last reader that could see them is done
         struct RenderPasses // TODO: change to RenderPassCriticalSection
         {
             std::unique_ptr<vulkan::Image2D> depth_buffer;
@@ -105,27 +122,29 @@ namespace gfx
 
         std::unique_ptr<vulkan::FrameManager> frame_manager;
 
-        util::RwLock<RenderPasses> render_passes;
+        util::EpochPublished<RenderPasses> render_passes;
 
         // Objects
         // std::shared_ptr<recordables::DebugMenu> debug_menu;
-        util::
-            Registrar<util::UUID, std::weak_ptr<const recordables::Recordable>>
-                recordable_registry;
+        util::Registrar<std::weak_ptr<const recordables::Recordable>>
+            recordable_registry;
 
         // State
         util::Mutex<recordables::DebugMenu::State> debug_menu_state;
-        std::atomic<Camera>                        draw_camera;
+        Extrapolated<Camera>                       draw_camera;
         bool                                       is_cursor_attached;
 
+        // Held shared while a frame samples the camera and every transform,
+        // and exclusively while a rebase republishes them
+        util::RwLock<> rebase_lock;
+
         friend vulkan::GraphicsPipeline;
         friend vulkan::ComputePipeline;
         friend recordables::DebugMenu;
-        [[nodiscard]] util::RwLock<RenderPasses> getRenderPasses() const;
 
-        void resize();
-        void initializeRenderer(
-            std::optional<RenderPasses*> maybeWriteLockedRenderPass);
+        void                          resize();
+        void                          initializeRenderer();
+        std::unique_ptr<RenderPasses> createRenderPasses();
 
         friend recordables::Recordable;
         void registerRecordable(
@@ -66,4 +66,14 @@ namespace gfx
             glm::to_string(this->scale));
     }
 
+    Transform blend(const Transform& from, const Transform& to, float t)
+    {
+        return Transform {
+            .translation {
+                from.translation + ((to.translation - from.translation) * t)},
+            .rotation {
+                glm::normalize(glm::slerp(from.rotation, to.rotation, t))},
+            .scale {from.scale + ((to.scale - from.scale) * t)}};
+    }
+
 } // namespace gfx
@@ -37,6 +37,10 @@ namespace gfx
         explicit operator std::string () const;
     };
 
+    // from at 0 and to at 1, past 1 it keeps moving at the same rate
+    [[nodiscard]] Transform
+    blend(const Transform& from, const Transform& to, float t);
+
 } // namespace gfx
 
 #endif // SRC_GFX_TRANSFORM_HPP
@@ -302,6 +302,7 @@ namespace gfx::vulkan
                 }
             }
 
+            // main() rate limits this line, keep it in step if this moves
             util::logWarn(
                 "All queues of type {} are full!", vk::to_string(flags));
         }
@@ -347,7 +348,8 @@ namespace gfx::vulkan
                 std::move(
                     device
                         .allocateCommandBuffersUnique(commandBufferAllocateInfo)
-                        .at(0)));
+                        .at(0)),
+                std::source_location::current());
     }
 
     bool Queue::tryAccess(
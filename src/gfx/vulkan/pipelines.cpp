@@ -8,6 +8,9 @@
 
 namespace
 {
+    // 0 is reserved for null handles
+    std::atomic<std::uint32_t> NEXT_PIPELINE_CACHE_ID {1}; // NOLINT
+
     template<class T>
     T* getValueOrNullptr(std::optional<T>& oT)
     {
@@ -61,20 +64,29 @@ namespace gfx::vulkan
     }
 
     PipelineCache::PipelineCache()
-        : next_free_id {0}
+        : cache {PipelineSlotMap {}}
+        , cache_id {
+              NEXT_PIPELINE_CACHE_ID.fetch_add(1, std::memory_order_relaxed)}
     {}
 
     PipelineCache::PipelineHandle
     PipelineCache::cachePipeline(std::unique_ptr<Pipeline> pipeline) const
     {
-        PipelineHandle handle {util::UUID {}};
+        const void* rawPipeline = pipeline.get();
 
-        util::logDebug(
-            "Cached new pipeline {} @ {}",
-            static_cast<const void*>(pipeline.get()),
-            static_cast<std::string>(*handle.getID()));
+        PipelineHandle handle {
+            this->cache_id,
+            this->cache.writeLock(
+                [&](PipelineSlotMap& slotMap)
+                {
+                    return slotMap.insert(std::move(pipeline));
+                })};
 
-        this->cache.insert({handle, std::move(pipeline)});
+        util::logDebug(
+            "Cached new pipeline {} @ {}:{}",
+            rawPipeline,
+            handle.id.index,
+            handle.id.generation);
 
         return handle;
     }
@@ -82,26 +94,28 @@ namespace gfx::vulkan
     std::expected<const Pipeline*, PipelineCache::InvalidCacheHandle>
     PipelineCache::lookupPipeline(PipelineHandle handle) const
     {
-        const Pipeline* stablePipeline {nullptr};
-        std::size_t     visits = 0;
+        if (handle.cache_id != this->cache_id)
+        {
+            return std::unexpected(InvalidCacheHandle {});
+        }
 
-        this->cache.visit(
-            handle,
-            [&](const auto& input)
+        // the pipeline itself is behind a unique_ptr, so it's stable even if
+        // the slot map reallocates after the lock is released
+        const Pipeline* stablePipeline = this->cache.readLock(
+            [&](const PipelineSlotMap& slotMap) -> const Pipeline*
             {
-                // get the pipeline, second: unique_ptr<Pipeline>
-                stablePipeline = input.second.get();
+                const std::unique_ptr<Pipeline>* maybePipeline =
+                    slotMap.lookup(handle.id);
 
-                ++visits;
+                return maybePipeline != nullptr ? maybePipeline->get()
+                                                : nullptr;
             });
 
-        if (visits == 0)
+        if (stablePipeline == nullptr)
         {
             return std::unexpected(InvalidCacheHandle {});
         }
 
-        util::assertFatal(visits == 1, "Pipeline hash collision");
-
         // util::logDebug(
         //     " Pipeline Lookup | addr {}",
         //     static_cast<const void*>(stablePipeline));
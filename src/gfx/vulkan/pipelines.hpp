@@ -1,11 +1,10 @@
 #ifndef SRC_GFX_VULKAN_PIPELINE_HPP
 #define SRC_GFX_VULKAN_PIPELINE_HPP
 
-#include <boost/unordered/concurrent_flat_map.hpp>
 #include <expected>
 #include <gfx/draw_stages.hpp>
+#include <util/slot_map.hpp>
 #include <util/threads.hpp>
-#include <util/uuid.hpp>
 #include <vulkan/vulkan_format_traits.hpp>
 #include <vulkan/vulkan_handles.hpp>
 
@@ -30,21 +29,28 @@ namespace gfx::vulkan
 
     class PipelineCache
     {
+        using PipelineSlotMap = util::SlotMap<std::unique_ptr<Pipeline>>;
     public:
         struct PipelineHandle
         {
             PipelineHandle()
-                : id {std::nullopt}
+                : cache_id {0}
+                , id {}
             {}
 
             [[nodiscard]] bool isValid() const
             {
-                return this->id.has_value();
+                return !this->id.isNull();
             }
 
-            [[nodiscard]] std::optional<util::UUID> getID() const
+            [[nodiscard]] std::optional<PipelineSlotMap::Handle> getID() const
             {
-                return this->id;
+                if (this->isValid())
+                {
+                    return this->id;
+                }
+
+                return std::nullopt;
             }
 
             std::strong_ordering
@@ -52,11 +58,16 @@ namespace gfx::vulkan
         private:
             friend class PipelineCache;
 
-            explicit PipelineHandle(util::UUID newID)
-                : id {newID}
+            explicit PipelineHandle(
+                std::uint32_t cacheID, PipelineSlotMap::Handle newID)
+                : cache_id {cacheID}
+                , id {newID}
             {}
 
-            std::optional<util::UUID> id;
+            // Caches are recreated on resize, this keeps handles from an old
+            // cache from aliasing pipelines in the new one
+            std::uint32_t           cache_id;
+            PipelineSlotMap::Handle id;
         };
     public:
 
@@ -79,10 +90,9 @@ namespace gfx::vulkan
             std::unordered_map<DrawStage, vk::RenderPass>, const Swapchain&);
 
     private:
-        mutable std::atomic<std::size_t> next_free_id;
-        mutable boost::unordered::
-            concurrent_flat_map<PipelineHandle, std::unique_ptr<Pipeline>>
-                cache;
+        // Pipelines are cached rarely and looked up for every draw
+        util::RwLock<PipelineSlotMap> cache;
+        std::uint32_t                 cache_id;
     };
 
     class Pipeline
@@ -148,23 +158,4 @@ namespace gfx::vulkan
 
 } // namespace gfx::vulkan
 
-namespace gfx::vulkan
-{
-
-    inline std::size_t hash_value(
-        const gfx::vulkan::PipelineCache::PipelineHandle& handle) // NOLINT
-    {
-        std::optional<util::UUID> id = handle.getID();
-
-        if (id.has_value())
-        {
-            return boost::hash<util::UUID> {}(*id);
-        }
-        else
-        {
-            return boost::hash<nullptr_t> {}(nullptr);
-        }
-    }
-} // namespace gfx::vulkan
-
 #endif // SRC_GFX_VULKAN_PIPELINE_HPP
@@ -0,0 +1,71 @@
+#version 460
+
+#include <packed_voxel.glsl>
+
+// A ChunkRecordable::Vertex
+layout(location = 0) in uvec2 in_packed;
+
+layout(push_constant) uniform PushConstants
+{
+    mat4 model_view_proj;
+}
+in_push_constants;
+
+layout(location = 0) out vec4 out_color;
+
+// Same order as CubeFaces in sparse_volume.cpp
+const ivec3 FACE_NORMALS[6] = {
+    ivec3(1, 0, 0),
+    ivec3(-1, 0, 0),
+    ivec3(0, 1, 0),
+    ivec3(0, -1, 0),
+    ivec3(0, 0, 1),
+    ivec3(0, 0, -1),
+};
+
+const ivec3 FACE_TANGENTS[6] = {
+    ivec3(0, 1, 0),
+    ivec3(0, 0, 1),
+    ivec3(0, 0, 1),
+    ivec3(1, 0, 0),
+    ivec3(1, 0, 0),
+    ivec3(0, 1, 0),
+};
+
+const ivec3 FACE_BITANGENTS[6] = {
+    ivec3(0, 0, 1),
+    ivec3(0, 1, 0),
+    ivec3(1, 0, 0),
+    ivec3(0, 0, 1),
+    ivec3(0, 1, 0),
+    ivec3(1, 0, 0),
+};
+
+// Same order as CornerSigns in sparse_volume.cpp, (tangent, bitangent)
+const ivec2 CORNER_SIGNS[4] = {
+    ivec2(-1, -1),
+    ivec2(1, -1),
+    ivec2(1, 1),
+    ivec2(-1, 1),
+};
+
+void main()
+{
+    const uint voxelFaceCorner = in_packed.x;
+
+    const ivec3 voxel  = unpackVoxelPosition(voxelFaceCorner);
+    const uint  face   = bitfieldExtract(voxelFaceCorner, 27, 3);
+    const ivec2 corner = CORNER_SIGNS[bitfieldExtract(voxelFaceCorner, 30, 2)];
+
+    // Voxels are centered on their position
+    const vec3 position =
+        vec3(voxel)
+        + vec3(
+              FACE_NORMALS[face] + FACE_TANGENTS[face] * corner.x
+              + FACE_BITANGENTS[face] * corner.y)
+              / 2.0;
+
+    gl_Position = in_push_constants.model_view_proj * vec4(position, 1.0);
+
+    out_color = unpackVoxelColor(in_packed.y);
+}
@@ -1,9 +1,10 @@
 #ifndef SRC_GFX_VULKAN_SHADERS_INCLUDE_INTERSECTABLES_VOXEL_BRICK_DEF_GLSL
 #define SRC_GFX_VULKAN_SHADERS_INCLUDE_INTERSECTABLES_VOXEL_BRICK_DEF_GLSL
 
+#include <volume_extents.h>
 #include <voxel.glsl>
 
-const uint VoxelBrick_EdgeLength = 8;
+const uint VoxelBrick_EdgeLength = VERDIGRIS_BRICK_EXTENT;
 struct VoxelBrick
 {
     Voxel[VoxelBrick_EdgeLength][VoxelBrick_EdgeLength]
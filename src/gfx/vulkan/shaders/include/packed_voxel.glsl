@@ -0,0 +1,39 @@
+#ifndef SRC_GFX_VULKAN_SHADERS_INCLUDE_PACKED_VOXEL_GLSL
+#define SRC_GFX_VULKAN_SHADERS_INCLUDE_PACKED_VOXEL_GLSL
+
+#include <volume_extents.h>
+
+// Unpacks the words written by gfx/recordables/packed_voxel.hpp, both must
+// change together
+
+const int PACKED_VOXEL_MINIMUM =
+    -(VERDIGRIS_BRICK_EXTENT * VERDIGRIS_CHUNK_EXTENT) / 2;
+
+// The voxel's position in the chunk, bits [27, 32) are ignored
+ivec3 unpackVoxelPosition(const uint positionWord)
+{
+    return ivec3(
+               bitfieldExtract(positionWord, 0, 9),
+               bitfieldExtract(positionWord, 9, 9),
+               bitfieldExtract(positionWord, 18, 9))
+         + ivec3(PACKED_VOXEL_MINIMUM);
+}
+
+// Linear color, with the brightness applied
+vec4 unpackVoxelColor(const uint colorWord)
+{
+    const vec3 srgb =
+        vec3(
+            bitfieldExtract(colorWord, 0, 8),
+            bitfieldExtract(colorWord, 8, 8),
+            bitfieldExtract(colorWord, 16, 8))
+        / 255.0;
+    // stored as its square root
+    const float brightness = float(bitfieldExtract(colorWord, 24, 6)) / 63.0;
+    const float alpha = float(bitfieldExtract(colorWord, 30, 2) + 1u) / 4.0;
+
+    // Same curve as util::convertSRGBToLinear
+    return vec4(pow(srgb, vec3(2.4)) * brightness * brightness, alpha);
+}
+
+#endif // SRC_GFX_VULKAN_SHADERS_INCLUDE_PACKED_VOXEL_GLSL
@@ -6,6 +6,8 @@
 
 #include "util.glsl"
 
+// Mirrors game::world::Voxel byte for byte, a buffer of these must be std430
+// so that its array stride is 8
 struct Voxel
 {
     /// 0          - Invisible / Invalid
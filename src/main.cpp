@@ -1,3 +1,4 @@
+#include <charconv>
 #include <engine/event.hpp>
 #include <engine/settings.hpp>
 #include <future>
@@ -6,8 +7,10 @@
 #include <glm/common.hpp>
 #include <magic_enum_all.hpp>
 #include <util/block_allocator.hpp>
+#include <util/flight_recorder.hpp>
 #include <util/log.hpp>
 #include <util/noise.hpp>
+#include <util/threads.hpp>
 
 void setDefaultSettings(engine::SettingsManager&);
 void parseCommandLineArgumentsAndUpdateSettings(int argc, char** argv);
@@ -17,6 +20,18 @@ int main(int argc, char** argv)
     try
     {
         util::installGlobalLoggerRacy();
+        util::installFlightRecorderCrashHandlers();
+        // Keeps the known logging storms, Device::accessQueue() spinning on
+        // full queues and every Chunk tracing its construction, from turning
+        // into frame time spikes. Everything else logs unlimited
+        util::setLogRateLimit(
+            "gfx/vulkan/device.cpp",
+            306,
+            util::LogRateLimit {.every_nth {1}, .max_per_second {64}});
+        util::setLogRateLimit(
+            "game/world/chunk.cpp",
+            0,
+            util::LogRateLimit {.every_nth {1}, .max_per_second {64}});
         parseCommandLineArgumentsAndUpdateSettings(argc, argv);
 
         gfx::Renderer renderer {};
@@ -27,11 +42,11 @@ int main(int argc, char** argv)
         std::future<void> gameLoop = std::async(
             [&]
             {
-                while (game.continueTicking()
-                       && !shouldStop.load(std::memory_order_acquire))
-                {
-                    game.tick();
-                }
+                game.run(
+                    [&]
+                    {
+                        return !shouldStop.load(std::memory_order_acquire);
+                    });
 
                 shouldStop.store(true, std::memory_order_release);
             });
@@ -51,6 +66,8 @@ int main(int argc, char** argv)
         util::logFatal("Verdigris crash | {}", e.what());
     }
 
+    util::dumpLockStatistics();
+
     util::removeGlobalLoggerRacy();
 }
 
@@ -61,6 +78,8 @@ void parseCommandLineArgumentsAndUpdateSettings(int argc, char** argv)
     bool customLoggingLevelSet = false;
     bool setGFXValidation      = false;
     bool setAppValidation      = false;
+    bool setTickRate           = false;
+    bool setInstancedChunks    = false;
 
     for (int i = 0; i < argc; ++i)
     {
@@ -89,6 +108,36 @@ void parseCommandLineArgumentsAndUpdateSettings(int argc, char** argv)
                 engine::Setting::EnableAppValidation, true);
             setAppValidation = true;
         }
+        else if (std::strcmp("--tick-rate", argv[i]) == 0) // NOLINT
+        {
+            util::assertFatal(i + 1 < argc, "Not enough arguments");
+            const std::string_view maybeTickRate = argv[i + 1]; // NOLINT
+
+            std::uint32_t tickRate = 0;
+            const auto [end, error] = std::from_chars(
+                maybeTickRate.data(),
+                maybeTickRate.data() + maybeTickRate.size(), // NOLINT
+                tickRate);
+
+            util::assertFatal(
+                error == std::errc {}
+                    && end == maybeTickRate.data() + maybeTickRate.size()
+                    && tickRate > 0,
+                "Invalid tick rate {}",
+                maybeTickRate);
+
+            engine::getSettings().setSetting(
+                engine::Setting::TickRateHz, tickRate);
+            setTickRate = true;
+
+            ++i;
+        }
+        else if (std::strcmp("--instanced-chunks", argv[i]) == 0) // NOLINT
+        {
+            engine::getSettings().setSetting(
+                engine::Setting::InstancedChunks, true);
+            setInstancedChunks = true;
+        }
         else if (std::strcmp("--force-logging-level", argv[i]) == 0) // NOLINT
         {
             util::assertFatal(i + 1 < argc, "Not enough arguments");
@@ -169,6 +218,20 @@ void parseCommandLineArgumentsAndUpdateSettings(int argc, char** argv)
 #endif
                 }
                 break;
+            case Setting::TickRateHz:
+                if (!setTickRate)
+                {
+                    engine::getSettings().setSetting(
+                        Setting::TickRateHz, engine::DefaultTickRateHz);
+                }
+                break;
+            case Setting::InstancedChunks:
+                if (!setInstancedChunks)
+                {
+                    engine::getSettings().setSetting(
+                        Setting::InstancedChunks, false);
+                }
+                break;
             }
         });
 
@@ -176,4 +239,9 @@ void parseCommandLineArgumentsAndUpdateSettings(int argc, char** argv)
         "Validations? | Gfx: {} | App: {}",
         engine::getSettings().lookupSetting<Setting::EnableGFXValidation>(),
         engine::getSettings().lookupSetting<Setting::EnableAppValidation>());
+
+    util::logLog(
+        "Tick rate: {}Hz | Instanced chunks: {}",
+        engine::getSettings().lookupSetting<Setting::TickRateHz>(),
+        engine::getSettings().lookupSetting<Setting::InstancedChunks>());
 }
@@ -1,8 +1,23 @@
 #include "block_allocator.hpp"
+#include <algorithm>
+#include <bit>
 #include <util/log.hpp>
 
 namespace util
 {
+    namespace
+    {
+        // The bits [low, high) of a word, high - low must be in [1, 64]
+        constexpr std::uint64_t makeMask(std::size_t low, std::size_t high)
+        {
+            const std::size_t width = high - low;
+
+            return (width == 64 ? ~std::uint64_t {0}
+                                : ((std::uint64_t {1} << width) - 1))
+                << low;
+        }
+    } // namespace
+
     const char* BlockAllocator::OutOfBlocks::what() const noexcept
     {
         return "BlockAllocator::OutOfBlocks";
@@ -19,18 +34,32 @@ namespace util
     }
 
     BlockAllocator::BlockAllocator(std::size_t blocks)
-        : next_available_block {0}
+        : levels {}
+        , number_of_allocated_blocks {0}
         , max_number_of_blocks {blocks}
-    {}
+    {
+        std::vector<std::uint64_t> leaves(
+            std::max(ceilingDivide(blocks, BitsPerWord), std::size_t {1}), 0);
+
+        for (std::size_t w = 0; w * BitsPerWord < blocks; ++w)
+        {
+            leaves[w] = makeMask(
+                0, std::min(BitsPerWord, blocks - (w * BitsPerWord)));
+        }
+
+        this->levels.push_back(std::move(leaves));
+
+        this->rebuildSummaryLevels();
+    }
 
     BlockAllocator::BlockAllocator(BlockAllocator&& other) noexcept
-        : free_block_list {std::move(other.free_block_list)}
-        , next_available_block {other.next_available_block}
+        : levels {std::move(other.levels)}
+        , number_of_allocated_blocks {other.number_of_allocated_blocks}
         , max_number_of_blocks {other.max_number_of_blocks}
     {
-        other.free_block_list      = {};
-        other.next_available_block = -1;
-        other.max_number_of_blocks = 0;
+        other.levels                     = {};
+        other.number_of_allocated_blocks = 0;
+        other.max_number_of_blocks       = 0;
     }
 
     BlockAllocator& BlockAllocator::operator= (BlockAllocator&& other) noexcept
@@ -53,57 +82,313 @@ namespace util
             newAmount > this->max_number_of_blocks,
             "Tried to update an allocator with less bricks!");
 
+        if (this->levels.empty())
+        {
+            this->levels.emplace_back();
+        }
+
+        std::vector<std::uint64_t>& leaves = this->levels.front();
+
+        leaves.resize(
+            std::max(ceilingDivide(newAmount, BitsPerWord), std::size_t {1}),
+            0);
+
+        for (std::size_t block = this->max_number_of_blocks; block < newAmount;)
+        {
+            const std::size_t word = block / BitsPerWord;
+            const std::size_t low  = block % BitsPerWord;
+            const std::size_t high =
+                std::min(BitsPerWord, newAmount - (word * BitsPerWord));
+
+            leaves[word] |= makeMask(low, high);
+
+            block += high - low;
+        }
+
         this->max_number_of_blocks = newAmount;
+
+        this->rebuildSummaryLevels();
+    }
+
+    float BlockAllocator::getPercentAllocated() const
+    {
+        if (this->max_number_of_blocks == 0)
+        {
+            return 0.0f;
+        }
+
+        return 100.0f * static_cast<float>(this->number_of_allocated_blocks)
+             / static_cast<float>(this->max_number_of_blocks);
+    }
+
+    std::size_t BlockAllocator::getNumberOfAllocatedBlocks() const
+    {
+        return this->number_of_allocated_blocks;
     }
 
     std::expected<std::size_t, BlockAllocator::OutOfBlocks>
     BlockAllocator::allocate()
     {
-        if (this->free_block_list.empty())
+        if (this->levels.empty() || this->levels.back().front() == 0)
+        {
+            return std::unexpected(OutOfBlocks {});
+        }
+
+        std::size_t index = 0;
+
+        for (std::size_t l = this->levels.size(); l-- > 0;)
+        {
+            index = (index * BitsPerWord)
+                  + static_cast<std::size_t>(
+                        std::countr_zero(this->levels[l][index]));
+        }
+
+        if (index >= this->max_number_of_blocks)
+        {
+            util::panic(
+                "Out of bounds block #{} was free in allocator of size #{}!",
+                index,
+                this->max_number_of_blocks);
+        }
+
+        this->levels.front()[index / BitsPerWord] &=
+            ~(std::uint64_t {1} << (index % BitsPerWord));
+        this->markWordChanged(0, index / BitsPerWord);
+
+        ++this->number_of_allocated_blocks;
+
+        return index;
+    }
+
+    void BlockAllocator::free(std::size_t blockToFree)
+    {
+        if (blockToFree >= this->max_number_of_blocks)
         {
-            std::size_t nextFreeBlock = this->next_available_block;
+            throw FreeOfUntrackedValue {};
+        }
+
+        std::uint64_t& word = this->levels.front()[blockToFree / BitsPerWord];
+        const std::uint64_t bit = std::uint64_t {1}
+                               << (blockToFree % BitsPerWord);
+
+        if ((word & bit) != 0)
+        {
+            throw DoubleFree {};
+        }
+
+        word |= bit;
+        this->markWordChanged(0, blockToFree / BitsPerWord);
+
+        --this->number_of_allocated_blocks;
+    }
+
+    std::expected<std::vector<std::size_t>, BlockAllocator::OutOfBlocks>
+    BlockAllocator::allocate(std::size_t number)
+    {
+        if (this->max_number_of_blocks - this->number_of_allocated_blocks
+            < number)
+        {
+            return std::unexpected(OutOfBlocks {});
+        }
+
+        std::vector<std::size_t> output {};
+        output.reserve(number);
 
-            ++this->next_available_block;
+        // Take every free block from the lowest word with free blocks at
+        // once, rather than descending the levels once per block
+        while (output.size() < number)
+        {
+            std::size_t wordIndex = 0;
 
-            if (this->next_available_block - 1 >= this->max_number_of_blocks)
+            for (std::size_t l = this->levels.size(); l-- > 1;)
             {
-                return std::unexpected(OutOfBlocks {});
+                wordIndex = (wordIndex * BitsPerWord)
+                          + static_cast<std::size_t>(
+                                std::countr_zero(this->levels[l][wordIndex]));
             }
 
-            return nextFreeBlock;
+            std::uint64_t& word = this->levels.front()[wordIndex];
+
+            while (word != 0 && output.size() < number)
+            {
+                output.push_back(
+                    (wordIndex * BitsPerWord)
+                    + static_cast<std::size_t>(std::countr_zero(word)));
+
+                word &= word - 1;
+            }
+
+            this->markWordChanged(0, wordIndex);
         }
-        else
+
+        this->number_of_allocated_blocks += number;
+
+        return output;
+    }
+
+    std::expected<std::size_t, BlockAllocator::OutOfBlocks>
+    BlockAllocator::allocateContiguous(std::size_t number)
+    {
+        util::assertFatal(number > 0, "Tried to allocate an empty range!");
+
+        if (this->max_number_of_blocks - this->number_of_allocated_blocks
+            < number)
         {
-            std::size_t freeListBlock = *this->free_block_list.rbegin();
+            return std::unexpected(OutOfBlocks {});
+        }
+
+        std::vector<std::uint64_t>& leaves = this->levels.front();
 
-            this->free_block_list.erase(freeListBlock);
+        std::size_t runStart  = 0;
+        std::size_t runLength = 0;
 
-            if (freeListBlock >= this->max_number_of_blocks)
+        // Walks runs of set and unset bits, rather than single bits
+        for (std::size_t w = 0; w < leaves.size() && runLength < number; ++w)
+        {
+            std::size_t bit = 0;
+
+            while (bit < BitsPerWord && runLength < number)
             {
-                util::panic(
-                    "Out of bounds block #{} was in freelist of allocator of "
-                    "size #{}! Recursing!",
-                    freeListBlock,
-                    this->max_number_of_blocks);
+                const std::uint64_t shifted = leaves[w] >> bit;
+
+                if ((shifted & 1) != 0)
+                {
+                    if (runLength == 0)
+                    {
+                        runStart = (w * BitsPerWord) + bit;
+                    }
+
+                    const auto ones =
+                        static_cast<std::size_t>(std::countr_one(shifted));
+
+                    runLength += ones;
+                    bit += ones;
+                }
+                else
+                {
+                    runLength = 0;
+                    bit += shifted == 0 ? BitsPerWord - bit
+                                        : static_cast<std::size_t>(
+                                              std::countr_zero(shifted));
+                }
             }
+        }
+
+        if (runLength < number)
+        {
+            return std::unexpected(OutOfBlocks {});
+        }
+
+        for (std::size_t block = runStart; block < runStart + number;)
+        {
+            const std::size_t word = block / BitsPerWord;
+            const std::size_t low  = block % BitsPerWord;
+            const std::size_t high = std::min(
+                BitsPerWord, runStart + number - (word * BitsPerWord));
+
+            leaves[word] &= ~makeMask(low, high);
+            this->markWordChanged(0, word);
 
-            return freeListBlock;
+            block += high - low;
         }
+
+        this->number_of_allocated_blocks += number;
+
+        return runStart;
     }
 
-    void BlockAllocator::free(std::size_t blockToFree)
+    void BlockAllocator::freeContiguous(std::size_t first, std::size_t number)
     {
-        if (blockToFree >= this->max_number_of_blocks)
+        if (number == 0)
+        {
+            return;
+        }
+
+        if (first >= this->max_number_of_blocks
+            || number > this->max_number_of_blocks - first)
         {
             throw FreeOfUntrackedValue {};
         }
 
-        const auto& [maybeIterator, valid] =
-            this->free_block_list.insert_unique(blockToFree);
+        std::vector<std::uint64_t>& leaves = this->levels.front();
 
-        if (!valid)
+        // Validate the whole range before modifying anything
+        for (std::size_t block = first; block < first + number;)
         {
-            throw DoubleFree {};
+            const std::size_t word = block / BitsPerWord;
+            const std::size_t low  = block % BitsPerWord;
+            const std::size_t high =
+                std::min(BitsPerWord, first + number - (word * BitsPerWord));
+
+            if ((leaves[word] & makeMask(low, high)) != 0)
+            {
+                throw DoubleFree {};
+            }
+
+            block += high - low;
+        }
+
+        for (std::size_t block = first; block < first + number;)
+        {
+            const std::size_t word = block / BitsPerWord;
+            const std::size_t low  = block % BitsPerWord;
+            const std::size_t high =
+                std::min(BitsPerWord, first + number - (word * BitsPerWord));
+
+            leaves[word] |= makeMask(low, high);
+            this->markWordChanged(0, word);
+
+            block += high - low;
+        }
+
+        this->number_of_allocated_blocks -= number;
+    }
+
+    void BlockAllocator::rebuildSummaryLevels()
+    {
+        this->levels.resize(1);
+
+        while (this->levels.back().size() > 1)
+        {
+            const std::vector<std::uint64_t>& below = this->levels.back();
+
+            std::vector<std::uint64_t> summary(
+                ceilingDivide(below.size(), BitsPerWord), 0);
+
+            for (std::size_t w = 0; w < below.size(); ++w)
+            {
+                if (below[w] != 0)
+                {
+                    summary[w / BitsPerWord] |= std::uint64_t {1}
+                                             << (w % BitsPerWord);
+                }
+            }
+
+            this->levels.push_back(std::move(summary));
+        }
+    }
+
+    void
+    BlockAllocator::markWordChanged(std::size_t level, std::size_t wordIndex)
+    {
+        for (std::size_t l = level + 1; l < this->levels.size(); ++l)
+        {
+            const bool hasFreeBlocks = this->levels[l - 1][wordIndex] != 0;
+
+            std::uint64_t& parent = this->levels[l][wordIndex / BitsPerWord];
+            const std::uint64_t bit = std::uint64_t {1}
+                                   << (wordIndex % BitsPerWord);
+            const bool parentHadFreeBlocks = parent != 0;
+
+            parent = hasFreeBlocks ? (parent | bit) : (parent & ~bit);
+
+            // The levels above only care if this word is zero or not
+            if ((parent != 0) == parentHadFreeBlocks)
+            {
+                return;
+            }
+
+            wordIndex /= BitsPerWord;
         }
     }
 
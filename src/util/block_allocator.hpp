@@ -1,14 +1,21 @@
 #ifndef SRC_UTIL_BLOCK_ALLOCATOR_HPP
 #define SRC_UTIL_BLOCK_ALLOCATOR_HPP
 
-#include <boost/container/flat_set.hpp>
 #include <cstddef>
+#include <cstdint>
 #include <expected>
+#include <new>
+#include <vector>
 
 namespace util
 {
     /// Allocates unique, single integers.
     /// Useful for allocating fixed sized chunks of memory
+    ///
+    /// Tracks free blocks with a hierarchical bitmap, each bit in a level is
+    /// set if the corresponding word in the level below has any free blocks.
+    /// Allocation is a find-first-set per level and freeing is a bit set per
+    /// level, both O(log64(blocks)).
     class BlockAllocator
     {
     public:
@@ -42,16 +49,35 @@ namespace util
         BlockAllocator& operator= (const BlockAllocator&) = delete;
         BlockAllocator& operator= (BlockAllocator&&) noexcept;
 
-        void updateAvailableBlockAmount(std::size_t newAmount);
-        // TODO: float getPercentAllocated() const;
+        void                updateAvailableBlockAmount(std::size_t newAmount);
+        [[nodiscard]] float getPercentAllocated() const;
+        [[nodiscard]] std::size_t getNumberOfAllocatedBlocks() const;
 
+        // Always returns the lowest free block
         std::expected<std::size_t, OutOfBlocks> allocate();
         void                                    free(std::size_t);
 
+        // Allocates `number` blocks that aren't necessarily contiguous.
+        // Either all are allocated or none are
+        std::expected<std::vector<std::size_t>, OutOfBlocks>
+        allocate(std::size_t number);
+
+        // Allocates the range [returned, returned + number)
+        std::expected<std::size_t, OutOfBlocks>
+             allocateContiguous(std::size_t number);
+        void freeContiguous(std::size_t first, std::size_t number);
+
     private:
-        boost::container::flat_set<std::size_t> free_block_list;
-        std::size_t                             next_available_block;
-        std::size_t                             max_number_of_blocks;
+        static constexpr std::size_t BitsPerWord = 64;
+
+        // levels.front() has one bit per block, levels.back() is one word
+        // 1 is free, 0 is allocated or out of range
+        std::vector<std::vector<std::uint64_t>> levels;
+        std::size_t                             number_of_allocated_blocks = 0;
+        std::size_t                             max_number_of_blocks       = 0;
+
+        void rebuildSummaryLevels();
+        void markWordChanged(std::size_t level, std::size_t wordIndex);
     };
 } // namespace util
 
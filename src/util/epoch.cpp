@@ -0,0 +1,133 @@
+#include "epoch.hpp"
+#include <algorithm>
+#include <limits>
+#include <mutex>
+
+namespace util
+{
+    namespace
+    {
+        // 0 is reserved for unpinned threads
+        std::atomic<std::uint64_t> GLOBAL_EPOCH {1}; // NOLINT
+
+        struct EpochSlot
+        {
+            std::atomic<std::uint64_t> pinned_epoch {0};
+            std::uint32_t              depth {0};
+        };
+
+        struct EpochSlotRegistry
+        {
+            std::mutex                              mutex;
+            std::vector<std::shared_ptr<EpochSlot>> slots;
+        };
+
+        EpochSlotRegistry& getEpochSlotRegistry()
+        {
+            static EpochSlotRegistry registry {};
+
+            return registry;
+        }
+
+        // Trivially destructible so that access to it is just a TLS load,
+        // rather than a call through the thread_local's init guard
+        thread_local EpochSlot* THREAD_EPOCH_SLOT {nullptr}; // NOLINT
+
+        struct ThreadEpochSlot
+        {
+            ThreadEpochSlot()
+                : slot {std::make_shared<EpochSlot>()}
+            {
+                EpochSlotRegistry& registry = getEpochSlotRegistry();
+
+                std::unique_lock lock {registry.mutex};
+
+                registry.slots.push_back(this->slot);
+            }
+            ~ThreadEpochSlot()
+            {
+                THREAD_EPOCH_SLOT = nullptr;
+
+                EpochSlotRegistry& registry = getEpochSlotRegistry();
+
+                std::unique_lock lock {registry.mutex};
+
+                std::erase(registry.slots, this->slot);
+            }
+
+            ThreadEpochSlot(const ThreadEpochSlot&)             = delete;
+            ThreadEpochSlot(ThreadEpochSlot&&)                  = delete;
+            ThreadEpochSlot& operator= (const ThreadEpochSlot&) = delete;
+            ThreadEpochSlot& operator= (ThreadEpochSlot&&)      = delete;
+
+            std::shared_ptr<EpochSlot> slot;
+        };
+
+        EpochSlot& getThreadEpochSlot()
+        {
+            if (THREAD_EPOCH_SLOT == nullptr) [[unlikely]]
+            {
+                thread_local ThreadEpochSlot threadSlot {};
+
+                THREAD_EPOCH_SLOT = threadSlot.slot.get();
+            }
+
+            return *THREAD_EPOCH_SLOT;
+        }
+    } // namespace
+
+    EpochGuard::EpochGuard() noexcept
+    {
+        EpochSlot& slot = getThreadEpochSlot();
+
+        if (slot.depth++ == 0)
+        {
+            slot.pinned_epoch.store(
+                GLOBAL_EPOCH.load(std::memory_order_acquire),
+                std::memory_order_relaxed);
+
+            // Pairs with the fence in getOldestPinnedEpoch, either the
+            // writer sees this pin or this reader sees the writer's new value
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+    }
+
+    EpochGuard::~EpochGuard() noexcept
+    {
+        EpochSlot& slot = *THREAD_EPOCH_SLOT;
+
+        if (--slot.depth == 0)
+        {
+            slot.pinned_epoch.store(0, std::memory_order_release);
+        }
+    }
+
+    std::uint64_t advanceEpoch() noexcept
+    {
+        return GLOBAL_EPOCH.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    std::uint64_t getOldestPinnedEpoch() noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        std::uint64_t oldest = std::numeric_limits<std::uint64_t>::max();
+
+        EpochSlotRegistry& registry = getEpochSlotRegistry();
+
+        std::unique_lock lock {registry.mutex};
+
+        for (const std::shared_ptr<EpochSlot>& slot : registry.slots)
+        {
+            const std::uint64_t pinned =
+                slot->pinned_epoch.load(std::memory_order_acquire);
+
+            if (pinned != 0)
+            {
+                oldest = std::min(oldest, pinned);
+            }
+        }
+
+        return oldest;
+    }
+} // namespace util
@@ -0,0 +1,139 @@
+#ifndef SRC_UTIL_EPOCH_HPP
+#define SRC_UTIL_EPOCH_HPP
+
+#include "threads.hpp"
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace util
+{
+    /// Pins the calling thread to the current epoch for the guard's lifetime.
+    /// Anything retired while a thread is pinned won't be reclaimed until that
+    /// thread unpins. Guards may be nested.
+    class EpochGuard
+    {
+    public:
+
+        EpochGuard() noexcept;
+        ~EpochGuard() noexcept;
+
+        EpochGuard(const EpochGuard&)             = delete;
+        EpochGuard(EpochGuard&&)                  = delete;
+        EpochGuard& operator= (const EpochGuard&) = delete;
+        EpochGuard& operator= (EpochGuard&&)      = delete;
+    };
+
+    // Advances the global epoch, returning the epoch that anything retired
+    // just before this call belongs to
+    [[nodiscard]] std::uint64_t advanceEpoch() noexcept;
+
+    // Everything retired in an epoch less than this may be reclaimed
+    [[nodiscard]] std::uint64_t getOldestPinnedEpoch() noexcept;
+
+    /// A read mostly value that is replaced wholesale, rather than modified.
+    /// Readers never block, they pin the current epoch and load a pointer.
+    /// Writers swap in a new value and the old one is destroyed once every
+    /// reader that could have seen it has unpinned, so a writer never waits
+    /// on readers either.
+    ///
+    /// The reference handed to read()'s callback must not escape it.
+    template<class T>
+    class EpochPublished
+    {
+    public:
+
+        explicit EpochPublished(std::unique_ptr<T> initial)
+            : current {initial.release()}
+            , retired {}
+        {}
+        ~EpochPublished()
+        {
+            this->retired.lock(
+                [](std::vector<Retired>& retiredValues)
+                {
+                    // Everyone reading this should've been joined by now
+                    while (!retiredValues.empty()
+                           && getOldestPinnedEpoch()
+                                  <= retiredValues.back().epoch)
+                    {
+                        std::this_thread::yield();
+                    }
+
+                    retiredValues.clear();
+                });
+
+            delete this->current.load(std::memory_order_acquire); // NOLINT
+        }
+
+        EpochPublished(const EpochPublished&)             = delete;
+        EpochPublished(EpochPublished&&)                  = delete;
+        EpochPublished& operator= (const EpochPublished&) = delete;
+        EpochPublished& operator= (EpochPublished&&)      = delete;
+
+        decltype(auto) read(std::invocable<const T&> auto func) const
+        {
+            EpochGuard guard {};
+
+            return func(*this->current.load(std::memory_order_acquire));
+        }
+
+        void publish(std::unique_ptr<T> next) const
+        {
+            std::unique_ptr<T> previous {this->current.exchange(
+                next.release(), std::memory_order_acq_rel)};
+
+            const std::uint64_t retiredEpoch = advanceEpoch();
+
+            this->retired.lock(
+                [&](std::vector<Retired>& retiredValues)
+                {
+                    retiredValues.push_back(Retired {
+                        .value {std::move(previous)},
+                        .epoch {retiredEpoch},
+                    });
+                });
+
+            this->reclaim();
+        }
+
+        // Destroys every retired value that's no longer visible to a reader.
+        // Called by publish(), but calling it periodically frees retired
+        // values sooner
+        void reclaim() const
+        {
+            this->retired.lock(
+                [](std::vector<Retired>& retiredValues)
+                {
+                    if (retiredValues.empty())
+                    {
+                        return;
+                    }
+
+                    const std::uint64_t oldestPinned = getOldestPinnedEpoch();
+
+                    std::erase_if(
+                        retiredValues,
+                        [&](const Retired& r)
+                        {
+                            return r.epoch < oldestPinned;
+                        });
+                });
+        }
+
+    private:
+        struct Retired
+        {
+            std::unique_ptr<T> value;
+            std::uint64_t      epoch;
+        };
+
+        mutable std::atomic<T*>           current;
+        util::Mutex<std::vector<Retired>> retired;
+    };
+} // namespace util
+
+#endif // SRC_UTIL_EPOCH_HPP
@@ -0,0 +1,651 @@
+#include "flight_recorder.hpp"
+#include "threads.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <fcntl.h>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace util
+{
+    namespace
+    {
+        // Must be a power of two
+        constexpr std::size_t FlightRecorderCapacity = 2048;
+
+        // The events of threads that have exited are kept around, but only
+        // the most recent few, as every std::async spawns a new thread
+        constexpr std::size_t MaxRetiredFlightRecorders = 32;
+
+        // Rings past this many at once are still recorded into, they just
+        // aren't dumped
+        constexpr std::size_t MaxDumpedFlightRecorders = 256;
+
+        constexpr std::size_t EventWords =
+            (sizeof(FlightRecorderEvent) + sizeof(std::uint64_t) - 1)
+            / sizeof(std::uint64_t);
+
+        static_assert(std::is_trivially_copyable_v<FlightRecorderEvent>);
+
+        struct FlightRecorderRing
+        {
+            // Event n lives in slot n % FlightRecorderCapacity, whose
+            // sequence is odd while it's being written and 2n + 2 once it
+            // has been. A dump can then tell torn and overwritten events
+            // apart without ever waiting on the thread that records them
+            std::array<std::atomic<std::uint64_t>, FlightRecorderCapacity>
+                sequences;
+            std::array<
+                std::array<std::atomic<std::uint64_t>, EventWords>,
+                FlightRecorderCapacity>
+                                       events;
+            std::atomic<std::uint64_t> next_event;
+            std::atomic<bool>          has_exited;
+            std::size_t                thread_index;
+            // Into DUMPABLE_RINGS, MaxDumpedFlightRecorders if it has none
+            std::size_t                dump_slot;
+        };
+
+        struct FlightRecorderRegistry
+        {
+            std::vector<std::shared_ptr<FlightRecorderRing>> live;
+            std::deque<std::shared_ptr<FlightRecorderRing>>  retired;
+            std::size_t                                      next_thread_index;
+        };
+
+        Mutex<FlightRecorderRegistry> FLIGHT_RECORDERS {}; // NOLINT
+        std::atomic<bool>             IS_DUMPING {false};  // NOLINT
+
+        // What a dump walks instead of FLIGHT_RECORDERS, as it can't take
+        // a lock. A ring is only freed once it's been removed from here and
+        // no dump is running
+        std::array<                                        // NOLINT
+            std::atomic<const FlightRecorderRing*>,
+            MaxDumpedFlightRecorders>
+                                   DUMPABLE_RINGS {};
+        std::atomic<std::uint32_t> ACTIVE_DUMPS {0}; // NOLINT
+
+        struct TimestampSample
+        {
+            std::uint64_t                         ticks;
+            std::chrono::steady_clock::time_point time;
+        };
+
+        TimestampSample sampleTimestamp() noexcept
+        {
+            return TimestampSample {
+                .ticks {getFlightRecorderTimestamp()},
+                .time {std::chrono::steady_clock::now()}};
+        }
+
+        // Used to convert ticks into real time when dumping
+        const TimestampSample PROCESS_START_SAMPLE = // NOLINT
+            sampleTimestamp();
+
+        // Trivially destructible so that access to it is just a TLS load,
+        // rather than a call through the thread_local's init guard
+        thread_local FlightRecorderRing* // NOLINT
+            THREAD_FLIGHT_RECORDER {nullptr};
+
+        void publishDumpableRing(FlightRecorderRing& ring)
+        {
+            ring.dump_slot = MaxDumpedFlightRecorders;
+
+            for (std::size_t i = 0; i < DUMPABLE_RINGS.size(); ++i)
+            {
+                if (DUMPABLE_RINGS[i].load() == nullptr) // NOLINT
+                {
+                    DUMPABLE_RINGS[i].store(&ring); // NOLINT
+                    ring.dump_slot = i;
+
+                    return;
+                }
+            }
+        }
+
+        // Must be called before the ring is freed
+        void unpublishDumpableRing(const FlightRecorderRing& ring)
+        {
+            if (ring.dump_slot == MaxDumpedFlightRecorders)
+            {
+                return;
+            }
+
+            DUMPABLE_RINGS[ring.dump_slot].store(nullptr); // NOLINT
+
+            // Both seq_cst, so a dump either saw the slot cleared or is
+            // counted here
+            while (ACTIVE_DUMPS.load() != 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        struct ThreadFlightRecorder
+        {
+            ThreadFlightRecorder()
+                : ring {std::make_shared<FlightRecorderRing>()}
+            {
+                FLIGHT_RECORDERS.lock(
+                    [&](FlightRecorderRegistry& registry)
+                    {
+                        this->ring->thread_index = registry.next_thread_index++;
+
+                        publishDumpableRing(*this->ring);
+
+                        registry.live.push_back(this->ring);
+                    });
+            }
+            ~ThreadFlightRecorder()
+            {
+                THREAD_FLIGHT_RECORDER = nullptr;
+
+                this->ring->has_exited.store(true, std::memory_order_release);
+
+                FLIGHT_RECORDERS.lock(
+                    [&](FlightRecorderRegistry& registry)
+                    {
+                        std::erase(registry.live, this->ring);
+
+                        registry.retired.push_back(std::move(this->ring));
+
+                        if (registry.retired.size() > MaxRetiredFlightRecorders)
+                        {
+                            unpublishDumpableRing(*registry.retired.front());
+
+                            registry.retired.pop_front();
+                        }
+                    });
+            }
+
+            ThreadFlightRecorder(const ThreadFlightRecorder&) = delete;
+            ThreadFlightRecorder(ThreadFlightRecorder&&)      = delete;
+            ThreadFlightRecorder&
+            operator= (const ThreadFlightRecorder&) = delete;
+            ThreadFlightRecorder& operator= (ThreadFlightRecorder&&) = delete;
+
+            std::shared_ptr<FlightRecorderRing> ring;
+        };
+
+        FlightRecorderRing& getThreadFlightRecorder()
+        {
+            if (THREAD_FLIGHT_RECORDER == nullptr) [[unlikely]]
+            {
+                thread_local ThreadFlightRecorder recorder {};
+
+                THREAD_FLIGHT_RECORDER = recorder.ring.get();
+            }
+
+            return *THREAD_FLIGHT_RECORDER;
+        }
+
+        // Returns false if event n was torn, overwritten, or never written
+        bool tryReadEvent(
+            const FlightRecorderRing& ring,
+            std::uint64_t             n,
+            FlightRecorderEvent&      event) noexcept
+        {
+            const std::size_t   slot     = n % FlightRecorderCapacity;
+            const std::uint64_t expected = (2 * n) + 2;
+
+            if (ring.sequences[slot].load(std::memory_order_acquire) // NOLINT
+                != expected)
+            {
+                return false;
+            }
+
+            std::array<std::uint64_t, EventWords> words {};
+
+            for (std::size_t i = 0; i < EventWords; ++i)
+            {
+                words[i] = ring.events[slot][i].load( // NOLINT
+                    std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (ring.sequences[slot].load(std::memory_order_relaxed) // NOLINT
+                != expected)
+            {
+                return false;
+            }
+
+            std::memcpy(&event, words.data(), sizeof(FlightRecorderEvent));
+
+            return true;
+        }
+
+        /// Formats into a fixed buffer and writes it out with write(2), as
+        /// the dump may run in a signal handler where neither malloc nor
+        /// stdio are safe
+        class DumpWriter
+        {
+        public:
+            // Returns false if the file couldn't be opened
+            bool open(const char* path) noexcept
+            {
+#if defined(_WIN32)
+                this->file = ::_open(
+                    path,
+                    _O_WRONLY | _O_CREAT | _O_TRUNC,
+                    _S_IREAD | _S_IWRITE);
+#else
+                this->file = ::open( // NOLINT
+                    path,
+                    O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                    0644);
+#endif
+                this->size = 0;
+
+                return this->file >= 0;
+            }
+
+            void close() noexcept
+            {
+                this->flush();
+
+#if defined(_WIN32)
+                std::ignore = ::_close(this->file);
+#else
+                std::ignore = ::close(this->file);
+#endif
+                this->file = -1;
+            }
+
+            void append(std::string_view string) noexcept
+            {
+                while (!string.empty())
+                {
+                    if (this->size == this->buffer.size())
+                    {
+                        this->flush();
+                    }
+
+                    const std::size_t count = std::min(
+                        string.size(), this->buffer.size() - this->size);
+
+                    std::memcpy(
+                        this->buffer.data() + this->size, // NOLINT
+                        string.data(),
+                        count);
+
+                    this->size += count;
+                    string.remove_prefix(count);
+                }
+            }
+
+            // Right aligned to width, as with "{:>width}"
+            template<class T, class... Format>
+            void appendNumber(T t, std::size_t width, Format... format) noexcept
+            {
+                std::array<char, 64> digits {};
+
+                const std::to_chars_result result = std::to_chars(
+                    digits.data(), digits.data() + digits.size(), t, format...);
+
+                const std::size_t length =
+                    result.ec == std::errc {}
+                        ? static_cast<std::size_t>(result.ptr - digits.data())
+                        : 0;
+
+                for (std::size_t i = length; i < width; ++i)
+                {
+                    this->append(" ");
+                }
+
+                this->append(std::string_view {digits.data(), length});
+            }
+
+            void appendArgument(
+                std::uint64_t value, FlightRecorderArgument type) noexcept
+            {
+                switch (type)
+                {
+                case FlightRecorderArgument::None:
+                    return;
+                case FlightRecorderArgument::Signed:
+                    this->appendNumber(std::bit_cast<std::int64_t>(value), 0);
+                    return;
+                case FlightRecorderArgument::Unsigned:
+                    this->appendNumber(value, 0);
+                    return;
+                case FlightRecorderArgument::Floating:
+                    this->appendNumber(std::bit_cast<double>(value), 0);
+                    return;
+                case FlightRecorderArgument::Boolean:
+                    this->append(value != 0 ? "true" : "false");
+                    return;
+                }
+
+                this->append("?");
+            }
+
+        private:
+            void flush() noexcept
+            {
+                std::size_t written = 0;
+
+                while (written < this->size)
+                {
+#if defined(_WIN32)
+                    const int result = ::_write(
+                        this->file,
+                        this->buffer.data() + written, // NOLINT
+                        static_cast<unsigned int>(this->size - written));
+#else
+                    const ssize_t result = ::write(
+                        this->file,
+                        this->buffer.data() + written, // NOLINT
+                        this->size - written);
+
+                    if (result < 0 && errno == EINTR)
+                    {
+                        continue;
+                    }
+#endif
+                    if (result <= 0)
+                    {
+                        break;
+                    }
+
+                    written += static_cast<std::size_t>(result);
+                }
+
+                this->size = 0;
+            }
+
+            int                      file = -1;
+            std::size_t              size = 0;
+            std::array<char, 16384> buffer {};
+        };
+
+        // The next event of a ring that hasn't been written out yet
+        struct DumpCursor
+        {
+            const FlightRecorderRing* ring;
+            std::uint64_t             next_event;
+            std::uint64_t             end_event;
+            bool                      has_event;
+            FlightRecorderEvent       event;
+
+            void advance() noexcept
+            {
+                this->has_event = false;
+
+                while (!this->has_event && this->next_event < this->end_event)
+                {
+                    this->has_event = tryReadEvent(
+                        *this->ring, this->next_event, this->event);
+
+                    ++this->next_event;
+                }
+            }
+        };
+
+        // Only ever used by the one dump that holds IS_DUMPING, static as
+        // there's no allocating in a signal handler
+        constinit DumpWriter DUMP_WRITER {}; // NOLINT
+        constinit std::array<DumpCursor, MaxDumpedFlightRecorders> // NOLINT
+            DUMP_CURSORS {};
+
+        // Must hold IS_DUMPING. Async signal safe, it takes no locks and
+        // doesn't allocate
+        void writeFlightRecorder() noexcept
+        {
+            ACTIVE_DUMPS.fetch_add(1);
+
+            std::size_t cursors       = 0;
+            std::size_t liveThreads   = 0;
+            std::size_t exitedThreads = 0;
+
+            for (const std::atomic<const FlightRecorderRing*>& r :
+                 DUMPABLE_RINGS)
+            {
+                const FlightRecorderRing* ring = r.load();
+
+                if (ring == nullptr)
+                {
+                    continue;
+                }
+
+                const std::uint64_t end =
+                    ring->next_event.load(std::memory_order_acquire);
+
+                DumpCursor& cursor = DUMP_CURSORS[cursors++]; // NOLINT
+
+                cursor.ring       = ring;
+                cursor.end_event  = end;
+                cursor.next_event = end > FlightRecorderCapacity
+                                      ? end - FlightRecorderCapacity
+                                      : 0;
+                cursor.advance();
+
+                if (ring->has_exited.load(std::memory_order_acquire))
+                {
+                    ++exitedThreads;
+                }
+                else
+                {
+                    ++liveThreads;
+                }
+            }
+
+            const TimestampSample now = sampleTimestamp();
+
+            const double nanosecondsPerTick =
+                now.ticks == PROCESS_START_SAMPLE.ticks
+                    ? 1.0
+                    : static_cast<double>(
+                          std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              now.time - PROCESS_START_SAMPLE.time)
+                              .count())
+                          / static_cast<double>(
+                              now.ticks - PROCESS_START_SAMPLE.ticks);
+
+            DumpWriter& out = DUMP_WRITER;
+
+            if (!out.open("verdigris_flight_recorder.txt"))
+            {
+                ACTIVE_DUMPS.fetch_sub(1);
+
+                return;
+            }
+
+            out.append("Flight recorder | ");
+            out.appendNumber(liveThreads, 0);
+            out.append(" live threads | ");
+            out.appendNumber(exitedThreads, 0);
+            out.append(" retired threads\n");
+
+            std::size_t events = 0;
+
+            // Each ring is already in timestamp order, so merge them
+            while (true)
+            {
+                DumpCursor* earliest = nullptr;
+
+                for (DumpCursor& cursor :
+                     std::span {DUMP_CURSORS.data(), cursors})
+                {
+                    if (cursor.has_event
+                        && (earliest == nullptr
+                            || cursor.event.timestamp
+                                   < earliest->event.timestamp))
+                    {
+                        earliest = &cursor;
+                    }
+                }
+
+                if (earliest == nullptr)
+                {
+                    break;
+                }
+
+                const FlightRecorderEvent& event = earliest->event;
+
+                // Relative to the time of the dump
+                const double millisecondsAgo =
+                    static_cast<double>(now.ticks - event.timestamp)
+                    * nanosecondsPerTick / 1'000'000.0;
+
+                out.append("[-");
+                out.appendNumber(
+                    millisecondsAgo, 12, std::chars_format::fixed, 6);
+                out.append("ms] [thread ");
+                out.appendNumber(earliest->ring->thread_index, 3);
+                out.append("] [");
+                out.append(event.location.file_name());
+                out.append(":");
+                out.appendNumber(event.location.line(), 0);
+                out.append("] ");
+                out.append(event.name);
+
+                for (std::size_t i = 0; i < FlightRecorderEvent::MaxArguments;
+                     ++i)
+                {
+                    if (event.argument_types[i] // NOLINT
+                        == FlightRecorderArgument::None)
+                    {
+                        break;
+                    }
+
+                    out.append(" | ");
+                    out.appendArgument(
+                        event.arguments[i],       // NOLINT
+                        event.argument_types[i]); // NOLINT
+                }
+
+                out.append("\n");
+
+                ++events;
+                earliest->advance();
+            }
+
+            out.append("Flight recorder | ");
+            out.appendNumber(events, 0);
+            out.append(" events\n");
+
+            out.close();
+
+            ACTIVE_DUMPS.fetch_sub(1);
+        }
+
+        // Unlike dumpFlightRecorder() this never lets another dump run, as
+        // the abort that follows a crash dump would otherwise overwrite it
+        void dumpFlightRecorderOnCrash() noexcept
+        {
+            if (IS_DUMPING.exchange(true, std::memory_order_acq_rel))
+            {
+                return;
+            }
+
+            writeFlightRecorder();
+        }
+
+        std::terminate_handler PREVIOUS_TERMINATE_HANDLER {nullptr}; // NOLINT
+
+        void flightRecorderSignalHandler(int signal)
+        {
+            dumpFlightRecorderOnCrash();
+
+            std::ignore = std::signal(signal, SIG_DFL);
+            std::ignore = std::raise(signal);
+        }
+    } // namespace
+
+    void recordFlightEvent(const FlightRecorderEvent& event) noexcept
+    {
+        FlightRecorderRing& ring = getThreadFlightRecorder();
+
+        const std::uint64_t index =
+            ring.next_event.load(std::memory_order_relaxed);
+        const std::size_t slot = index % FlightRecorderCapacity;
+
+        std::array<std::uint64_t, EventWords> words {};
+        std::memcpy(words.data(), &event, sizeof(FlightRecorderEvent));
+
+        ring.sequences[slot].store( // NOLINT
+            (2 * index) + 1,
+            std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (std::size_t i = 0; i < EventWords; ++i)
+        {
+            ring.events[slot][i].store( // NOLINT
+                words[i],
+                std::memory_order_relaxed);
+        }
+
+        ring.sequences[slot].store( // NOLINT
+            (2 * index) + 2,
+            std::memory_order_release);
+
+        ring.next_event.store(index + 1, std::memory_order_release);
+    }
+
+    std::uint64_t getFlightRecorderTimestamp() noexcept
+    {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(
+            std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    void dumpFlightRecorder() noexcept
+    {
+        // Only one dump at a time, a crash during a dump shouldn't recurse
+        if (IS_DUMPING.exchange(true, std::memory_order_acq_rel))
+        {
+            return;
+        }
+
+        writeFlightRecorder();
+
+        IS_DUMPING.store(false, std::memory_order_release);
+    }
+
+    void installFlightRecorderCrashHandlers()
+    {
+        PREVIOUS_TERMINATE_HANDLER = std::set_terminate(
+            []
+            {
+                dumpFlightRecorderOnCrash();
+
+                if (PREVIOUS_TERMINATE_HANDLER != nullptr)
+                {
+                    PREVIOUS_TERMINATE_HANDLER();
+                }
+
+                std::abort();
+            });
+
+        for (int signal : {SIGSEGV, SIGILL, SIGFPE, SIGABRT})
+        {
+            std::ignore = std::signal(signal, flightRecorderSignalHandler);
+        }
+    }
+} // namespace util
@@ -0,0 +1,135 @@
+#ifndef SRC_UTIL_FLIGHT_RECORDER_HPP
+#define SRC_UTIL_FLIGHT_RECORDER_HPP
+
+#include "misc.hpp"
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <source_location>
+#include <utility>
+
+namespace util
+{
+    /// An always on, per thread record of the last few thousand events that
+    /// happened on that thread. Each event is a fixed size binary record with
+    /// no formatting or allocation, so it's cheap enough to leave in hot
+    /// paths. Every thread's events are decoded and written to
+    /// `verdigris_flight_recorder.txt` when `panic` or `assertFatal` fire, or
+    /// when the process crashes.
+    enum class FlightRecorderArgument : std::uint8_t
+    {
+        None     = 0,
+        Signed   = 1,
+        Unsigned = 2,
+        Floating = 3,
+        Boolean  = 4,
+    };
+
+    struct FlightRecorderEvent
+    {
+        static constexpr std::size_t MaxArguments = 3;
+
+        std::uint64_t                                    timestamp;
+        const char*                                      name;
+        std::source_location                             location;
+        std::array<std::uint64_t, MaxArguments>          arguments;
+        std::array<FlightRecorderArgument, MaxArguments> argument_types;
+    };
+
+    template<class T>
+    concept FlightRecorderScalar = requires {
+        requires Arithmetic<std::remove_cvref_t<T>>
+                     || std::same_as<std::remove_cvref_t<T>, bool>
+                     || std::is_enum_v<std::remove_cvref_t<T>>;
+    };
+
+    void recordFlightEvent(const FlightRecorderEvent&) noexcept;
+    [[nodiscard]] std::uint64_t getFlightRecorderTimestamp() noexcept;
+
+    // Decodes every thread's events to disk, safe to call at any time and
+    // from any thread, including from a signal handler as it neither locks
+    // nor allocates. Events overwritten while it runs are skipped
+    void dumpFlightRecorder() noexcept;
+
+    // Dumps the flight recorder on std::terminate and fatal signals
+    void installFlightRecorderCrashHandlers();
+
+    template<FlightRecorderScalar T>
+    constexpr std::pair<std::uint64_t, FlightRecorderArgument>
+    encodeFlightRecorderArgument(T t) noexcept
+    {
+        using V = std::remove_cvref_t<T>;
+
+        if constexpr (std::is_enum_v<V>)
+        {
+            return encodeFlightRecorderArgument(std::to_underlying(t));
+        }
+        else if constexpr (std::same_as<V, bool>)
+        {
+            return {
+                static_cast<std::uint64_t>(t), FlightRecorderArgument::Boolean};
+        }
+        else if constexpr (std::floating_point<V>)
+        {
+            return {
+                std::bit_cast<std::uint64_t>(static_cast<double>(t)),
+                FlightRecorderArgument::Floating};
+        }
+        else if constexpr (std::is_signed_v<V>)
+        {
+            return {
+                std::bit_cast<std::uint64_t>(static_cast<std::int64_t>(t)),
+                FlightRecorderArgument::Signed};
+        }
+        else
+        {
+            return {
+                static_cast<std::uint64_t>(t),
+                FlightRecorderArgument::Unsigned};
+        }
+    }
+
+    /// Usage:
+    /// util::recordEvent("Chunk volume generated", x, y, z);
+    /// `name` must be a string literal, it's only formatted when dumping
+    template<FlightRecorderScalar... Ts>
+        requires (sizeof...(Ts) <= FlightRecorderEvent::MaxArguments)
+    struct recordEvent // NOLINT: we want to lie and pretend this is a function
+    {
+        recordEvent( // NOLINT
+            const char* name,
+            Ts... args,
+            const std::source_location& location =
+                std::source_location::current()) noexcept
+        {
+            FlightRecorderEvent event {
+                .timestamp {getFlightRecorderTimestamp()},
+                .name {name},
+                .location {location},
+                .arguments {},
+                .argument_types {},
+            };
+
+            [[maybe_unused]] std::size_t index = 0;
+
+            (
+                [&]
+                {
+                    const auto [value, type] =
+                        encodeFlightRecorderArgument(args);
+
+                    event.arguments[index]      = value; // NOLINT
+                    event.argument_types[index] = type;  // NOLINT
+                    ++index;
+                }(),
+                ...);
+
+            recordFlightEvent(event);
+        }
+    };
+    template<class... Ts>
+    recordEvent(const char*, Ts...) -> recordEvent<Ts...>;
+
+} // namespace util
+
+#endif // SRC_UTIL_FLIGHT_RECORDER_HPP
@@ -1,9 +1,11 @@
 #include "log.hpp"
 #include "threads.hpp"
+#include <array>
 #include <atomic>
 #include <fmt/chrono.h>
 #include <fstream>
 #include <latch>
+#include <lightweightsemaphore.h>
 
 namespace util
 {
@@ -28,6 +30,279 @@ namespace util
         return "Unknown level";
     }
 
+    namespace
+    {
+        // the maximum size of a batch before the worker will write it out,
+        // regardless of how much of the flush latency is remaining
+        constexpr std::size_t LoggerBatchFlushThreshold = 64UZ * 1024UZ;
+
+        // the maximum number of messages pulled out of the queue per dequeue
+        constexpr std::size_t LoggerDequeueBulkSize = 256;
+
+        std::atomic<std::chrono::microseconds> // NOLINT
+            LOGGING_FLUSH_LATENCY {std::chrono::milliseconds {4}};
+
+        std::string formatLogMessage(
+            std::string_view                      message,
+            LoggingLevel                          level,
+            std::source_location                  location,
+            std::chrono::system_clock::time_point time)
+        {
+            return fmt::format(
+                "[{0}] [{1}] [{2}] {3}\n",
+                [&] // 0 time
+                {
+                    std::string workingString {31, ' '}; // NOLINT
+
+                    workingString = fmt::format(
+                        "{:0%b %m/%d/%Y %I:%M}:{:%S}",
+                        fmt::localtime(
+                            std::chrono::system_clock::to_time_t(time)),
+                        time);
+
+                    workingString.erase(30, std::string::npos); // NOLINT
+
+                    workingString.at(workingString.size() - 7) = ':'; // NOLINT
+                    workingString.insert(workingString.size() - 3, ":");
+
+                    return workingString;
+                }(),
+                [&] // 1 location
+                {
+                    constexpr std::array<std::string_view, 2>
+                        FolderIdentifiers {"/src/", "/inc/"};
+                    std::string rawFileName {location.file_name()};
+
+                    std::size_t index = std::string::npos;
+
+                    for (std::string_view str : FolderIdentifiers)
+                    {
+                        if (index != std::string::npos)
+                        {
+                            break;
+                        }
+
+                        index = rawFileName.find(str);
+                    }
+
+                    return fmt::format(
+                        "{}:{}:{}",
+                        rawFileName.substr(index + 1),
+                        location.line(),
+                        location.column());
+                }(),
+                [&] // 2 message level
+                {
+                    return LoggingLevel_asString(level);
+                }(),
+                message);
+        }
+
+        struct QueuedLogMessage
+        {
+            std::string                           message;
+            LoggingLevel                          level;
+            std::source_location                  location;
+            std::chrono::system_clock::time_point time;
+        };
+
+        struct TimestampedLogMessage
+        {
+            std::chrono::system_clock::time_point time;
+            std::string                           output;
+        };
+
+        /// Single producer single consumer ring buffer of
+        /// `DeferredLogRecordHeader`s and their arguments.
+        /// Written to only by the thread that owns it, read from only by the
+        /// logger's worker thread
+        class DeferredLogRing
+        {
+        public:
+            static constexpr std::size_t Capacity = 128UZ * 1024UZ;
+
+            DeferredLogRing()
+                : storage {std::make_unique<std::byte[]>(Capacity)}
+                , reserved_position {0}
+                , reserved_size {0}
+                , is_abandoned {false}
+                , write_position {0}
+                , read_position {0}
+            {}
+            ~DeferredLogRing() = default;
+
+            DeferredLogRing(const DeferredLogRing&)             = delete;
+            DeferredLogRing(DeferredLogRing&&)                  = delete;
+            DeferredLogRing& operator= (const DeferredLogRing&) = delete;
+            DeferredLogRing& operator= (DeferredLogRing&&)      = delete;
+
+            std::byte* reserve(std::size_t recordSize)
+            {
+                const std::uint64_t writePosition =
+                    this->write_position.load(std::memory_order_relaxed);
+                const std::uint64_t readPosition =
+                    this->read_position.load(std::memory_order_acquire);
+
+                const std::size_t offset   = writePosition % Capacity;
+                const std::size_t untilEnd = Capacity - offset;
+
+                // records are always contiguous, if this one doesn't fit
+                // before the end of the buffer we skip to the start
+                const std::size_t padding =
+                    untilEnd < recordSize ? untilEnd : 0;
+
+                if (writePosition + padding + recordSize - readPosition
+                    > Capacity)
+                {
+                    return nullptr;
+                }
+
+                // If there's not even room for a header the reader will
+                // implicitly skip to the start, otherwise leave it a marker
+                if (padding >= sizeof(DeferredLogRecordHeader))
+                {
+                    const DeferredLogRecordHeader wrapMarker {
+                        .format {nullptr},
+                        .format_string {nullptr},
+                        .format_size {0},
+                        .location {},
+                        .time {},
+                        .record_size {0},
+                        .level {},
+                    };
+
+                    std::memcpy(
+                        &this->storage[offset],
+                        &wrapMarker,
+                        sizeof(DeferredLogRecordHeader));
+                }
+
+                this->reserved_position = writePosition + padding;
+                this->reserved_size     = recordSize;
+
+                return &this->storage[this->reserved_position % Capacity];
+            }
+
+            void commit()
+            {
+                this->write_position.store(
+                    this->reserved_position + this->reserved_size,
+                    std::memory_order_release);
+            }
+
+            // Returns the number of records that were read
+            std::size_t drain(std::invocable<
+                              const DeferredLogRecordHeader&,
+                              const std::byte*> auto onRecord)
+            {
+                std::uint64_t readPosition =
+                    this->read_position.load(std::memory_order_relaxed);
+                const std::uint64_t writePosition =
+                    this->write_position.load(std::memory_order_acquire);
+
+                std::size_t numberOfRecords = 0;
+
+                while (readPosition != writePosition)
+                {
+                    const std::size_t offset   = readPosition % Capacity;
+                    const std::size_t untilEnd = Capacity - offset;
+
+                    if (untilEnd < sizeof(DeferredLogRecordHeader))
+                    {
+                        readPosition += untilEnd;
+                        continue;
+                    }
+
+                    DeferredLogRecordHeader header; // NOLINT
+                    std::memcpy(
+                        &header,
+                        &this->storage[offset],
+                        sizeof(DeferredLogRecordHeader));
+
+                    if (header.format == nullptr)
+                    {
+                        readPosition += untilEnd;
+                        continue;
+                    }
+
+                    onRecord(
+                        header,
+                        &this->storage
+                             [offset + sizeof(DeferredLogRecordHeader)]);
+
+                    readPosition += header.record_size;
+                    ++numberOfRecords;
+                }
+
+                this->read_position.store(
+                    readPosition, std::memory_order_release);
+
+                return numberOfRecords;
+            }
+
+            void abandon()
+            {
+                this->is_abandoned.store(true, std::memory_order_release);
+            }
+
+            [[nodiscard]] bool isAbandoned() const
+            {
+                return this->is_abandoned.load(std::memory_order_acquire);
+            }
+
+        private:
+            std::unique_ptr<std::byte[]> storage;
+
+            // Producer only
+            std::uint64_t     reserved_position;
+            std::size_t       reserved_size;
+            std::atomic<bool> is_abandoned;
+
+            // kept on separate cache lines as they're written by different
+            // threads
+            alignas(64) std::atomic<std::uint64_t> write_position; // NOLINT
+            alignas(64) std::atomic<std::uint64_t> read_position;  // NOLINT
+        };
+
+        // All rings that the worker thread needs to drain
+        Mutex<std::vector<std::shared_ptr<DeferredLogRing>>> // NOLINT
+            DEFERRED_LOG_RINGS {};
+
+        // Owns this thread's ring, marks it as abandoned on thread exit so
+        // that the worker knows to remove it once it has been drained
+        struct ThreadDeferredLogRing
+        {
+            ThreadDeferredLogRing()
+                : ring {std::make_shared<DeferredLogRing>()}
+            {
+                DEFERRED_LOG_RINGS.lock(
+                    [&](std::vector<std::shared_ptr<DeferredLogRing>>& rings)
+                    {
+                        rings.push_back(this->ring);
+                    });
+            }
+            ~ThreadDeferredLogRing()
+            {
+                this->ring->abandon();
+            }
+
+            ThreadDeferredLogRing(const ThreadDeferredLogRing&) = delete;
+            ThreadDeferredLogRing(ThreadDeferredLogRing&&)      = delete;
+            ThreadDeferredLogRing&
+            operator= (const ThreadDeferredLogRing&) = delete;
+            ThreadDeferredLogRing& operator= (ThreadDeferredLogRing&&) = delete;
+
+            std::shared_ptr<DeferredLogRing> ring;
+        };
+
+        DeferredLogRing& getThreadDeferredLogRing()
+        {
+            thread_local ThreadDeferredLogRing threadRing {};
+
+            return *threadRing.ring;
+        }
+    } // namespace
+
     class Logger
     {
     public:
@@ -40,112 +315,236 @@ namespace util
         Logger& operator= (const Logger&) = delete;
         Logger& operator= (Logger&&)      = delete;
 
-        void send(std::string);
+        void send(QueuedLogMessage);
         void sendBlocking(std::string);
+        void notify();
 
     private:
         std::unique_ptr<std::atomic<bool>> should_thread_close {};
         std::thread                        worker_thread;
-        std::unique_ptr<moodycamel::ConcurrentQueue<std::string>> message_queue;
+        std::unique_ptr<moodycamel::ConcurrentQueue<QueuedLogMessage>>
+                                                          message_queue;
+        std::unique_ptr<moodycamel::LightweightSemaphore> pending_messages;
+        // Set from the first notify() after the worker last woke until it
+        // wakes again, so a burst of messages signals the worker once
+        // rather than leaving it a wake per message to spin through
+        std::unique_ptr<std::atomic<bool>>    wake_pending;
         std::unique_ptr<Mutex<std::ofstream>> log_file_handle;
     };
 
     Logger::Logger()
         : should_thread_close {std::make_unique<std::atomic<bool>>(false)}
         , message_queue {std::make_unique<
-              moodycamel::ConcurrentQueue<std::string>>()}
+              moodycamel::ConcurrentQueue<QueuedLogMessage>>()}
+        , pending_messages {
+              std::make_unique<moodycamel::LightweightSemaphore>()}
+        , wake_pending {std::make_unique<std::atomic<bool>>(false)}
         , log_file_handle {std::make_unique<util::Mutex<std::ofstream>>(
-              std::ofstream {"verdigris_log.txt"})}
+              std::ofstream {"verdigris_log.txt"},
+              std::source_location::current())}
     {
         std::latch threadStartLatch {1};
 
         this->worker_thread = std::thread {
             [this, loggerConstructionLatch = &threadStartLatch]
             {
-                std::ofstream logFileHandle {"verdigris_log.txt"};
-                std::string   temporaryString {"INVALID MESSAGE"};
+                std::vector<QueuedLogMessage> messages {};
+                messages.resize(LoggerDequeueBulkSize);
+
+                std::vector<TimestampedLogMessage> outputs {};
+                std::string                        batch {};
+                batch.reserve(LoggerBatchFlushThreshold * 2);
 
                 std::atomic<bool>* shouldThreadStop {
                     this->should_thread_close.get()};
 
-                moodycamel::ConcurrentQueue<std::string>* messageQueue {
+                moodycamel::ConcurrentQueue<QueuedLogMessage>* messageQueue {
                     this->message_queue.get()};
 
+                moodycamel::LightweightSemaphore* pendingMessages {
+                    this->pending_messages.get()};
+
+                std::atomic<bool>* wakePending {this->wake_pending.get()};
+
+                Mutex<std::ofstream>* logFileHandle {
+                    this->log_file_handle.get()};
+
                 loggerConstructionLatch->count_down();
                 // after this latch:
                 // `this` may be dangling
                 // loggerConstructionLatch is dangling
 
-                // Main loop
-                while (!shouldThreadStop->load(std::memory_order_acquire))
+                // Pulls everything currently available from the queue and
+                // every thread's ring, formats it and appends it to the batch
+                auto drainMessages = [&]
                 {
-                    if (messageQueue->try_dequeue(temporaryString))
+                    // Cleared before draining so that anything sent after
+                    // this signals again. Every notify() that saw it set is
+                    // ordered before this, so what it sent is drained below
+                    std::ignore = wakePending->exchange(
+                        false, std::memory_order_acq_rel);
+
+                    while (std::size_t dequeuedMessages =
+                               messageQueue->try_dequeue_bulk(
+                                   messages.begin(), messages.size()))
                     {
-                        std::ignore = std::fwrite(
-                            temporaryString.data(),
-                            sizeof(char),
-                            temporaryString.size(),
-                            stdout);
-
-                        this->log_file_handle->lock(
-                            [&](std::ofstream& stream)
-                            {
-                                std::ignore = stream.write(
-                                    temporaryString.c_str(),
-                                    static_cast<std::streamsize>(
-                                        temporaryString.size()));
-                            });
+                        for (std::size_t i = 0; i < dequeuedMessages; ++i)
+                        {
+                            QueuedLogMessage& m = messages[i];
+
+                            outputs.push_back(TimestampedLogMessage {
+                                .time {m.time},
+                                .output {formatLogMessage(
+                                    m.message, m.level, m.location, m.time)}});
+                        }
                     }
-                }
 
-                // Cleanup loop
-                while (messageQueue->try_dequeue(temporaryString))
+                    DEFERRED_LOG_RINGS.lock(
+                        [&](std::vector<std::shared_ptr<DeferredLogRing>>&
+                                rings)
+                        {
+                            std::erase_if(
+                                rings,
+                                [&](const std::shared_ptr<DeferredLogRing>&
+                                        ring)
+                                {
+                                    // must be checked before draining, a ring
+                                    // can't be written to once abandoned
+                                    const bool wasAbandoned =
+                                        ring->isAbandoned();
+
+                                    std::ignore = ring->drain(
+                                        [&](const DeferredLogRecordHeader& h,
+                                            const std::byte* arguments)
+                                        {
+                                            outputs.push_back(
+                                                TimestampedLogMessage {
+                                                    .time {h.time},
+                                                    .output {formatLogMessage(
+                                                        h.format(
+                                                            {h.format_string,
+                                                             h.format_size},
+                                                            arguments),
+                                                        h.level,
+                                                        h.location,
+                                                        h.time)}});
+                                        });
+
+                                    return wasAbandoned;
+                                });
+                        });
+
+                    // each source is ordered, but they need to be interleaved
+                    std::ranges::stable_sort(
+                        outputs, {}, &TimestampedLogMessage::time);
+
+                    for (const TimestampedLogMessage& m : outputs)
+                    {
+                        batch.append(m.output);
+                    }
+
+                    outputs.clear();
+                };
+
+                auto writeBatch = [&]
                 {
+                    if (batch.empty())
+                    {
+                        return;
+                    }
+
                     std::ignore = std::fwrite(
-                        temporaryString.data(),
-                        sizeof(char),
-                        temporaryString.size(),
-                        stdout);
+                        batch.data(), sizeof(char), batch.size(), stdout);
+                    std::ignore = std::fflush(stdout);
 
-                    this->log_file_handle->lock(
+                    logFileHandle->lock(
                         [&](std::ofstream& stream)
                         {
                             std::ignore = stream.write(
-                                temporaryString.c_str(),
-                                static_cast<std::streamsize>(
-                                    temporaryString.size()));
+                                batch.data(),
+                                static_cast<std::streamsize>(batch.size()));
+                            std::ignore = stream.flush();
                         });
+
+                    batch.clear();
+                };
+
+                // Main loop
+                while (!shouldThreadStop->load(std::memory_order_acquire))
+                {
+                    // Sleep until there's something to do, the destructor
+                    // signals once more to wake us for shutdown
+                    std::ignore = pendingMessages->wait();
+
+                    drainMessages();
+
+                    // Keep gathering messages for up to the flush latency so
+                    // that bursts of logging get written out all at once
+                    const std::chrono::steady_clock::time_point flushDeadline =
+                        std::chrono::steady_clock::now()
+                        + LOGGING_FLUSH_LATENCY.load(std::memory_order_relaxed);
+
+                    while (batch.size() < LoggerBatchFlushThreshold)
+                    {
+                        const std::chrono::steady_clock::duration remaining =
+                            flushDeadline - std::chrono::steady_clock::now();
+
+                        if (remaining <= std::chrono::steady_clock::duration {})
+                        {
+                            break;
+                        }
+
+                        if (!pendingMessages->wait(
+                                std::chrono::duration_cast<
+                                    std::chrono::microseconds>(remaining)
+                                    .count()))
+                        {
+                            break;
+                        }
+
+                        drainMessages();
+                    }
+
+                    writeBatch();
                 }
+
+                // Cleanup
+                drainMessages();
+                writeBatch();
             }};
 
         threadStartLatch.wait();
     }
+
     Logger::~Logger()
     {
         if (this->should_thread_close != nullptr)
         {
             this->should_thread_close->store(true, std::memory_order_release);
 
+            // wake the worker if it's asleep waiting for a message
+            this->notify();
+
             this->worker_thread.join();
         }
     }
 
-    void Logger::send(std::string string)
+    void Logger::send(QueuedLogMessage message)
     {
-        if (!this->message_queue->enqueue(std::move(string)))
+        if (!this->message_queue->enqueue(std::move(message)))
         {
             std::puts("Unable to send message to worker thread!\n");
-            std::ignore =
-                std::fwrite(string.data(), sizeof(char), string.size(), stderr);
 
-            this->log_file_handle->lock(
-                [&](std::ofstream& stream)
-                {
-                    std::ignore = stream.write(
-                        string.c_str(),
-                        static_cast<std::streamsize>(string.size()));
-                });
+            this->sendBlocking(formatLogMessage(
+                message.message,
+                message.level,
+                message.location,
+                message.time));
+
+            return;
         }
+
+        this->notify();
     }
 
     void Logger::sendBlocking(std::string string)
@@ -162,12 +561,260 @@ namespace util
             });
     }
 
+    void Logger::notify()
+    {
+        if (!this->wake_pending->exchange(true, std::memory_order_acq_rel))
+        {
+            this->pending_messages->signal();
+        }
+    }
+
     namespace
     {
         std::atomic<Logger*>      LOGGER {nullptr};                    // NOLINT
         std::atomic<LoggingLevel> LOGGING_LEVEL {LoggingLevel::Trace}; // NOLINT
+
+        // Must be a power of two, call sites past this aren't rate limited
+        constexpr std::size_t LogCallSiteTableSize = 4096;
+
+        struct LogRateLimitOverride
+        {
+            std::string   file_suffix;
+            std::uint32_t line;
+            LogRateLimit  limit;
+        };
+
+        struct LogRateLimitPolicies
+        {
+            LogRateLimit                      default_limit;
+            std::vector<LogRateLimitOverride> overrides;
+        };
+
+        struct LogCallSite
+        {
+            // 0 when this slot is empty
+            std::atomic<std::uint64_t> key;
+            std::atomic<std::uint64_t> policy_generation;
+
+            // Only valid once `policy_generation` is non zero
+            std::atomic<std::uint32_t> every_nth;
+            std::atomic<std::uint32_t> max_per_second;
+            std::source_location       location;
+
+            std::atomic<std::uint64_t> calls;
+            std::atomic<std::int64_t>  window_start_milliseconds;
+            std::atomic<std::uint32_t> messages_in_window;
+            std::atomic<std::uint64_t> suppressed_messages;
+        };
+
+        // NOLINTBEGIN
+        std::array<LogCallSite, LogCallSiteTableSize> LOG_CALL_SITES {};
+        std::atomic<bool>           ARE_LOG_RATE_LIMITS_ENABLED {false};
+        std::atomic<std::uint64_t>  LOG_RATE_LIMIT_GENERATION {1};
+        Mutex<LogRateLimitPolicies> LOG_RATE_LIMIT_POLICIES {};
+        // NOLINTEND
+
+        void updateLogRateLimitPolicies(
+            std::invocable<LogRateLimitPolicies&> auto func)
+        {
+            LOG_RATE_LIMIT_POLICIES.lock(
+                [&](LogRateLimitPolicies& policies)
+                {
+                    func(policies);
+
+                    const bool isDefaultUnlimited =
+                        policies.default_limit.every_nth <= 1
+                        && policies.default_limit.max_per_second == 0;
+
+                    ARE_LOG_RATE_LIMITS_ENABLED.store(
+                        !isDefaultUnlimited || !policies.overrides.empty(),
+                        std::memory_order_release);
+                });
+
+            // Every call site will re-resolve its policy on its next call
+            LOG_RATE_LIMIT_GENERATION.fetch_add(1, std::memory_order_acq_rel);
+        }
+
+        void resolveLogRateLimit(LogCallSite& site, std::uint64_t generation)
+        {
+            LOG_RATE_LIMIT_POLICIES.lock(
+                [&](const LogRateLimitPolicies& policies)
+                {
+                    const std::string_view fileName {
+                        site.location.file_name()};
+
+                    LogRateLimit limit = policies.default_limit;
+
+                    // later overrides take precedence
+                    for (const LogRateLimitOverride& o : policies.overrides)
+                    {
+                        if (fileName.ends_with(o.file_suffix)
+                            && (o.line == 0 || o.line == site.location.line()))
+                        {
+                            limit = o.limit;
+                        }
+                    }
+
+                    site.every_nth.store(
+                        std::max(limit.every_nth, 1U),
+                        std::memory_order_relaxed);
+                    site.max_per_second.store(
+                        limit.max_per_second, std::memory_order_relaxed);
+                });
+
+            site.policy_generation.store(
+                generation, std::memory_order_release);
+        }
+
+        LogCallSite* findLogCallSite(const std::source_location& location)
+        {
+            std::size_t hash = 0;
+            util::hashCombine(
+                hash, std::bit_cast<std::size_t>(location.file_name()));
+            util::hashCombine(hash, location.line());
+            util::hashCombine(hash, location.column());
+
+            // 0 is reserved for empty slots
+            const std::uint64_t key = static_cast<std::uint64_t>(hash) | 1;
+
+            for (std::size_t i = 0; i < LogCallSiteTableSize; ++i)
+            {
+                LogCallSite& site =
+                    LOG_CALL_SITES[(hash + i) % LogCallSiteTableSize];
+
+                std::uint64_t existingKey =
+                    site.key.load(std::memory_order_acquire);
+
+                if (existingKey == 0
+                    && site.key.compare_exchange_strong(
+                        existingKey, key, std::memory_order_acq_rel))
+                {
+                    site.location = location;
+                    site.window_start_milliseconds.store(
+                        std::numeric_limits<std::int64_t>::min() / 2,
+                        std::memory_order_relaxed);
+
+                    resolveLogRateLimit(
+                        site,
+                        LOG_RATE_LIMIT_GENERATION.load(
+                            std::memory_order_acquire));
+
+                    return &site;
+                }
+
+                if (existingKey == key)
+                {
+                    // Someone else is still initializing this slot
+                    while (site.policy_generation.load(
+                               std::memory_order_acquire)
+                           == 0)
+                    {
+                        std::this_thread::yield();
+                    }
+
+                    return &site;
+                }
+            }
+
+            return nullptr;
+        }
     } // namespace
 
+    void setDefaultLogRateLimit(LogRateLimit limit)
+    {
+        updateLogRateLimitPolicies(
+            [&](LogRateLimitPolicies& policies)
+            {
+                policies.default_limit = limit;
+            });
+    }
+
+    void setLogRateLimit(
+        std::string_view fileSuffix, std::uint32_t line, LogRateLimit limit)
+    {
+        updateLogRateLimitPolicies(
+            [&](LogRateLimitPolicies& policies)
+            {
+                policies.overrides.push_back(LogRateLimitOverride {
+                    .file_suffix {std::string {fileSuffix}},
+                    .line {line},
+                    .limit {limit}});
+            });
+    }
+
+    bool admitLogFromCallSite(
+        const std::source_location& location,
+        std::uint64_t&              suppressedMessages)
+    {
+        if (!ARE_LOG_RATE_LIMITS_ENABLED.load(std::memory_order_relaxed))
+        {
+            return true;
+        }
+
+        LogCallSite* const maybeSite = findLogCallSite(location);
+
+        if (maybeSite == nullptr)
+        {
+            return true;
+        }
+
+        LogCallSite& site = *maybeSite;
+
+        const std::uint64_t currentGeneration =
+            LOG_RATE_LIMIT_GENERATION.load(std::memory_order_acquire);
+
+        if (site.policy_generation.load(std::memory_order_acquire)
+            != currentGeneration)
+        {
+            resolveLogRateLimit(site, currentGeneration);
+        }
+
+        const std::uint64_t call =
+            site.calls.fetch_add(1, std::memory_order_relaxed);
+
+        if (call % site.every_nth.load(std::memory_order_relaxed) != 0)
+        {
+            site.suppressed_messages.fetch_add(1, std::memory_order_relaxed);
+
+            return false;
+        }
+
+        if (const std::uint32_t maxPerSecond =
+                site.max_per_second.load(std::memory_order_relaxed);
+            maxPerSecond != 0)
+        {
+            const std::int64_t now =
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch())
+                    .count();
+
+            std::int64_t windowStart =
+                site.window_start_milliseconds.load(std::memory_order_relaxed);
+
+            if (now - windowStart >= 1000
+                && site.window_start_milliseconds.compare_exchange_strong(
+                    windowStart, now, std::memory_order_relaxed))
+            {
+                site.messages_in_window.store(0, std::memory_order_relaxed);
+            }
+
+            if (site.messages_in_window.fetch_add(
+                    1, std::memory_order_relaxed)
+                >= maxPerSecond)
+            {
+                site.suppressed_messages.fetch_add(
+                    1, std::memory_order_relaxed);
+
+                return false;
+            }
+        }
+
+        suppressedMessages =
+            site.suppressed_messages.exchange(0, std::memory_order_relaxed);
+
+        return true;
+    }
+
     void installGlobalLoggerRacy()
     {
         LOGGER.store(
@@ -181,6 +828,30 @@ namespace util
 
     void removeGlobalLoggerRacy()
     {
+        // Summary of every call site that has suppressed messages that
+        // haven't been reported yet
+        for (LogCallSite& site : LOG_CALL_SITES)
+        {
+            if (site.policy_generation.load(std::memory_order_acquire) == 0)
+            {
+                continue;
+            }
+
+            if (const std::uint64_t suppressedMessages =
+                    site.suppressed_messages.exchange(
+                        0, std::memory_order_relaxed);
+                suppressedMessages != 0)
+            {
+                asynchronouslyLog(
+                    fmt::format(
+                        "Suppressed {} messages from this call site",
+                        suppressedMessages),
+                    LoggingLevel::Log,
+                    site.location,
+                    std::chrono::system_clock::now());
+            }
+        }
+
         Logger* const currentLogger =
             LOGGER.exchange(nullptr, std::memory_order_seq_cst);
 
@@ -208,69 +879,50 @@ namespace util
         return LOGGING_LEVEL.load(std::memory_order_relaxed);
     }
 
-    void asynchronouslyLog(
-        std::string                           message,
-        LoggingLevel                          level,
-        std::source_location                  location,
-        std::chrono::system_clock::time_point time)
+    void setLoggingFlushLatency(std::chrono::microseconds latency)
     {
-        std::string output = fmt::format(
-            "[{0}] [{1}] [{2}] {3}\n",
-            [&] // 0 time
-            {
-                std::string workingString {31, ' '}; // NOLINT
-
-                workingString = fmt::format(
-                    "{:0%b %m/%d/%Y %I:%M}:{:%S}",
-                    fmt::localtime(std::chrono::system_clock::to_time_t(time)),
-                    time);
-
-                workingString.erase(30, std::string::npos); // NOLINT
-
-                workingString.at(workingString.size() - 7) = ':'; // NOLINT
-                workingString.insert(workingString.size() - 3, ":");
-
-                return workingString;
-            }(),
-            [&] // 1 location
-            {
-                constexpr std::array<std::string_view, 2> FolderIdentifiers {
-                    "/src/", "/inc/"};
-                std::string rawFileName {location.file_name()};
+        LOGGING_FLUSH_LATENCY.store(latency, std::memory_order_relaxed);
+    }
 
-                std::size_t index = std::string::npos;
+    std::chrono::microseconds getLoggingFlushLatency()
+    {
+        return LOGGING_FLUSH_LATENCY.load(std::memory_order_relaxed);
+    }
 
-                for (std::string_view str : FolderIdentifiers)
-                {
-                    if (index != std::string::npos)
-                    {
-                        break;
-                    }
+    std::byte* reserveDeferredLogRecord(std::size_t recordSize)
+    {
+        return getThreadDeferredLogRing().reserve(recordSize);
+    }
 
-                    index = rawFileName.find(str);
-                }
+    void commitDeferredLogRecord()
+    {
+        getThreadDeferredLogRing().commit();
 
-                return fmt::format(
-                    "{}:{}:{}",
-                    rawFileName.substr(index + 1),
-                    location.line(),
-                    location.column());
-            }(),
-            [&] // 2 message level
-            {
-                return LoggingLevel_asString(level);
-            }(),
-            message);
+        // the previous memory fences mean this is fine.
+        LOGGER.load(std::memory_order_relaxed)->notify();
+    }
 
+    void asynchronouslyLog(
+        std::string                           message,
+        LoggingLevel                          level,
+        std::source_location                  location,
+        std::chrono::system_clock::time_point time)
+    {
         if (level >= LoggingLevel::Warn || level == LoggingLevel::Debug)
         {
             LOGGER.load(std::memory_order_relaxed)
-                ->sendBlocking(std::move(output));
+                ->sendBlocking(
+                    formatLogMessage(message, level, location, time));
         }
         else
         {
             // the previous memory fences mean this is fine.
-            LOGGER.load(std::memory_order_relaxed)->send(std::move(output));
+            LOGGER.load(std::memory_order_relaxed)
+                ->send(QueuedLogMessage {
+                    .message {std::move(message)},
+                    .level {level},
+                    .location {location},
+                    .time {time}});
         }
     }
 } // namespace util
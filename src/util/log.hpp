@@ -1,11 +1,20 @@
 #ifndef SRC_UTIL_LOG_HPP
 #define SRC_UTIL_LOG_HPP
 
+#include "flight_recorder.hpp"
 #include "misc.hpp"
+#include <array>
+#include <bit>
+#include <chrono>
 #include <concurrentqueue.h>
 #include <cstdint>
+#include <cstring>
 #include <fmt/core.h>
+#include <glm/fwd.hpp>
 #include <source_location>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
 
 namespace util
 {
@@ -26,15 +35,185 @@ namespace util
     void         setLoggingLevel(LoggingLevel);
     LoggingLevel getCurrentLevel();
 
+    // The maximum amount of time the logger's worker thread will hold on to a
+    // message while it waits to batch more messages into the same write
+    void                      setLoggingFlushLatency(std::chrono::microseconds);
+    std::chrono::microseconds getLoggingFlushLatency();
+
     void asynchronouslyLog(
         std::string                           message,
         LoggingLevel                          level,
         std::source_location                  location,
         std::chrono::system_clock::time_point time);
 
-// TODO: see if theres a way to move that fmt stuff to the other thread, take a
-// fmt string, validate it at compile time and then just memcpy the args over
-// and construct later
+    /// Limits how often a single call site of the `log*` structs will actually
+    /// log. Suppressed messages are counted and reported the next time that
+    /// call site is allowed to log, and once more on shutdown
+    struct LogRateLimit
+    {
+        // Only log one of every N calls
+        std::uint32_t every_nth      = 1;
+        // Maximum number of logged calls per second, 0 for unlimited
+        std::uint32_t max_per_second = 0;
+    };
+
+    void setDefaultLogRateLimit(LogRateLimit);
+    // Overrides the default for all call sites whose file name ends in
+    // `fileSuffix`, if `line` is 0 it applies to every line of that file
+    void setLogRateLimit(
+        std::string_view fileSuffix, std::uint32_t line, LogRateLimit);
+
+    // Returns false if this call site's rate limit means this call should be
+    // suppressed, otherwise sets `suppressedMessages` to the number of calls
+    // that were suppressed since this call site last logged
+    [[nodiscard]] bool admitLogFromCallSite(
+        const std::source_location&, std::uint64_t& suppressedMessages);
+
+    /// Every log call whose arguments are all `DeferrableLogArgument`s is
+    /// written into a per-thread ring buffer as one of these headers followed
+    /// by the raw bytes of its arguments. The logger's worker thread then does
+    /// all of the formatting. This is only done for the levels that are
+    /// already logged asynchronously (Trace and Log)
+    struct DeferredLogRecordHeader
+    {
+        Fn<std::string(std::string_view, const std::byte*)> format;
+        const char*                                         format_string;
+        std::size_t                                         format_size;
+        std::source_location                                location;
+        std::chrono::system_clock::time_point               time;
+        std::uint32_t                                       record_size;
+        LoggingLevel                                        level;
+    };
+    static_assert(std::is_trivially_copyable_v<DeferredLogRecordHeader>);
+
+    // Opts a type into deferred formatting. Only specialize this for types
+    // that hold all of their state by value, as the worker thread formats
+    // a bitwise copy of the argument long after the call has returned
+    template<class T>
+    struct IsDeferrableLogArgument : std::false_type
+    {};
+
+    template<glm::length_t L, class T, glm::qualifier Q>
+        requires std::is_arithmetic_v<T>
+    struct IsDeferrableLogArgument<glm::vec<L, T, Q>> : std::true_type
+    {};
+
+    // An allowlist rather than "trivially copyable", as spans, iterators,
+    // reference_wrappers and the like are trivially copyable too but
+    // refer to storage that may be gone by the time it's formatted
+    template<class T>
+    concept DeferrableLogArgument =
+        std::is_arithmetic_v<std::remove_cvref_t<T>>
+        || std::is_enum_v<std::remove_cvref_t<T>>
+        || (IsDeferrableLogArgument<std::remove_cvref_t<T>>::value
+            && std::is_trivially_copyable_v<std::remove_cvref_t<T>>);
+
+    // Reserves a record of at least `recordSize` bytes in this thread's
+    // deferred logging ring buffer, returns nullptr if it is full.
+    // Each successful reserve must be followed by a commit.
+    [[nodiscard]] std::byte* reserveDeferredLogRecord(std::size_t recordSize);
+    void                     commitDeferredLogRecord();
+
+    template<class... Ts>
+    std::string formatDeferredLogRecord(
+        std::string_view formatString, const std::byte* arguments)
+    {
+        std::size_t offset = 0;
+
+        auto readArgument = [&]<class T>(std::type_identity<T>) -> T
+        {
+            std::array<std::byte, sizeof(T)> raw; // NOLINT
+
+            std::memcpy(raw.data(), arguments + offset, sizeof(T)); // NOLINT
+            offset += sizeof(T);
+
+            return std::bit_cast<T>(raw);
+        };
+
+        // braced initialization guarantees left to right evaluation
+        const std::tuple<Ts...> decoded {
+            readArgument(std::type_identity<Ts> {})...};
+
+        return std::apply(
+            [&](const Ts&... args)
+            {
+                return fmt::vformat(
+                    formatString, fmt::make_format_args(args...));
+            },
+            decoded);
+    }
+
+    template<LoggingLevel Level, class... Ts>
+    void logMessage(
+        fmt::format_string<Ts...>   fmt,
+        const std::source_location& location,
+        Ts&&... args)
+    {
+        std::uint64_t suppressedMessages = 0;
+
+        if (!admitLogFromCallSite(location, suppressedMessages))
+        {
+            return;
+        }
+
+        if (suppressedMessages != 0) [[unlikely]]
+        {
+            asynchronouslyLog(
+                fmt::format(
+                    "Suppressed {} messages from this call site",
+                    suppressedMessages),
+                Level,
+                location,
+                std::chrono::system_clock::now());
+        }
+
+        if constexpr (
+            (Level == LoggingLevel::Trace || Level == LoggingLevel::Log)
+            && (DeferrableLogArgument<Ts> && ...))
+        {
+            constexpr std::size_t RecordSize =
+                (sizeof(DeferredLogRecordHeader) + ...
+                 + sizeof(std::remove_cvref_t<Ts>));
+
+            if (std::byte* record = reserveDeferredLogRecord(RecordSize))
+            {
+                const fmt::string_view formatString = fmt;
+
+                const DeferredLogRecordHeader header {
+                    .format {&formatDeferredLogRecord<
+                        std::remove_cvref_t<Ts>...>},
+                    .format_string {formatString.data()},
+                    .format_size {formatString.size()},
+                    .location {location},
+                    .time {std::chrono::system_clock::now()},
+                    .record_size {static_cast<std::uint32_t>(RecordSize)},
+                    .level {Level},
+                };
+
+                std::memcpy(record, &header, sizeof(DeferredLogRecordHeader));
+
+                std::size_t offset = sizeof(DeferredLogRecordHeader);
+
+                ((std::memcpy(
+                      record + offset, // NOLINT
+                      std::addressof(args),
+                      sizeof(std::remove_cvref_t<Ts>)),
+                  offset += sizeof(std::remove_cvref_t<Ts>)),
+                 ...);
+
+                commitDeferredLogRecord();
+
+                return;
+            }
+        }
+
+        asynchronouslyLog(
+            fmt::format(fmt, std::forward<Ts>(args)...),
+            Level,
+            location,
+            std::chrono::system_clock::now());
+    }
+
 #define MAKE_LOGGER(LEVEL) /* NOLINT */                                        \
     template<class... Ts>                                                      \
     struct log##LEVEL                                                          \
@@ -49,11 +228,8 @@ namespace util
             if (std::to_underlying(getCurrentLevel())                          \
                 <= std::to_underlying(LEVEL))                                  \
             {                                                                  \
-                asynchronouslyLog(                                             \
-                    fmt::format(fmt, std::forward<Ts>(args)...),               \
-                    LEVEL,                                                     \
-                    location,                                                  \
-                    std::chrono::system_clock::now());                         \
+                logMessage<LEVEL, Ts...>(                                      \
+                    fmt, location, std::forward<Ts>(args)...);                 \
             }                                                                  \
         }                                                                      \
     };                                                                         \
@@ -95,6 +271,7 @@ namespace util
                         location,                                              \
                         std::chrono::system_clock::now());                     \
                                                                                \
+                    util::dumpFlightRecorder();                                \
                     util::debugBreak();                                        \
                                                                                \
                     throw std::runtime_error {std::move(message)};             \
@@ -141,6 +318,7 @@ namespace util
                 location,
                 std::chrono::system_clock::now());
 
+            util::dumpFlightRecorder();
             util::debugBreak();
 
             throw std::runtime_error {message};
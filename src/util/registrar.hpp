@@ -2,108 +2,137 @@
 #define SRC_UTIL_REGISTRAR_HPP
 
 #include "concurrentqueue.h"
+#include "slot_map.hpp"
 #include "util/log.hpp"
-#include <atomic>
 #include <engine/settings.hpp>
 #include <new>
 #include <optional>
-#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace util
 {
     // think a flushable map, thats only occasionally accessed, not useful for
     // consistent concurrent random modification
     // but useful for delta changes between frames.
-    template<class Key, class Value>
-        requires std::copyable<Key> && std::copyable<Value>
+    //
+    // insert() and remove() may be called from any thread, everything else
+    // must only be called from the one thread that consumes this Registrar.
+    // Elements are stored in a SlotMap, their handles are given out as they
+    // are flushed in, so visit() costs nothing beyond the iteration itself
+    // and flush() costs scale with the number of changes
+    template<class Value>
+        requires std::copyable<Value>
     class Registrar
     {
+    public:
+        using Handle = typename SlotMap<Value>::Handle;
+
     public:
 
         Registrar()  = default;
         ~Registrar() = default;
 
-        void insert(std::pair<Key, Value> set) const
+        void insert(Value value) const
         {
-            if (!this->sets_to_add.enqueue(std::move(set)))
+            if (!this->values_to_add.enqueue(std::move(value)))
             {
                 throw std::bad_alloc {};
             }
         }
-        void remove(Key key) const
+        void remove(Handle handle) const
         {
-            if (!this->keys_to_remove.enqueue(std::move(key)))
+            if (!this->handles_to_remove.enqueue(handle))
             {
                 throw std::bad_alloc {};
             }
         }
 
-        std::vector<std::pair<Key, Value>> access()
+        // Applies every queued insertion and then every queued removal,
+        // reporting each one as it's applied
+        void flush(
+            std::invocable<Handle, const Value&> auto onAdded,
+            std::invocable<Handle, const Value&> auto onRemoved)
         {
             // Flush adds
             {
-                std::optional<std::pair<Key, Value>> dequeueKeyValue;
-                while (this->sets_to_add.try_dequeue(dequeueKeyValue))
+                std::optional<Value> dequeueValue;
+                while (this->values_to_add.try_dequeue(dequeueValue))
                 {
-                    auto& [key, value] = *dequeueKeyValue;
-
-                    if (engine::getSettings()
-                            .lookupSetting<
-                                engine::Setting::EnableAppValidation>())
-                    {
-                        util::assertFatal(
-                            !this->map.contains(key),
-                            "Key was already in Registrar!");
-                    }
-
-                    this->map.insert({std::move(key), std::move(value)});
+                    const Handle handle =
+                        this->elements.insert(std::move(*dequeueValue));
 
-                    this->map_size.fetch_add(1, std::memory_order_acq_rel);
+                    onAdded(handle, *this->elements.lookup(handle));
 
-                    dequeueKeyValue = std::nullopt;
+                    dequeueValue = std::nullopt;
                 }
             }
 
             // Flush removals
             {
-                std::optional<Key> dequeueKey;
-                while (this->keys_to_remove.try_dequeue(dequeueKey))
+                Handle dequeueHandle;
+                while (this->handles_to_remove.try_dequeue(dequeueHandle))
                 {
+                    std::optional<Value> maybeRemoved =
+                        this->elements.erase(dequeueHandle);
+
                     if (engine::getSettings()
                             .lookupSetting<
                                 engine::Setting::EnableAppValidation>())
                     {
                         util::assertFatal(
-                            this->map.contains(*dequeueKey),
-                            "Key was not present in Registrar");
+                            maybeRemoved.has_value(),
+                            "Handle was not present in Registrar");
                     }
 
-                    this->map.erase(*dequeueKey);
-
-                    this->map_size.fetch_sub(1, std::memory_order_acq_rel);
-
-                    dequeueKey = std::nullopt;
+                    if (maybeRemoved.has_value())
+                    {
+                        onRemoved(dequeueHandle, *maybeRemoved);
+                    }
                 }
             }
+        }
 
-            // Generate output
-            std::vector<std::pair<Key, Value>> output;
-            output.reserve(this->map_size.load(std::memory_order_acquire));
+        void flush()
+        {
+            this->flush(
+                [](Handle, const Value&) {}, [](Handle, const Value&) {});
+        }
 
-            for (auto& keyValue : this->map)
-            {
-                output.push_back(keyValue);
-            }
+        // Does not flush
+        void visit(std::invocable<Handle, const Value&> auto func) const
+        {
+            std::as_const(this->elements).visit(func);
+        }
+
+        [[nodiscard]] std::size_t size() const
+        {
+            return this->elements.size();
+        }
+
+        // Flushes and then copies every element out
+        std::vector<std::pair<Handle, Value>> access()
+        {
+            this->flush();
+
+            std::vector<std::pair<Handle, Value>> output {};
+            output.reserve(this->elements.size());
+
+            this->visit(
+                [&](Handle handle, const Value& value)
+                {
+                    output.push_back({handle, value});
+                });
 
             return output;
         }
+
     private:
 
-        mutable moodycamel::ConcurrentQueue<std::pair<Key, Value>> sets_to_add;
-        mutable moodycamel::ConcurrentQueue<Key> keys_to_remove;
+        mutable moodycamel::ConcurrentQueue<Value>  values_to_add;
+        mutable moodycamel::ConcurrentQueue<Handle> handles_to_remove;
 
-        std::atomic<std::size_t>       map_size = 0;
-        std::unordered_map<Key, Value> map;
+        SlotMap<Value> elements;
     };
 } // namespace util
 
@@ -0,0 +1,246 @@
+#ifndef SRC_UTIL_SLOT_MAP_HPP
+#define SRC_UTIL_SLOT_MAP_HPP
+
+#include <compare>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace util
+{
+    /// A handle into a SlotMap<T>.
+    /// The index is into the SlotMap's slots and the generation is the
+    /// version of that slot that this handle refers to. Once the element is
+    /// erased the slot's generation changes, so old handles can't alias
+    /// whatever is inserted into that slot next.
+    template<class T>
+    struct SlotHandle
+    {
+        std::uint32_t index      = std::numeric_limits<std::uint32_t>::max();
+        std::uint32_t generation = 0;
+
+        [[nodiscard]] bool isNull() const
+        {
+            return this->generation == 0;
+        }
+
+        [[nodiscard]] bool operator== (const SlotHandle&) const = default;
+        [[nodiscard]] std::strong_ordering
+        operator<=> (const SlotHandle&) const = default;
+    };
+
+    /// An unordered container that gives out handles rather than keys.
+    /// Lookup through a handle is two array indexes with no hashing, the
+    /// elements themselves are kept densely and iterating them is a linear
+    /// walk of a vector. Erasing an element moves the last element into the
+    /// hole, so element addresses and iteration order are not stable.
+    ///
+    /// Not thread safe.
+    template<class T>
+    class SlotMap
+    {
+    public:
+        using Handle = SlotHandle<T>;
+
+    public:
+
+        SlotMap()  = default;
+        ~SlotMap() = default;
+
+        SlotMap(const SlotMap&)             = default;
+        SlotMap(SlotMap&&)                  = default;
+        SlotMap& operator= (const SlotMap&) = default;
+        SlotMap& operator= (SlotMap&&)      = default;
+
+        Handle insert(T value)
+        {
+            std::uint32_t slotIndex = this->free_head;
+
+            if (slotIndex == NullIndex)
+            {
+                slotIndex = static_cast<std::uint32_t>(this->slots.size());
+
+                this->slots.push_back(Slot {
+                    .generation {0},
+                    .dense_index_or_next_free {NullIndex},
+                });
+            }
+
+            Slot& slot = this->slots[slotIndex];
+
+            this->free_head = slot.dense_index_or_next_free;
+
+            // Occupied slots always have an odd generation, so a
+            // generation of 0 is never valid
+            slot.generation += 1;
+            slot.dense_index_or_next_free =
+                static_cast<std::uint32_t>(this->values.size());
+
+            this->values.push_back(std::move(value));
+            this->dense_to_slot.push_back(slotIndex);
+
+            return Handle {.index {slotIndex}, .generation {slot.generation}};
+        }
+
+        // Returns the erased element if the handle was still valid
+        std::optional<T> erase(Handle handle)
+        {
+            if (!this->contains(handle))
+            {
+                return std::nullopt;
+            }
+
+            Slot&             slot       = this->slots[handle.index];
+            const std::size_t denseIndex = slot.dense_index_or_next_free;
+
+            std::optional<T> erased {std::move(this->values[denseIndex])};
+
+            // keep the values dense by moving the last value into the hole
+            if (denseIndex != this->values.size() - 1)
+            {
+                this->values[denseIndex] = std::move(this->values.back());
+                this->dense_to_slot[denseIndex] = this->dense_to_slot.back();
+
+                this->slots[this->dense_to_slot[denseIndex]]
+                    .dense_index_or_next_free =
+                    static_cast<std::uint32_t>(denseIndex);
+            }
+
+            this->values.pop_back();
+            this->dense_to_slot.pop_back();
+
+            slot.generation += 1;
+            slot.dense_index_or_next_free = this->free_head;
+            this->free_head               = handle.index;
+
+            return erased;
+        }
+
+        [[nodiscard]] bool contains(Handle handle) const
+        {
+            return handle.index < this->slots.size()
+                && this->slots[handle.index].generation == handle.generation
+                && (handle.generation & 1) == 1;
+        }
+
+        // Returns nullptr for stale or null handles
+        [[nodiscard]] T* lookup(Handle handle)
+        {
+            if (!this->contains(handle))
+            {
+                return nullptr;
+            }
+
+            return &this->values[this->slots[handle.index]
+                                     .dense_index_or_next_free];
+        }
+
+        [[nodiscard]] const T* lookup(Handle handle) const
+        {
+            if (!this->contains(handle))
+            {
+                return nullptr;
+            }
+
+            return &this->values[this->slots[handle.index]
+                                     .dense_index_or_next_free];
+        }
+
+        void visit(std::invocable<Handle, const T&> auto func) const
+        {
+            for (std::size_t i = 0; i < this->values.size(); ++i)
+            {
+                const std::uint32_t slotIndex = this->dense_to_slot[i];
+
+                func(
+                    Handle {
+                        .index {slotIndex},
+                        .generation {this->slots[slotIndex].generation}},
+                    this->values[i]);
+            }
+        }
+
+        void visit(std::invocable<Handle, T&> auto func)
+        {
+            for (std::size_t i = 0; i < this->values.size(); ++i)
+            {
+                const std::uint32_t slotIndex = this->dense_to_slot[i];
+
+                func(
+                    Handle {
+                        .index {slotIndex},
+                        .generation {this->slots[slotIndex].generation}},
+                    this->values[i]);
+            }
+        }
+
+        [[nodiscard]] std::size_t size() const
+        {
+            return this->values.size();
+        }
+
+        [[nodiscard]] bool isEmpty() const
+        {
+            return this->values.empty();
+        }
+
+        // The dense elements, in no particular order
+        [[nodiscard]] const std::vector<T>& getValues() const
+        {
+            return this->values;
+        }
+
+        // Invalidates every outstanding handle
+        void clear()
+        {
+            while (!this->values.empty())
+            {
+                const std::uint32_t slotIndex = this->dense_to_slot.back();
+
+                std::ignore = this->erase(Handle {
+                    .index {slotIndex},
+                    .generation {this->slots[slotIndex].generation}});
+            }
+        }
+
+    private:
+        static constexpr std::uint32_t NullIndex =
+            std::numeric_limits<std::uint32_t>::max();
+
+        struct Slot
+        {
+            // odd when occupied
+            std::uint32_t generation;
+            // the index into values when occupied, otherwise the next slot in
+            // the free list
+            std::uint32_t dense_index_or_next_free;
+        };
+
+        std::vector<T>             values;
+        std::vector<std::uint32_t> dense_to_slot;
+        std::vector<Slot>          slots;
+        std::uint32_t              free_head = NullIndex;
+    };
+} // namespace util
+
+namespace std
+{
+    template<class T>
+    struct hash<util::SlotHandle<T>>
+    {
+        std::size_t
+        operator() (const util::SlotHandle<T>& handle) const noexcept
+        {
+            return std::hash<std::uint64_t> {}(
+                (static_cast<std::uint64_t>(handle.generation) << 32)
+                | handle.index);
+        }
+    };
+} // namespace std
+
+#endif // SRC_UTIL_SLOT_MAP_HPP
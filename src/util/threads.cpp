@@ -0,0 +1,138 @@
+#include "threads.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string_view>
+#include <tuple>
+
+namespace util
+{
+    namespace
+    {
+        // file, line, column
+        using LockSite =
+            std::tuple<std::string_view, std::uint32_t, std::uint32_t>;
+
+        struct LockStatisticsRegistry
+        {
+            // Not a util::Mutex, constructing one of those needs this registry
+            std::mutex                                          mutex;
+            std::map<LockSite, std::unique_ptr<LockStatistics>> statistics;
+        };
+
+        // Locks may be constructed during static initialization, so this
+        // can't be a global
+        LockStatisticsRegistry& getLockStatisticsRegistry()
+        {
+            static LockStatisticsRegistry registry {};
+
+            return registry;
+        }
+
+#ifdef VERDIGRIS_INSTRUMENT_LOCKS
+        double toMilliseconds(std::uint64_t nanoseconds)
+        {
+            return static_cast<double>(nanoseconds) / 1'000'000.0;
+        }
+#endif
+    } // namespace
+
+    LockStatistics* getLockStatistics(const std::source_location& location)
+    {
+        LockStatisticsRegistry& registry = getLockStatisticsRegistry();
+
+        std::unique_lock lock {registry.mutex};
+
+        std::unique_ptr<LockStatistics>& statistics =
+            registry.statistics[LockSite {
+                location.file_name(), location.line(), location.column()}];
+
+        if (statistics == nullptr)
+        {
+            statistics = std::make_unique<LockStatistics>();
+
+            statistics->location = location;
+        }
+
+        return statistics.get();
+    }
+
+    void dumpLockStatistics()
+    {
+#ifdef VERDIGRIS_INSTRUMENT_LOCKS
+        struct LockReport
+        {
+            std::source_location location;
+            std::uint64_t        acquires;
+            std::uint64_t        contended_acquires;
+            std::uint64_t        total_wait_nanoseconds;
+            std::uint64_t        max_wait_nanoseconds;
+            std::uint64_t        total_hold_nanoseconds;
+            std::uint64_t        max_hold_nanoseconds;
+        };
+
+        std::vector<LockReport> reports {};
+
+        {
+            LockStatisticsRegistry& registry = getLockStatisticsRegistry();
+
+            std::unique_lock lock {registry.mutex};
+
+            constexpr std::memory_order Relaxed = std::memory_order_relaxed;
+
+            for (const auto& [site, s] : registry.statistics)
+            {
+                reports.push_back(LockReport {
+                    .location {s->location},
+                    .acquires {s->acquires.load(Relaxed)},
+                    .contended_acquires {s->contended_acquires.load(Relaxed)},
+                    .total_wait_nanoseconds {
+                        s->total_wait_nanoseconds.load(Relaxed)},
+                    .max_wait_nanoseconds {
+                        s->max_wait_nanoseconds.load(Relaxed)},
+                    .total_hold_nanoseconds {
+                        s->total_hold_nanoseconds.load(Relaxed)},
+                    .max_hold_nanoseconds {
+                        s->max_hold_nanoseconds.load(Relaxed)},
+                });
+            }
+        }
+
+        std::ranges::sort(
+            reports,
+            std::greater {},
+            [](const LockReport& r)
+            {
+                return r.total_wait_nanoseconds;
+            });
+
+        util::logLog(
+            "Lock statistics | {} construction sites", reports.size());
+
+        for (const LockReport& r : reports)
+        {
+            if (r.acquires == 0)
+            {
+                continue;
+            }
+
+            util::logLog(
+                "{}:{}:{} | acquires {} | contended {} ({:.2f}%) | wait "
+                "total {:.3f}ms max {:.3f}ms | hold total {:.3f}ms max "
+                "{:.3f}ms",
+                r.location.file_name(),
+                r.location.line(),
+                r.location.column(),
+                r.acquires,
+                r.contended_acquires,
+                100.0 * static_cast<double>(r.contended_acquires)
+                    / static_cast<double>(r.acquires),
+                toMilliseconds(r.total_wait_nanoseconds),
+                toMilliseconds(r.max_wait_nanoseconds),
+                toMilliseconds(r.total_hold_nanoseconds),
+                toMilliseconds(r.max_hold_nanoseconds));
+        }
+#endif
+    }
+} // namespace util
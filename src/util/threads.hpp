@@ -1,24 +1,185 @@
 #ifndef SRC_UTIL_THREADS_HPP
 #define SRC_UTIL_THREADS_HPP
 
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
 #include <future>
 #include <mutex>
 #include <optional>
 #include <shared_mutex>
+#include <source_location>
 #include <span>
+#include <type_traits>
 #include <vector>
 
 namespace util
 {
+    /// Contention statistics for every Mutex and RwLock constructed at one
+    /// source location. Only collected when building with
+    /// VERDIGRIS_INSTRUMENT_LOCKS, otherwise locking is untouched.
+    struct LockStatistics
+    {
+        std::source_location       location;
+        std::atomic<std::uint64_t> acquires;
+        std::atomic<std::uint64_t> contended_acquires;
+        std::atomic<std::uint64_t> total_wait_nanoseconds;
+        std::atomic<std::uint64_t> max_wait_nanoseconds;
+        std::atomic<std::uint64_t> total_hold_nanoseconds;
+        std::atomic<std::uint64_t> max_hold_nanoseconds;
+    };
+
+    // Returns the statistics shared by every lock constructed at `location`
+    [[nodiscard]] LockStatistics*
+    getLockStatistics(const std::source_location& location);
+
+    // Logs every lock's statistics, sorted by total wait time. Called on
+    // shutdown, but may be called at any time. Does nothing unless built
+    // with VERDIGRIS_INSTRUMENT_LOCKS
+    void dumpLockStatistics();
+
+    /// Acquires the given deferred lock, in instrumented builds the time
+    /// spent waiting for and holding it is recorded
+    template<class L>
+    class LockAcquisition
+    {
+    public:
+
+        LockAcquisition(
+            L& lock_, [[maybe_unused]] LockStatistics* statistics_)
+            : lock {lock_}
+#ifdef VERDIGRIS_INSTRUMENT_LOCKS
+            , statistics {statistics_}
+#endif
+        {
+#ifdef VERDIGRIS_INSTRUMENT_LOCKS
+            if (this->lock.try_lock())
+            {
+                this->acquired_at = std::chrono::steady_clock::now();
+            }
+            else
+            {
+                const std::chrono::steady_clock::time_point waitStart =
+                    std::chrono::steady_clock::now();
+
+                this->lock.lock();
+
+                this->acquired_at = std::chrono::steady_clock::now();
 
+                const auto waited = static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        this->acquired_at - waitStart)
+                        .count());
+
+                this->statistics->contended_acquires.fetch_add(
+                    1, std::memory_order_relaxed);
+                this->statistics->total_wait_nanoseconds.fetch_add(
+                    waited, std::memory_order_relaxed);
+                storeMaximum(this->statistics->max_wait_nanoseconds, waited);
+            }
+
+            this->statistics->acquires.fetch_add(1, std::memory_order_relaxed);
+#else
+            this->lock.lock();
+#endif
+        }
+
+        // Only acquires the lock if it isn't already held
+        LockAcquisition(
+            std::try_to_lock_t,
+            L&                               lock_,
+            [[maybe_unused]] LockStatistics* statistics_)
+            : lock {lock_}
+#ifdef VERDIGRIS_INSTRUMENT_LOCKS
+            , statistics {statistics_}
+#endif
+        {
+            if (this->lock.try_lock())
+            {
+#ifdef VERDIGRIS_INSTRUMENT_LOCKS
+                this->acquired_at = std::chrono::steady_clock::now();
+
+                this->statistics->acquires.fetch_add(
+                    1, std::memory_order_relaxed);
+#endif
+            }
+        }
+
+        ~LockAcquisition()
+        {
+#ifdef VERDIGRIS_INSTRUMENT_LOCKS
+            if (this->lock.owns_lock())
+            {
+                const auto held = static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - this->acquired_at)
+                        .count());
+
+                this->statistics->total_hold_nanoseconds.fetch_add(
+                    held, std::memory_order_relaxed);
+                storeMaximum(this->statistics->max_hold_nanoseconds, held);
+            }
+#endif
+        }
+
+        LockAcquisition(const LockAcquisition&)             = delete;
+        LockAcquisition(LockAcquisition&&)                  = delete;
+        LockAcquisition& operator= (const LockAcquisition&) = delete;
+        LockAcquisition& operator= (LockAcquisition&&)      = delete;
+
+        [[nodiscard]] bool isHeld() const
+        {
+            return this->lock.owns_lock();
+        }
+
+    private:
+#ifdef VERDIGRIS_INSTRUMENT_LOCKS
+        static void
+        storeMaximum(std::atomic<std::uint64_t>& maximum, std::uint64_t value)
+        {
+            std::uint64_t current = maximum.load(std::memory_order_relaxed);
+
+            while (current < value
+                   && !maximum.compare_exchange_weak(
+                       current, value, std::memory_order_relaxed))
+            {}
+        }
+#endif
+
+        L& lock;
+#ifdef VERDIGRIS_INSTRUMENT_LOCKS
+        LockStatistics*                       statistics;
+        std::chrono::steady_clock::time_point acquired_at;
+#endif
+    };
+
+    // Mutex and RwLock attribute their statistics to the location that
+    // constructed them. Locks constructed through a forwarding function,
+    // e.g. std::make_unique, must pass std::source_location::current()
+    // explicitly, otherwise they're all attributed to the standard library
     template<class... T>
     class Mutex
     {
     public:
 
-        explicit Mutex() = default;
-        explicit Mutex(T&&... t) // NOLINT
+        explicit Mutex(
+            [[maybe_unused]] const std::source_location& location =
+                std::source_location::current())
+#ifdef VERDIGRIS_INSTRUMENT_LOCKS
+            : statistics {getLockStatistics(location)}
+#endif
+        {}
+        explicit Mutex( // NOLINT
+            T&&... t,
+            [[maybe_unused]] const std::source_location& location =
+                std::source_location::current())
             : tuple {std::forward<T>(t)...}
+#ifdef VERDIGRIS_INSTRUMENT_LOCKS
+            , statistics {getLockStatistics(location)}
+#endif
         {}
         ~Mutex() = default;
 
@@ -30,7 +191,8 @@ namespace util
         decltype(auto) lock(std::invocable<T&...> auto func) const
             noexcept(noexcept(std::apply(func, this->tuple)))
         {
-            std::unique_lock lock {this->mutex};
+            std::unique_lock lock {this->mutex, std::defer_lock};
+            LockAcquisition  acquisition {lock, this->getStatistics()};
 
             return std::apply(func, this->tuple);
         }
@@ -43,8 +205,10 @@ namespace util
                       std::invoke_result_t<decltype(func), T&...>>)
         {
             std::unique_lock<std::mutex> lock {this->mutex, std::defer_lock};
+            LockAcquisition              acquisition {
+                std::try_to_lock, lock, this->getStatistics()};
 
-            if (lock.try_lock())
+            if (acquisition.isHeld())
             {
                 return std::optional {std::apply(
                     std::forward<decltype(func)>(func), this->tuple)};
@@ -61,8 +225,10 @@ namespace util
                 same_as<void, std::invoke_result_t<decltype(func), T&...>>
         {
             std::unique_lock<std::mutex> lock {this->mutex, std::defer_lock};
+            LockAcquisition              acquisition {
+                std::try_to_lock, lock, this->getStatistics()};
 
-            if (lock.try_lock())
+            if (acquisition.isHeld())
             {
                 std::apply(std::forward<decltype(func)>(func), this->tuple);
                 return true;
@@ -73,7 +239,7 @@ namespace util
             }
         }
 
-        std::tuple_element_t<0, std::tuple<T...>> copyInner() const
+        auto copyInner() const
             requires (sizeof...(T) == 1)
         {
             using V = std::tuple_element_t<0, std::tuple<T...>>;
@@ -90,8 +256,20 @@ namespace util
         }
 
     private:
+        [[nodiscard]] LockStatistics* getStatistics() const
+        {
+#ifdef VERDIGRIS_INSTRUMENT_LOCKS
+            return this->statistics;
+#else
+            return nullptr;
+#endif
+        }
+
         mutable std::mutex       mutex;
         mutable std::tuple<T...> tuple;
+#ifdef VERDIGRIS_INSTRUMENT_LOCKS
+        LockStatistics* statistics;
+#endif
     }; // class Mutex
 
     template<class... T>
@@ -99,8 +277,14 @@ namespace util
     {
     public:
 
-        explicit RwLock(T&&... t) // NOLINT
+        explicit RwLock( // NOLINT
+            T&&... t,
+            [[maybe_unused]] const std::source_location& location =
+                std::source_location::current())
             : tuple {std::forward<T>(t)...}
+#ifdef VERDIGRIS_INSTRUMENT_LOCKS
+            , statistics {getLockStatistics(location)}
+#endif
         {}
         ~RwLock() = default;
 
@@ -112,7 +296,8 @@ namespace util
         decltype(auto) writeLock(std::invocable<T&...> auto func) const
             noexcept(noexcept(std::apply(func, this->tuple)))
         {
-            std::unique_lock lock {this->rwlock};
+            std::unique_lock lock {this->rwlock, std::defer_lock};
+            LockAcquisition  acquisition {lock, this->getStatistics()};
 
             return std::apply(func, this->tuple);
         }
@@ -125,8 +310,10 @@ namespace util
                       std::invoke_result_t<decltype(func), T&...>>)
         {
             std::unique_lock lock {this->rwlock, std::defer_lock};
+            LockAcquisition  acquisition {
+                std::try_to_lock, lock, this->getStatistics()};
 
-            if (lock.try_lock())
+            if (acquisition.isHeld())
             {
                 return std::optional {std::apply(
                     std::forward<decltype(func)>(func), this->tuple)};
@@ -140,7 +327,8 @@ namespace util
         decltype(auto) readLock(std::invocable<const T&...> auto func) const
             noexcept(noexcept(std::apply(func, this->tuple)))
         {
-            std::shared_lock lock {this->rwlock};
+            std::shared_lock lock {this->rwlock, std::defer_lock};
+            LockAcquisition  acquisition {lock, this->getStatistics()};
 
             return std::apply(func, this->tuple);
         }
@@ -153,8 +341,10 @@ namespace util
                       std::invoke_result_t<decltype(func), T&...>>)
         {
             std::shared_lock lock {this->rwlock, std::defer_lock};
+            LockAcquisition  acquisition {
+                std::try_to_lock, lock, this->getStatistics()};
 
-            if (lock.try_lock())
+            if (acquisition.isHeld())
             {
                 return std::optional {std::apply(
                     std::forward<decltype(func)>(func), this->tuple)};
@@ -165,7 +355,7 @@ namespace util
             }
         }
 
-        std::tuple_element_t<0, std::tuple<T...>> copyInner() const
+        auto copyInner() const
             requires (sizeof...(T) == 1)
         {
             using V = std::tuple_element_t<0, std::tuple<T...>>;
@@ -182,10 +372,113 @@ namespace util
         }
 
     private:
+        [[nodiscard]] LockStatistics* getStatistics() const
+        {
+#ifdef VERDIGRIS_INSTRUMENT_LOCKS
+            return this->statistics;
+#else
+            return nullptr;
+#endif
+        }
+
         mutable std::shared_mutex rwlock;
         mutable std::tuple<T...>  tuple;
+#ifdef VERDIGRIS_INSTRUMENT_LOCKS
+        LockStatistics* statistics;
+#endif
     }; // class Mutex
 
+    /// A single writer, multiple reader cell for small trivially copyable
+    /// state, e.g. the game thread handing the camera to the render thread.
+    /// Readers never block the writer and never observe a torn value, a read
+    /// that overlaps a publish is simply retried.
+    template<class T>
+        requires std::is_trivially_copyable_v<T>
+    class SeqLock
+    {
+    public:
+
+        explicit SeqLock(const T& t)
+            : sequence {0}
+            , words {}
+        {
+            this->storeWords(t);
+        }
+        ~SeqLock() = default;
+
+        SeqLock(const SeqLock&)             = delete;
+        SeqLock(SeqLock&&)                  = delete;
+        SeqLock& operator= (const SeqLock&) = delete;
+        SeqLock& operator= (SeqLock&&)      = delete;
+
+        // Must not be called concurrently with another publish
+        void publish(const T& t) const noexcept
+        {
+            const std::uint64_t sequenceBefore =
+                this->sequence.load(std::memory_order_relaxed);
+
+            // odd while a write is in progress
+            this->sequence.store(sequenceBefore + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            this->storeWords(t);
+
+            this->sequence.store(sequenceBefore + 2, std::memory_order_release);
+        }
+
+        [[nodiscard]] T copyInner() const noexcept
+        {
+            std::array<std::uint64_t, Words> copy {};
+
+            while (true)
+            {
+                const std::uint64_t sequenceBefore =
+                    this->sequence.load(std::memory_order_acquire);
+
+                if ((sequenceBefore & 1) != 0)
+                {
+                    continue;
+                }
+
+                for (std::size_t i = 0; i < Words; ++i)
+                {
+                    copy[i] = this->words[i].load(std::memory_order_relaxed);
+                }
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+
+                if (this->sequence.load(std::memory_order_relaxed)
+                    == sequenceBefore)
+                {
+                    break;
+                }
+            }
+
+            std::array<std::byte, sizeof(T)> bytes {};
+            std::memcpy(bytes.data(), copy.data(), sizeof(T));
+
+            return std::bit_cast<T>(bytes);
+        }
+
+    private:
+        static constexpr std::size_t Words =
+            (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+        void storeWords(const T& t) const noexcept
+        {
+            std::array<std::uint64_t, Words> copy {};
+            std::memcpy(copy.data(), &t, sizeof(T));
+
+            for (std::size_t i = 0; i < Words; ++i)
+            {
+                this->words[i].store(copy[i], std::memory_order_relaxed);
+            }
+        }
+
+        alignas(64) mutable std::atomic<std::uint64_t> sequence;
+        mutable std::array<std::atomic<std::uint64_t>, Words> words;
+    }; // class SeqLock
+
     inline std::byte*
     threadedMemcpy(std::byte* dst, std::span<const std::byte> src)
     {